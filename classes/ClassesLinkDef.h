@@ -26,8 +26,10 @@
  */
 
 #include "classes/DelphesModule.h"
+#include "classes/DelphesArrayChain.h"
 #include "classes/DelphesFactory.h"
 
+#include "classes/DelphesLorentzVector.h"
 #include "classes/SortableObject.h"
 #include "classes/DelphesClasses.h"
 
@@ -38,8 +40,10 @@
 #pragma link off all functions;
 
 #pragma link C++ class DelphesModule+;
+#pragma link C++ class DelphesArrayChain+;
 #pragma link C++ class DelphesFactory+;
 
+#pragma link C++ class DelphesLorentzVector+;
 #pragma link C++ class SortableObject+;
 
 #pragma link C++ class Event+;
@@ -62,6 +66,11 @@
 #pragma link C++ class ParticleFlowCandidate+;
 #pragma link C++ class HectorHit+;
 
+#pragma link C++ class CandidateJetID+;
+#pragma link C++ class CandidateTiming+;
+#pragma link C++ class CandidateVertexing+;
+#pragma link C++ class CandidateSubstructure+;
+#pragma link C++ class CandidateConstituentIDs+;
 #pragma link C++ class Candidate+;
 
 #endif
@@ -0,0 +1,108 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** \class DelphesArrayChain
+ *
+ *  Exported array whose content is the concatenation of other arrays.
+ *
+ *  The chain is created with DelphesModule::ExportChain and read with
+ *  DelphesModule::ImportChain, which gives access to the concatenated
+ *  arrays without copying them. The exported array itself is only
+ *  needed, and filled by the producing module, when another module
+ *  imports it with DelphesModule::ImportArray.
+ *
+ */
+
+#include "classes/DelphesArrayChain.h"
+
+#include "TObjArray.h"
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+
+DelphesArrayChain::DelphesArrayChain(TObjArray *array) :
+  fArray(array), fFilled(kFALSE), fImported(kFALSE)
+{
+  if(fArray) SetName(fArray->GetName());
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesArrayChain::Add(const TObjArray *array)
+{
+  fSegments.push_back(array);
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesArrayChain::Add(const DelphesArrayChain *chain)
+{
+  fSegments.insert(fSegments.end(), chain->fSegments.begin(), chain->fSegments.end());
+}
+
+//------------------------------------------------------------------------------
+
+Int_t DelphesArrayChain::GetNumberOfSegments() const
+{
+  return fSegments.size();
+}
+
+//------------------------------------------------------------------------------
+
+const TObjArray *DelphesArrayChain::GetSegment(Int_t i) const
+{
+  return fSegments[i];
+}
+
+//------------------------------------------------------------------------------
+
+Int_t DelphesArrayChain::GetEntries() const
+{
+  Int_t entries = 0;
+  vector<const TObjArray *>::const_iterator itSegments;
+
+  for(itSegments = fSegments.begin(); itSegments != fSegments.end(); ++itSegments)
+  {
+    entries += (*itSegments)->GetEntriesFast();
+  }
+
+  return entries;
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesArrayChain::Fill()
+{
+  vector<const TObjArray *>::const_iterator itSegments;
+  Int_t i, size;
+
+  if(!fArray) return;
+
+  size = fArray->GetEntriesFast() + GetEntries();
+  if(size > fArray->GetSize()) fArray->Expand(size);
+
+  for(itSegments = fSegments.begin(); itSegments != fSegments.end(); ++itSegments)
+  {
+    size = (*itSegments)->GetEntriesFast();
+    for(i = 0; i < size; ++i)
+    {
+      fArray->Add((*itSegments)->UncheckedAt(i));
+    }
+  }
+}
@@ -0,0 +1,183 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DelphesArrayChain_h
+#define DelphesArrayChain_h
+
+/** \class DelphesArrayChain
+ *
+ *  Exported array whose content is the concatenation of other arrays.
+ *
+ *  The chain is created with DelphesModule::ExportChain and read with
+ *  DelphesModule::ImportChain, which gives access to the concatenated
+ *  arrays without copying them. The exported array itself is only
+ *  needed, and filled by the producing module, when another module
+ *  imports it with DelphesModule::ImportArray.
+ *
+ */
+
+#include "TNamed.h"
+
+#if !defined(__CINT__) && !defined(__CLING__)
+#include <cstddef>
+#include <iterator>
+#include <vector>
+#endif
+
+class TObjArray;
+
+class DelphesArrayChain: public TNamed
+{
+public:
+  DelphesArrayChain(TObjArray *array = 0);
+
+  TObjArray *GetArray() const { return fArray; }
+
+  // add an array, or all the arrays of another chain, at the end of the chain
+  void Add(const TObjArray *array);
+  void Add(const DelphesArrayChain *chain);
+
+  Int_t GetNumberOfSegments() const;
+  const TObjArray *GetSegment(Int_t i) const;
+
+  Int_t GetEntries() const;
+
+  // copy the concatenated arrays into the exported array
+  void Fill();
+
+  // a module imports the exported array and needs it to be filled
+  void SetFilled(Bool_t flag) { fFilled = flag; }
+  Bool_t IsFilled() const { return fFilled; }
+
+  // a module imports the exported array or the chain
+  void SetImported(Bool_t flag) { fImported = flag; }
+  Bool_t IsImported() const { return fImported || fFilled; }
+
+private:
+  TObjArray *fArray; //!
+
+  Bool_t fFilled; //!
+  Bool_t fImported; //!
+
+#if !defined(__CINT__) && !defined(__CLING__)
+  std::vector<const TObjArray *> fSegments; //!
+#endif
+
+  ClassDef(DelphesArrayChain, 1)
+};
+
+//---------------------------------------------------------------------------
+
+#if !defined(__CINT__) && !defined(__CLING__)
+
+#include "TObjArray.h"
+
+/** \class DelphesChainView
+ *
+ *  Typed view of the objects stored in all the arrays of a chain,
+ *  read in the order of the chain without virtual calls.
+ *
+ */
+
+template <typename T>
+class DelphesChainView
+{
+public:
+  class iterator
+  {
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef T *value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef T *const *pointer;
+    typedef T *reference;
+
+    iterator() :
+      fChain(0), fSegment(0), fObject(0), fEnd(0) {}
+
+    iterator(const DelphesArrayChain *chain, Int_t segment) :
+      fChain(chain), fSegment(segment), fObject(0), fEnd(0)
+    {
+      Load();
+    }
+
+    T *operator*() const { return static_cast<T *>(*fObject); }
+
+    iterator &operator++()
+    {
+      if(++fObject == fEnd)
+      {
+        ++fSegment;
+        Load();
+      }
+      return *this;
+    }
+
+    iterator operator++(int)
+    {
+      iterator it(*this);
+      ++(*this);
+      return it;
+    }
+
+    bool operator==(const iterator &it) const { return fSegment == it.fSegment && fObject == it.fObject; }
+    bool operator!=(const iterator &it) const { return !(*this == it); }
+
+  private:
+    // move to the first object of the next non-empty segment
+    void Load()
+    {
+      const TObjArray *array;
+      Int_t size = fChain ? fChain->GetNumberOfSegments() : 0;
+
+      for(; fSegment < size; ++fSegment)
+      {
+        array = fChain->GetSegment(fSegment);
+        if(array->GetEntriesFast() == 0) continue;
+        fObject = array->GetObjectRef();
+        fEnd = fObject + array->GetEntriesFast();
+        return;
+      }
+
+      fSegment = size;
+      fObject = 0;
+      fEnd = 0;
+    }
+
+    const DelphesArrayChain *fChain;
+    Int_t fSegment;
+    TObject *const *fObject;
+    TObject *const *fEnd;
+  };
+
+  DelphesChainView(const DelphesArrayChain *chain) :
+    fChain(chain) {}
+
+  Int_t size() const { return fChain ? fChain->GetEntries() : 0; }
+  bool empty() const { return begin() == end(); }
+
+  iterator begin() const { return iterator(fChain, 0); }
+  iterator end() const { return iterator(fChain, fChain ? fChain->GetNumberOfSegments() : 0); }
+
+private:
+  const DelphesArrayChain *fChain;
+};
+
+#endif
+
+#endif // DelphesArrayChain_h
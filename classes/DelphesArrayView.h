@@ -0,0 +1,124 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DelphesArrayView_h
+#define DelphesArrayView_h
+
+/** \class DelphesArrayView
+ *
+ *  Typed view of the objects stored in a TObjArray.
+ *
+ *  The view reads the array contents directly, without virtual calls,
+ *  and supports range-based for loops, random access and slicing.
+ *  It does not own the array and always reflects its current size,
+ *  so it can be built once from the array returned by
+ *  DelphesModule::ImportArray or DelphesModule::ExportArray.
+ *
+ *  Unlike TIter, the view does not skip empty slots: it is meant for
+ *  arrays that are only filled with Add, as all module arrays are.
+ *
+ */
+
+#include "TObjArray.h"
+
+#include <cstddef>
+#include <iterator>
+
+template <typename T>
+class DelphesArrayView
+{
+public:
+  class iterator
+  {
+  public:
+    typedef std::random_access_iterator_tag iterator_category;
+    typedef T *value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef T *const *pointer;
+    typedef T *reference;
+
+    iterator() : fObject(0) {}
+    explicit iterator(TObject *const *object) : fObject(object) {}
+
+    T *operator*() const { return static_cast<T *>(*fObject); }
+    T *operator[](difference_type n) const { return static_cast<T *>(fObject[n]); }
+
+    iterator &operator++() { ++fObject; return *this; }
+    iterator &operator--() { --fObject; return *this; }
+    iterator operator++(int) { iterator it(*this); ++fObject; return it; }
+    iterator operator--(int) { iterator it(*this); --fObject; return it; }
+
+    iterator &operator+=(difference_type n) { fObject += n; return *this; }
+    iterator &operator-=(difference_type n) { fObject -= n; return *this; }
+    iterator operator+(difference_type n) const { return iterator(fObject + n); }
+    iterator operator-(difference_type n) const { return iterator(fObject - n); }
+    difference_type operator-(const iterator &it) const { return fObject - it.fObject; }
+
+    bool operator==(const iterator &it) const { return fObject == it.fObject; }
+    bool operator!=(const iterator &it) const { return fObject != it.fObject; }
+    bool operator<(const iterator &it) const { return fObject < it.fObject; }
+    bool operator>(const iterator &it) const { return fObject > it.fObject; }
+    bool operator<=(const iterator &it) const { return fObject <= it.fObject; }
+    bool operator>=(const iterator &it) const { return fObject >= it.fObject; }
+
+  private:
+    TObject *const *fObject;
+  };
+
+  DelphesArrayView() :
+    fArray(0), fFirst(0), fCount(-1) {}
+
+  DelphesArrayView(const TObjArray *array, Int_t first = 0, Int_t count = -1) :
+    fArray(array), fFirst(first), fCount(count) {}
+
+  const TObjArray *GetArray() const { return fArray; }
+
+  Int_t size() const
+  {
+    if(!fArray) return 0;
+    Int_t entries = fArray->GetEntriesFast() - fFirst;
+    if(entries < 0) entries = 0;
+    return (fCount < 0 || fCount > entries) ? entries : fCount;
+  }
+
+  bool empty() const { return size() == 0; }
+
+  iterator begin() const { return iterator(fArray ? fArray->GetObjectRef() + fFirst : 0); }
+  iterator end() const { return begin() + size(); }
+
+  T *operator[](Int_t i) const { return static_cast<T *>(fArray->UncheckedAt(fFirst + i)); }
+
+  T *front() const { return (*this)[0]; }
+  T *back() const { return (*this)[size() - 1]; }
+
+  // view of count objects starting at first, or of all the following ones if count is negative
+  DelphesArrayView Slice(Int_t first, Int_t count = -1) const
+  {
+    Int_t entries = size();
+    if(first > entries) first = entries;
+    if(count < 0 || count > entries - first) count = entries - first;
+    return DelphesArrayView(fArray, fFirst + first, count);
+  }
+
+private:
+  const TObjArray *fArray;
+  Int_t fFirst;
+  Int_t fCount;
+};
+
+#endif // DelphesArrayView_h
@@ -0,0 +1,247 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** \class DelphesCheckpoint
+ *
+ *  Periodic checkpoints of a reader, used to resume a job that was killed.
+ *
+ *  A checkpoint saves the output tree, so that the output file can be
+ *  recovered with all the events written so far, and records the position
+ *  of the next event in the input, the event counters and the random seed.
+ *  A resumed job writes the following events to a new segment of the
+ *  output file and the segments are merged at the end of the job.
+ *
+ */
+
+#include "classes/DelphesCheckpoint.h"
+
+#include "ExRootAnalysis/ExRootTreeWriter.h"
+
+#include "TFile.h"
+#include "TFileMerger.h"
+#include "TSystem.h"
+#include "TTree.h"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include <stdio.h>
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+
+DelphesCheckpoint::DelphesCheckpoint(const char *outputFileName) :
+  fOutputFileName(outputFileName), fSegment(0), fEntries(0),
+  fInput(0), fOffset(0), fEventCounter(0), fEventNumber(0), fRandomSeed(0)
+{
+  fRecordFileName = fOutputFileName + ".checkpoint";
+  fPendingFileName = fRecordFileName + ".tmp";
+}
+
+//------------------------------------------------------------------------------
+
+Bool_t DelphesCheckpoint::Read()
+{
+  // A pending record is written before the tree is saved and renamed
+  // once it is saved: it is only valid if the segment holds its entries.
+
+  if(ReadRecord(fPendingFileName) && GetSegmentEntries(fSegment) == fEntries)
+  {
+    if(rename(fPendingFileName, fRecordFileName) != 0)
+    {
+      stringstream message;
+      message << "can't rename " << fPendingFileName << endl;
+      throw runtime_error(message.str());
+    }
+  }
+  else
+  {
+    gSystem->Unlink(fPendingFileName);
+    if(!ReadRecord(fRecordFileName))
+    {
+      fSegment = 0;
+      fEntries = 0;
+      fInput = 0;
+      fOffset = 0;
+      fEventCounter = 0;
+      fEventNumber = 0;
+      fRandomSeed = 0;
+      return kFALSE;
+    }
+  }
+
+  // the events following the checkpoint go to a new segment
+  ++fSegment;
+  fEntries = 0;
+
+  cout << "** Resuming from event " << fEventNumber;
+  cout << ", writing " << GetSegmentFileName() << endl;
+
+  return kTRUE;
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesCheckpoint::Save(ExRootTreeWriter *treeWriter)
+{
+  stringstream message;
+
+  fEntries = treeWriter->GetEntries();
+
+  WriteRecord(fPendingFileName);
+
+  treeWriter->Checkpoint();
+
+  if(rename(fPendingFileName, fRecordFileName) != 0)
+  {
+    message << "can't rename " << fPendingFileName << endl;
+    throw runtime_error(message.str());
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesCheckpoint::Finish()
+{
+  stringstream message;
+  TString mergedFileName;
+  Int_t segment;
+
+  if(fSegment > 0)
+  {
+    cout << "** Merging " << fSegment + 1 << " segments into " << fOutputFileName << endl;
+
+    mergedFileName = fOutputFileName + ".merged";
+
+    TFileMerger merger(kFALSE);
+    merger.SetPrintLevel(0);
+    merger.OutputFile(mergedFileName, "RECREATE");
+    for(segment = 0; segment <= fSegment; ++segment)
+    {
+      merger.AddFile(GetSegmentFileName(segment), kFALSE);
+    }
+
+    if(!merger.Merge())
+    {
+      message << "can't merge the segments of " << fOutputFileName << endl;
+      throw runtime_error(message.str());
+    }
+
+    for(segment = 1; segment <= fSegment; ++segment)
+    {
+      gSystem->Unlink(GetSegmentFileName(segment));
+    }
+
+    if(rename(mergedFileName, fOutputFileName) != 0)
+    {
+      message << "can't rename " << mergedFileName << endl;
+      throw runtime_error(message.str());
+    }
+  }
+
+  gSystem->Unlink(fRecordFileName);
+  gSystem->Unlink(fPendingFileName);
+}
+
+//------------------------------------------------------------------------------
+
+TString DelphesCheckpoint::GetSegmentFileName(Int_t segment) const
+{
+  if(segment == 0) return fOutputFileName;
+  return Form("%s.resume%d", fOutputFileName.Data(), segment);
+}
+
+//------------------------------------------------------------------------------
+
+Long64_t DelphesCheckpoint::GetSegmentEntries(Int_t segment) const
+{
+  Long64_t entries = -1;
+  TFile *file;
+  TTree *tree;
+
+  // a file that was not closed is recovered up to the last saved tree
+  file = TFile::Open(GetSegmentFileName(segment));
+  if(!file) return entries;
+
+  tree = static_cast<TTree *>(file->Get("Delphes"));
+  if(tree) entries = tree->GetEntries();
+
+  delete file;
+
+  return entries;
+}
+
+//------------------------------------------------------------------------------
+
+Bool_t DelphesCheckpoint::ReadRecord(const char *fileName)
+{
+  ifstream inputFileStream(fileName);
+  string key;
+
+  if(!inputFileStream.is_open()) return kFALSE;
+
+  while(inputFileStream >> key)
+  {
+    if(key == "segment")
+      inputFileStream >> fSegment;
+    else if(key == "entries")
+      inputFileStream >> fEntries;
+    else if(key == "input")
+      inputFileStream >> fInput;
+    else if(key == "offset")
+      inputFileStream >> fOffset;
+    else if(key == "counter")
+      inputFileStream >> fEventCounter;
+    else if(key == "event")
+      inputFileStream >> fEventNumber;
+    else if(key == "seed")
+      inputFileStream >> fRandomSeed;
+  }
+
+  return !inputFileStream.bad();
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesCheckpoint::WriteRecord(const char *fileName)
+{
+  stringstream message;
+  ofstream outputFileStream(fileName, ios::out | ios::trunc);
+
+  outputFileStream << "segment " << fSegment << endl;
+  outputFileStream << "entries " << fEntries << endl;
+  outputFileStream << "input " << fInput << endl;
+  outputFileStream << "offset " << fOffset << endl;
+  outputFileStream << "counter " << fEventCounter << endl;
+  outputFileStream << "event " << fEventNumber << endl;
+  outputFileStream << "seed " << fRandomSeed << endl;
+
+  outputFileStream.close();
+
+  if(!outputFileStream)
+  {
+    message << "can't write checkpoint " << fileName << endl;
+    throw runtime_error(message.str());
+  }
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,96 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DelphesCheckpoint_h
+#define DelphesCheckpoint_h
+
+/** \class DelphesCheckpoint
+ *
+ *  Periodic checkpoints of a reader, used to resume a job that was killed.
+ *
+ *  A checkpoint saves the output tree, so that the output file can be
+ *  recovered with all the events written so far, and records the position
+ *  of the next event in the input, the event counters and the random seed.
+ *  A resumed job writes the following events to a new segment of the
+ *  output file and the segments are merged at the end of the job.
+ *
+ */
+
+#include "Rtypes.h"
+#include "TString.h"
+
+class ExRootTreeWriter;
+
+class DelphesCheckpoint
+{
+public:
+  DelphesCheckpoint(const char *outputFileName);
+
+  // read the last checkpoint of a previous job, returns false without checkpoint
+  Bool_t Read();
+
+  // output file written by this job, the output file itself or a new segment
+  TString GetSegmentFileName() const { return GetSegmentFileName(fSegment); }
+
+  void SetInput(Int_t input, Long64_t offset)
+  {
+    fInput = input;
+    fOffset = offset;
+  }
+
+  Int_t GetInput() const { return fInput; }
+  Long64_t GetOffset() const { return fOffset; }
+
+  void SetEventCounter(Long64_t counter) { fEventCounter = counter; }
+  Long64_t GetEventCounter() const { return fEventCounter; }
+
+  void SetEventNumber(Long64_t number) { fEventNumber = number; }
+  Long64_t GetEventNumber() const { return fEventNumber; }
+
+  void SetRandomSeed(UInt_t seed) { fRandomSeed = seed; }
+  UInt_t GetRandomSeed() const { return fRandomSeed; }
+
+  // save the output tree and record the current position
+  void Save(ExRootTreeWriter *treeWriter);
+
+  // once the output segment is closed, merge all the segments
+  // into the output file and remove the checkpoint records
+  void Finish();
+
+private:
+  TString GetSegmentFileName(Int_t segment) const;
+  Long64_t GetSegmentEntries(Int_t segment) const;
+
+  Bool_t ReadRecord(const char *fileName);
+  void WriteRecord(const char *fileName);
+
+  TString fOutputFileName;
+  TString fRecordFileName;
+  TString fPendingFileName;
+
+  Int_t fSegment;
+  Long64_t fEntries;
+
+  Int_t fInput;
+  Long64_t fOffset;
+  Long64_t fEventCounter;
+  Long64_t fEventNumber;
+  UInt_t fRandomSeed;
+};
+
+#endif /* DelphesCheckpoint_h */
@@ -31,6 +31,11 @@
 #include "classes/DelphesFactory.h"
 #include "classes/SortableObject.h"
 
+#include <algorithm>
+#include <thread>
+
+using namespace std;
+
 CompBase *GenParticle::fgCompare = 0;
 CompBase *Photon::fgCompare = CompPT<Photon>::Instance();
 CompBase *Electron::fgCompare = CompPT<Electron>::Instance();
@@ -43,6 +48,11 @@ CompBase *HectorHit::fgCompare = CompE<HectorHit>::Instance();
 CompBase *Vertex::fgCompare = CompSumPT2<Vertex>::Instance();
 CompBase *Candidate::fgCompare = CompMomentumPt<Candidate>::Instance();
 
+static const CandidateJetID gDefaultJetID;
+static const CandidateTiming gDefaultTiming;
+static const CandidateVertexing gDefaultVertexing;
+static const CandidateSubstructure gDefaultSubstructure;
+
 //------------------------------------------------------------------------------
 
 TLorentzVector GenParticle::P4() const
@@ -126,6 +136,133 @@ TLorentzVector ParticleFlowCandidate::P4() const
 
 //------------------------------------------------------------------------------
 
+CandidateJetID::CandidateJetID() :
+  NCharged(0), NNeutrals(0),
+  Beta(0.0), BetaStar(0.0),
+  MeanSqDeltaR(0.0), PTD(0.0),
+  NeutralEnergyFraction(0.0), ChargedEnergyFraction(0.0)
+{
+  FracPt[0] = 0.0;
+  FracPt[1] = 0.0;
+  FracPt[2] = 0.0;
+  FracPt[3] = 0.0;
+  FracPt[4] = 0.0;
+}
+
+//------------------------------------------------------------------------------
+
+void CandidateJetID::Clear(Option_t *option)
+{
+  NCharged = 0;
+  NNeutrals = 0;
+  Beta = 0.0;
+  BetaStar = 0.0;
+  MeanSqDeltaR = 0.0;
+  PTD = 0.0;
+  FracPt[0] = 0.0;
+  FracPt[1] = 0.0;
+  FracPt[2] = 0.0;
+  FracPt[3] = 0.0;
+  FracPt[4] = 0.0;
+  NeutralEnergyFraction = 0.0;
+  ChargedEnergyFraction = 0.0;
+}
+
+//------------------------------------------------------------------------------
+
+CandidateTiming::CandidateTiming() :
+  NTimeHits(0)
+{
+}
+
+//------------------------------------------------------------------------------
+
+void CandidateTiming::Clear(Option_t *option)
+{
+  NTimeHits = 0;
+  ECalEnergyTimePairs.clear();
+}
+
+//------------------------------------------------------------------------------
+
+CandidateVertexing::CandidateVertexing() :
+  ClusterNDF(-99), ClusterSigma(0.0),
+  SumPT2(0.0), BTVSumPT2(0.0),
+  GenDeltaZ(0.0), GenSumPT2(0.0)
+{
+}
+
+//------------------------------------------------------------------------------
+
+void CandidateVertexing::Clear(Option_t *option)
+{
+  ClusterNDF = -99;
+  ClusterSigma = 0.0;
+  SumPT2 = 0.0;
+  BTVSumPT2 = 0.0;
+  GenDeltaZ = 0.0;
+  GenSumPT2 = 0.0;
+}
+
+//------------------------------------------------------------------------------
+
+CandidateSubstructure::CandidateSubstructure() :
+  NSubJetsTrimmed(0), NSubJetsPruned(0), NSubJetsSoftDropped(0),
+  ExclYmerge23(0.0), ExclYmerge34(0.0), ExclYmerge45(0.0), ExclYmerge56(0.0)
+{
+  int i;
+  for(i = 0; i < 5; ++i)
+  {
+    Tau[i] = 0.0;
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void CandidateSubstructure::Clear(Option_t *option)
+{
+  int i;
+
+  for(i = 0; i < 5; ++i)
+  {
+    Tau[i] = 0.0;
+    TrimmedP4[i].SetXYZT(0.0, 0.0, 0.0, 0.0);
+    PrunedP4[i].SetXYZT(0.0, 0.0, 0.0, 0.0);
+    SoftDroppedP4[i].SetXYZT(0.0, 0.0, 0.0, 0.0);
+  }
+
+  SoftDroppedJet.SetXYZT(0.0, 0.0, 0.0, 0.0);
+  SoftDroppedSubJet1.SetXYZT(0.0, 0.0, 0.0, 0.0);
+  SoftDroppedSubJet2.SetXYZT(0.0, 0.0, 0.0, 0.0);
+
+  NSubJetsTrimmed = 0;
+  NSubJetsPruned = 0;
+  NSubJetsSoftDropped = 0;
+
+  ExclYmerge23 = 0.0;
+  ExclYmerge34 = 0.0;
+  ExclYmerge45 = 0.0;
+  ExclYmerge56 = 0.0;
+}
+
+//------------------------------------------------------------------------------
+
+CandidateConstituentIDs::CandidateConstituentIDs() :
+  State(0)
+{
+}
+
+//------------------------------------------------------------------------------
+
+void CandidateConstituentIDs::Clear(Option_t *option)
+{
+  // the memory of the identities is kept for the next use of the payload
+  IDs.clear();
+  State = 0;
+}
+
+//------------------------------------------------------------------------------
+
 Candidate::Candidate() :
   PID(0), Status(0), M1(-1), M2(-1), D1(-1), D2(-1),
   Charge(0), Mass(0.0),
@@ -148,105 +285,270 @@ Candidate::Candidate() :
   Phi(0), ErrorPhi(0),
   Xd(0), Yd(0), Zd(0),
   TrackResolution(0),
-  NCharged(0),
-  NNeutrals(0),
-  NeutralEnergyFraction(0),  // charged energy fraction
-  ChargedEnergyFraction(0),  // neutral energy fraction 
-  Beta(0),
-  BetaStar(0),
-  MeanSqDeltaR(0),
-  PTD(0),
-  NTimeHits(-1),
   IsolationVar(-999),
   IsolationVarRhoCorr(-999),
   SumPtCharged(-999),
   SumPtNeutral(-999),
   SumPtChargedPU(-999),
   SumPt(-999),
-  ClusterIndex(-1), ClusterNDF(0), ClusterSigma(0), SumPT2(0), BTVSumPT2(0), GenDeltaZ(0), GenSumPT2(0),
-  NSubJetsTrimmed(0),
-  NSubJetsPruned(0),
-  NSubJetsSoftDropped(0),
+  ClusterIndex(-1),
   puppiW(1),
-  ExclYmerge23(0),
-  ExclYmerge34(0),
-  ExclYmerge45(0),
-  ExclYmerge56(0),
   ParticleDensity(0),
   fFactory(0),
-  fArray(0)
+  fArray(0),
+  fCandidateID(0),
+  fJetID(0),
+  fTiming(0),
+  fVertexing(0),
+  fSubstructure(0),
+  fShared(0),
+  fConstituentIDs(0)
 {
-  int i;
   Edges[0] = 0.0;
   Edges[1] = 0.0;
   Edges[2] = 0.0;
   Edges[3] = 0.0;
-  FracPt[0] = 0.0;
-  FracPt[1] = 0.0;
-  FracPt[2] = 0.0;
-  FracPt[3] = 0.0;
-  FracPt[4] = 0.0;
-  Tau[0] = 0.0;
-  Tau[1] = 0.0;
-  Tau[2] = 0.0;
-  Tau[3] = 0.0;
-  Tau[4] = 0.0;
-
-  SoftDroppedJet.SetXYZT(0.0, 0.0, 0.0, 0.0);
-  SoftDroppedSubJet1.SetXYZT(0.0, 0.0, 0.0, 0.0);
-  SoftDroppedSubJet2.SetXYZT(0.0, 0.0, 0.0, 0.0);
-
-  for(i = 0; i < 5; ++i)
-  {
-    TrimmedP4[i].SetXYZT(0.0, 0.0, 0.0, 0.0);
-    PrunedP4[i].SetXYZT(0.0, 0.0, 0.0, 0.0);
-    SoftDroppedP4[i].SetXYZT(0.0, 0.0, 0.0, 0.0);
-  }
 }
 
 //------------------------------------------------------------------------------
 
 void Candidate::AddCandidate(Candidate *object)
 {
-  if(!fArray) fArray = fFactory->NewArray();
+  TObjArray *array;
+  Int_t i, size;
+
+  if(!fArray)
+  {
+    fArray = fFactory->NewArray();
+  }
+  else if(fShared & kSharedArray)
+  {
+    size = fArray->GetEntriesFast();
+    array = fFactory->NewArray();
+    array->Expand(size + 1);
+    for(i = 0; i < size; ++i)
+    {
+      array->Add(fArray->UncheckedAt(i));
+    }
+    fArray = array;
+    __atomic_and_fetch(&fShared, ~UInt_t(kSharedArray), __ATOMIC_RELAXED);
+  }
+
   fArray->Add(object);
+
+  if(fConstituentIDs) fConstituentIDs->State = 0;
 }
 
 //------------------------------------------------------------------------------
 
 TObjArray *Candidate::GetCandidates()
 {
-  if(!fArray) fArray = fFactory->NewArray();
+  TObjArray *array;
+  if(!fArray)
+  {
+    // modules running concurrently can read the same candidate,
+    // the array of the thread that loses the race is simply unused
+    array = fFactory->NewArray();
+    __sync_bool_compare_and_swap(&fArray, static_cast<TObjArray *>(0), array);
+  }
   return fArray;
 }
 
 //------------------------------------------------------------------------------
 
+// payload allocated on first write and copied on first write after being shared
+
+template <typename T>
+static T *WritablePayload(DelphesFactory *factory, T *&payload, UInt_t &shared, UInt_t flag)
+{
+  T *object;
+
+  if(!payload)
+  {
+    payload = factory->New<T>();
+  }
+  else if(shared & flag)
+  {
+    object = factory->New<T>();
+    *object = *payload;
+    payload = object;
+    __atomic_and_fetch(&shared, ~flag, __ATOMIC_RELAXED);
+  }
+
+  return payload;
+}
+
+//------------------------------------------------------------------------------
+
+const CandidateJetID *Candidate::GetJetID() const
+{
+  return fJetID ? fJetID : &gDefaultJetID;
+}
+
+//------------------------------------------------------------------------------
+
+const CandidateTiming *Candidate::GetTiming() const
+{
+  return fTiming ? fTiming : &gDefaultTiming;
+}
+
+//------------------------------------------------------------------------------
+
+const CandidateVertexing *Candidate::GetVertexing() const
+{
+  return fVertexing ? fVertexing : &gDefaultVertexing;
+}
+
+//------------------------------------------------------------------------------
+
+const CandidateSubstructure *Candidate::GetSubstructure() const
+{
+  return fSubstructure ? fSubstructure : &gDefaultSubstructure;
+}
+
+//------------------------------------------------------------------------------
+
+CandidateJetID *Candidate::JetID()
+{
+  return WritablePayload(fFactory, fJetID, fShared, kSharedJetID);
+}
+
+//------------------------------------------------------------------------------
+
+CandidateTiming *Candidate::Timing()
+{
+  return WritablePayload(fFactory, fTiming, fShared, kSharedTiming);
+}
+
+//------------------------------------------------------------------------------
+
+CandidateVertexing *Candidate::Vertexing()
+{
+  return WritablePayload(fFactory, fVertexing, fShared, kSharedVertexing);
+}
+
+//------------------------------------------------------------------------------
+
+CandidateSubstructure *Candidate::Substructure()
+{
+  return WritablePayload(fFactory, fSubstructure, fShared, kSharedSubstructure);
+}
+
+//------------------------------------------------------------------------------
+
 Bool_t Candidate::Overlaps(const Candidate *object) const
 {
+  vector<ULong64_t>::const_iterator itFirst, itFirstEnd, itSecond, itSecondEnd;
+
+  if(object->fCandidateID == fCandidateID) return kTRUE;
+
+  if(!fArray && !object->fArray) return kFALSE;
+
+  // the identities of a candidate without constituents are not built
+  if(!object->fArray)
+  {
+    const vector<ULong64_t> &ids = GetConstituentIDs();
+    return binary_search(ids.begin(), ids.end(), object->fCandidateID);
+  }
+
+  if(!fArray)
+  {
+    const vector<ULong64_t> &ids = object->GetConstituentIDs();
+    return binary_search(ids.begin(), ids.end(), fCandidateID);
+  }
+
+  // two sorted sets of identities have a common element
+  const vector<ULong64_t> &first = GetConstituentIDs();
+  const vector<ULong64_t> &second = object->GetConstituentIDs();
+
+  if(first.front() > second.back() || second.front() > first.back()) return kFALSE;
+
+  itFirst = first.begin();
+  itFirstEnd = first.end();
+  itSecond = second.begin();
+  itSecondEnd = second.end();
+
+  while(itFirst != itFirstEnd && itSecond != itSecondEnd)
+  {
+    if(*itFirst < *itSecond)
+    {
+      ++itFirst;
+    }
+    else if(*itSecond < *itFirst)
+    {
+      ++itSecond;
+    }
+    else
+    {
+      return kTRUE;
+    }
+  }
+
+  return kFALSE;
+}
+
+//------------------------------------------------------------------------------
+
+const vector<ULong64_t> &Candidate::GetConstituentIDs() const
+{
+  vector<const Candidate *> stack;
   const Candidate *candidate;
+  CandidateConstituentIDs *payload;
+  TObject *const *object;
+  Int_t i, size;
+  UInt_t state = 0;
+
+  // modules running concurrently can read the same candidate,
+  // the payload of the thread that loses the race is simply unused
+  payload = __atomic_load_n(&fConstituentIDs, __ATOMIC_ACQUIRE);
+  if(!payload)
+  {
+    payload = fFactory->New<CandidateConstituentIDs>();
+    if(!__sync_bool_compare_and_swap(&fConstituentIDs, static_cast<CandidateConstituentIDs *>(0), payload))
+    {
+      payload = __atomic_load_n(&fConstituentIDs, __ATOMIC_ACQUIRE);
+    }
+  }
 
-  if(object->GetUniqueID() == GetUniqueID()) return kTRUE;
+  vector<ULong64_t> &ids = payload->IDs;
 
-  if(fArray)
+  // the threads that lose the race wait for the identities to be ready
+  if(!__atomic_compare_exchange_n(&payload->State, &state, UInt_t(kConstituentIDsBuilding), false, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE))
   {
-    TIter it(fArray);
-    while((candidate = static_cast<Candidate *>(it.Next())))
+    while(state != kConstituentIDsReady)
     {
-      if(candidate->Overlaps(object)) return kTRUE;
+      this_thread::yield();
+      state = __atomic_load_n(&payload->State, __ATOMIC_ACQUIRE);
     }
+    return ids;
   }
 
-  if(object->fArray)
+  ids.clear();
+
+  stack.push_back(this);
+  while(!stack.empty())
   {
-    TIter it(object->fArray);
-    while((candidate = static_cast<Candidate *>(it.Next())))
+    candidate = stack.back();
+    stack.pop_back();
+
+    ids.push_back(candidate->fCandidateID);
+
+    if(!candidate->fArray) continue;
+
+    object = candidate->fArray->GetObjectRef();
+    size = candidate->fArray->GetEntriesFast();
+    for(i = 0; i < size; ++i)
     {
-      if(candidate->Overlaps(this)) return kTRUE;
+      if(object[i]) stack.push_back(static_cast<const Candidate *>(object[i]));
     }
   }
 
-  return kFALSE;
+  sort(ids.begin(), ids.end());
+  ids.erase(unique(ids.begin(), ids.end()), ids.end());
+
+  __atomic_store_n(&payload->State, UInt_t(kConstituentIDsReady), __ATOMIC_RELEASE);
+
+  return ids;
 }
 
 //------------------------------------------------------------------------------
@@ -263,7 +565,7 @@ TObject *Candidate::Clone(const char *newname) const
 void Candidate::Copy(TObject &obj) const
 {
   Candidate &object = static_cast<Candidate &>(obj);
-  Candidate *candidate;
+  UInt_t shared;
 
   object.PID = PID;
   object.Status = Status;
@@ -278,12 +580,6 @@ void Candidate::Copy(TObject &obj) const
   object.IsConstituent = IsConstituent;
   object.IsFromConversion = IsFromConversion;
   object.ClusterIndex = ClusterIndex;
-  object.ClusterNDF = ClusterNDF;
-  object.ClusterSigma = ClusterSigma;
-  object.SumPT2 = SumPT2;
-  object.BTVSumPT2 = BTVSumPT2;
-  object.GenDeltaZ = GenDeltaZ;
-  object.GenSumPT2 = GenSumPT2;
   object.Flavor = Flavor;
   object.FlavorAlgo = FlavorAlgo;
   object.FlavorPhys = FlavorPhys;
@@ -323,84 +619,41 @@ void Candidate::Copy(TObject &obj) const
   object.Yd = Yd;
   object.Zd = Zd;
   object.TrackResolution = TrackResolution;
-  object.NCharged = NCharged;
-  object.NNeutrals = NNeutrals;
-  object.NeutralEnergyFraction = NeutralEnergyFraction;
-  object.ChargedEnergyFraction = ChargedEnergyFraction;
-  object.Beta = Beta;
-  object.BetaStar = BetaStar;
-  object.MeanSqDeltaR = MeanSqDeltaR;
-  object.PTD = PTD;
-  object.NTimeHits = NTimeHits;
   object.IsolationVar = IsolationVar;
   object.IsolationVarRhoCorr = IsolationVarRhoCorr;
   object.SumPtCharged = SumPtCharged;
   object.SumPtNeutral = SumPtNeutral;
   object.SumPtChargedPU = SumPtChargedPU;
   object.SumPt = SumPt;
-  object.ClusterIndex = ClusterIndex;
-  object.ClusterNDF = ClusterNDF;
-  object.ClusterSigma = ClusterSigma;
-  object.SumPT2 = SumPT2;
-
-  object.FracPt[0] = FracPt[0];
-  object.FracPt[1] = FracPt[1];
-  object.FracPt[2] = FracPt[2];
-  object.FracPt[3] = FracPt[3];
-  object.FracPt[4] = FracPt[4];
-  object.Tau[0] = Tau[0];
-  object.Tau[1] = Tau[1];
-  object.Tau[2] = Tau[2];
-  object.Tau[3] = Tau[3];
-  object.Tau[4] = Tau[4];
-
-  object.TrimmedP4[0] = TrimmedP4[0];
-  object.TrimmedP4[1] = TrimmedP4[1];
-  object.TrimmedP4[2] = TrimmedP4[2];
-  object.TrimmedP4[3] = TrimmedP4[3];
-  object.TrimmedP4[4] = TrimmedP4[4];
-  object.PrunedP4[0] = PrunedP4[0];
-  object.PrunedP4[1] = PrunedP4[1];
-  object.PrunedP4[2] = PrunedP4[2];
-  object.PrunedP4[3] = PrunedP4[3];
-  object.PrunedP4[4] = PrunedP4[4];
-  object.SoftDroppedP4[0] = SoftDroppedP4[0];
-  object.SoftDroppedP4[1] = SoftDroppedP4[1];
-  object.SoftDroppedP4[2] = SoftDroppedP4[2];
-  object.SoftDroppedP4[3] = SoftDroppedP4[3];
-  object.SoftDroppedP4[4] = SoftDroppedP4[4];
-
-  object.NSubJetsTrimmed = NSubJetsTrimmed;
-  object.NSubJetsPruned = NSubJetsPruned;
-  object.NSubJetsSoftDropped = NSubJetsSoftDropped;
   object.puppiW = puppiW;
 
-  object.SoftDroppedJet = SoftDroppedJet;
-  object.SoftDroppedSubJet1 = SoftDroppedSubJet1;
-  object.SoftDroppedSubJet2 = SoftDroppedSubJet2;
-
   object.fFactory = fFactory;
-  object.fArray = 0;
-
-  // copy cluster timing info
-  copy(ECalEnergyTimePairs.begin(), ECalEnergyTimePairs.end(), back_inserter(object.ECalEnergyTimePairs));
 
-  if(fArray && fArray->GetEntriesFast() > 0)
-  {
-    TIter itArray(fArray);
-    TObjArray *array = object.GetCandidates();
-    while((candidate = static_cast<Candidate *>(itArray.Next())))
-    {
-      array->Add(candidate);
-    }
-  }
+  // the constituents and the payloads are shared with the copy,
+  // the first of the two candidates modifying them makes its own copy
+  object.fArray = fArray;
+  object.fJetID = fJetID;
+  object.fTiming = fTiming;
+  object.fVertexing = fVertexing;
+  object.fSubstructure = fSubstructure;
+
+  shared = 0;
+  if(fArray) shared |= kSharedArray;
+  if(fJetID) shared |= kSharedJetID;
+  if(fTiming) shared |= kSharedTiming;
+  if(fVertexing) shared |= kSharedVertexing;
+  if(fSubstructure) shared |= kSharedSubstructure;
+
+  object.fShared = shared;
+  if(shared) __atomic_or_fetch(&fShared, shared, __ATOMIC_RELAXED);
+
+  object.fConstituentIDs = 0;
 }
 
 //------------------------------------------------------------------------------
 
 void Candidate::Clear(Option_t *option)
 {
-  int i;
   SetUniqueID(0);
   ResetBit(kIsReferenced);
   PID = 0;
@@ -453,15 +706,6 @@ void Candidate::Clear(Option_t *option)
   Yd = 0.0;
   Zd = 0.0;
   TrackResolution = 0.0;
-  NCharged = 0;
-  NNeutrals = 0;
-  Beta = 0.0;
-  BetaStar = 0.0;
-  MeanSqDeltaR = 0.0;
-  PTD = 0.0;
-
-  NTimeHits = 0;
-  ECalEnergyTimePairs.clear();
 
   IsolationVar = -999;
   IsolationVarRhoCorr = -999;
@@ -471,39 +715,17 @@ void Candidate::Clear(Option_t *option)
   SumPt = -999;
 
   ClusterIndex = -1;
-  ClusterNDF = -99;
-  ClusterSigma = 0.0;
-  SumPT2 = 0.0;
-  BTVSumPT2 = 0.0;
-  GenDeltaZ = 0.0;
-  GenSumPT2 = 0.0;
-
-  FracPt[0] = 0.0;
-  FracPt[1] = 0.0;
-  FracPt[2] = 0.0;
-  FracPt[3] = 0.0;
-  FracPt[4] = 0.0;
-  Tau[0] = 0.0;
-  Tau[1] = 0.0;
-  Tau[2] = 0.0;
-  Tau[3] = 0.0;
-  Tau[4] = 0.0;
-
-  SoftDroppedJet.SetXYZT(0.0, 0.0, 0.0, 0.0);
-  SoftDroppedSubJet1.SetXYZT(0.0, 0.0, 0.0, 0.0);
-  SoftDroppedSubJet2.SetXYZT(0.0, 0.0, 0.0, 0.0);
-
-  for(i = 0; i < 5; ++i)
-  {
-    TrimmedP4[i].SetXYZT(0.0, 0.0, 0.0, 0.0);
-    PrunedP4[i].SetXYZT(0.0, 0.0, 0.0, 0.0);
-    SoftDroppedP4[i].SetXYZT(0.0, 0.0, 0.0, 0.0);
-  }
 
-  NSubJetsTrimmed = 0;
-  NSubJetsPruned = 0;
-  NSubJetsSoftDropped = 0;
   puppiW = 1;
 
   fArray = 0;
+  fCandidateID = 0;
+
+  // the payloads are reclaimed by the factory together with the candidates
+  fJetID = 0;
+  fTiming = 0;
+  fVertexing = 0;
+  fSubstructure = 0;
+  fShared = 0;
+  fConstituentIDs = 0;
 }
@@ -36,8 +36,11 @@
 #include "TRef.h"
 #include "TRefArray.h"
 
+#include "classes/DelphesLorentzVector.h"
 #include "classes/SortableObject.h"
 
+#include <vector>
+
 class DelphesFactory;
 
 //---------------------------------------------------------------------------
@@ -612,6 +615,123 @@ public:
 
 //---------------------------------------------------------------------------
 
+class CandidateJetID: public TObject
+{
+public:
+  CandidateJetID();
+
+  // PileUpJetID variables
+
+  Int_t NCharged;
+  Int_t NNeutrals;
+  Float_t Beta;
+  Float_t BetaStar;
+  Float_t MeanSqDeltaR;
+  Float_t PTD;
+  Float_t FracPt[5];
+  Float_t NeutralEnergyFraction;  // charged energy fraction
+  Float_t ChargedEnergyFraction;  // neutral energy fraction
+
+  virtual void Clear(Option_t *option = "");
+
+  ClassDef(CandidateJetID, 1)
+};
+
+//---------------------------------------------------------------------------
+
+class CandidateTiming: public TObject
+{
+public:
+  CandidateTiming();
+
+  // Timing information
+
+  Int_t NTimeHits;
+  std::vector<std::pair<Float_t, Float_t> > ECalEnergyTimePairs;
+
+  virtual void Clear(Option_t *option = "");
+
+  ClassDef(CandidateTiming, 1)
+};
+
+//---------------------------------------------------------------------------
+
+class CandidateVertexing: public TObject
+{
+public:
+  CandidateVertexing();
+
+  // vertex variables
+
+  Int_t ClusterNDF;
+  Double_t ClusterSigma;
+  Double_t SumPT2;
+  Double_t BTVSumPT2;
+  Double_t GenDeltaZ;
+  Double_t GenSumPT2;
+
+  virtual void Clear(Option_t *option = "");
+
+  ClassDef(CandidateVertexing, 1)
+};
+
+//---------------------------------------------------------------------------
+
+class CandidateSubstructure: public TObject
+{
+public:
+  CandidateSubstructure();
+
+  // N-subjettiness variables
+
+  Float_t Tau[5];
+
+  // Other Substructure variables
+
+  TLorentzVector SoftDroppedJet;
+  TLorentzVector SoftDroppedSubJet1;
+  TLorentzVector SoftDroppedSubJet2;
+
+  TLorentzVector TrimmedP4[5]; // first entry (i = 0) is the total Trimmed Jet 4-momenta and from i = 1 to 4 are the trimmed subjets 4-momenta
+  TLorentzVector PrunedP4[5]; // first entry (i = 0) is the total Pruned Jet 4-momenta and from i = 1 to 4 are the pruned subjets 4-momenta
+  TLorentzVector SoftDroppedP4[5]; // first entry (i = 0) is the total SoftDropped Jet 4-momenta and from i = 1 to 4 are the pruned subjets 4-momenta
+
+  Int_t NSubJetsTrimmed; // number of subjets trimmed
+  Int_t NSubJetsPruned; // number of subjets pruned
+  Int_t NSubJetsSoftDropped; // number of subjets soft-dropped
+
+  // Exclusive clustering variables
+  Double_t ExclYmerge23;
+  Double_t ExclYmerge34;
+  Double_t ExclYmerge45;
+  Double_t ExclYmerge56;
+
+  virtual void Clear(Option_t *option = "");
+
+  ClassDef(CandidateSubstructure, 1)
+};
+
+//---------------------------------------------------------------------------
+
+class CandidateConstituentIDs: public TObject
+{
+public:
+  CandidateConstituentIDs();
+
+  // sorted identities of a candidate and of all its constituents at any depth
+
+  std::vector<ULong64_t> IDs;
+
+  // state of the identities, built by the first thread that needs them
+  UInt_t State;
+
+  virtual void Clear(Option_t *option = "");
+
+  ClassDef(CandidateConstituentIDs, 1)
+};
+
+//---------------------------------------------------------------------------
+
 class Candidate: public SortableObject
 {
   friend class DelphesFactory;
@@ -652,7 +772,8 @@ public:
   Float_t DeltaEta;
   Float_t DeltaPhi;
 
-  TLorentzVector Momentum, Position, InitialPosition, PositionError, Area;
+  DelphesLorentzVector Momentum, Position;
+  TLorentzVector InitialPosition, PositionError, Area;
 
   Float_t L; // path length
   Float_t ErrorT; // path length
@@ -677,24 +798,6 @@ public:
 
   Float_t TrackResolution;
 
-  // PileUpJetID variables
-
-  Int_t NCharged;
-  Int_t NNeutrals;
-  Float_t Beta;
-  Float_t BetaStar;
-  Float_t MeanSqDeltaR;
-  Float_t PTD;
-  Float_t FracPt[5];
-  Float_t NeutralEnergyFraction;  // charged energy fraction
-  Float_t ChargedEnergyFraction;  // neutral energy fraction 
-
-
-  // Timing information
-
-  Int_t NTimeHits;
-  std::vector<std::pair<Float_t, Float_t> > ECalEnergyTimePairs;
-
   // Isolation variables
 
   Float_t IsolationVar;
@@ -707,52 +810,46 @@ public:
   // vertex variables
 
   Int_t ClusterIndex;
-  Int_t ClusterNDF;
-  Double_t ClusterSigma;
-  Double_t SumPT2;
-  Double_t BTVSumPT2;
-  Double_t GenDeltaZ;
-  Double_t GenSumPT2;
-
-  // N-subjettiness variables
-
-  Float_t Tau[5];
 
   // Puppi weight
 
   Double_t puppiW;
 
-  // Other Substructure variables
-
-  TLorentzVector SoftDroppedJet;
-  TLorentzVector SoftDroppedSubJet1;
-  TLorentzVector SoftDroppedSubJet2;
-
-  TLorentzVector TrimmedP4[5]; // first entry (i = 0) is the total Trimmed Jet 4-momenta and from i = 1 to 4 are the trimmed subjets 4-momenta
-  TLorentzVector PrunedP4[5]; // first entry (i = 0) is the total Pruned Jet 4-momenta and from i = 1 to 4 are the pruned subjets 4-momenta
-  TLorentzVector SoftDroppedP4[5]; // first entry (i = 0) is the total SoftDropped Jet 4-momenta and from i = 1 to 4 are the pruned subjets 4-momenta
-
-  Int_t NSubJetsTrimmed; // number of subjets trimmed
-  Int_t NSubJetsPruned; // number of subjets pruned
-  Int_t NSubJetsSoftDropped; // number of subjets soft-dropped
-
-  // Exclusive clustering variables
-  Double_t ExclYmerge23;
-  Double_t ExclYmerge34;
-  Double_t ExclYmerge45;
-  Double_t ExclYmerge56;
-
   // event characteristics variables
   Double_t ParticleDensity; // particle multiplicity density in the proximity of the particle
   
   static CompBase *fgCompare; //!
   const CompBase *GetCompare() const { return fgCompare; }
 
+  // identity assigned by the factory, never reused during a run
+  ULong64_t GetCandidateID() const { return fCandidateID; }
+
+  // the array of constituents can be shared with copies of the candidate,
+  // it is only modified through AddCandidate
   void AddCandidate(Candidate *object);
   TObjArray *GetCandidates();
 
+  // payloads used only by some candidates are allocated on first write,
+  // the Get methods return default values when nothing is attached
+
+  const CandidateJetID *GetJetID() const;
+  const CandidateTiming *GetTiming() const;
+  const CandidateVertexing *GetVertexing() const;
+  const CandidateSubstructure *GetSubstructure() const;
+
+  CandidateJetID *JetID();
+  CandidateTiming *Timing();
+  CandidateVertexing *Vertexing();
+  CandidateSubstructure *Substructure();
+
+  // two candidates overlap when they share a constituent, or are constituents of one another
   Bool_t Overlaps(const Candidate *object) const;
 
+  // sorted identities of the candidate and of all its constituents at any depth,
+  // computed on first use and forgotten by AddCandidate, so it must only be
+  // called once the constituents of the candidate are complete
+  const std::vector<ULong64_t> &GetConstituentIDs() const;
+
   virtual void Copy(TObject &object) const;
   virtual TObject *Clone(const char *newname = "") const;
   virtual void Clear(Option_t *option = "");
@@ -761,9 +858,38 @@ private:
   DelphesFactory *fFactory; //!
   TObjArray *fArray; //!
 
+  ULong64_t fCandidateID; //!
+
+  CandidateJetID *fJetID; //!
+  CandidateTiming *fTiming; //!
+  CandidateVertexing *fVertexing; //!
+  CandidateSubstructure *fSubstructure; //!
+
+  // constituents and payloads shared with a copy, they are copied before being modified
+  enum
+  {
+    kSharedArray = 1 << 0,
+    kSharedJetID = 1 << 1,
+    kSharedTiming = 1 << 2,
+    kSharedVertexing = 1 << 3,
+    kSharedSubstructure = 1 << 4
+  };
+
+  mutable UInt_t fShared; //!
+
+  // state of the sorted identities
+  enum
+  {
+    kConstituentIDsBuilding = 1,
+    kConstituentIDsReady = 2
+  };
+
+  // allocated by the first call to GetConstituentIDs, never shared with a copy
+  mutable CandidateConstituentIDs *fConstituentIDs; //!
+
   void SetFactory(DelphesFactory *factory) { fFactory = factory; }
 
-  ClassDef(Candidate, 6)
+  ClassDef(Candidate, 10)
 };
 
 #endif // DelphesClasses_h
@@ -21,6 +21,10 @@
  *  Class handling creation of Candidate,
  *  TObjArray and all other objects.
  *
+ *  Objects are taken from fixed-size slabs that are kept from one
+ *  event to the next: addresses are stable, an event reset only
+ *  rewinds the slabs and each object is cleared when it is reused.
+ *
  *  \author P. Demin - UCL, Louvain-la-Neuve
  *
  */
@@ -28,31 +32,148 @@
 #include "classes/DelphesFactory.h"
 #include "classes/DelphesClasses.h"
 
-#include "ExRootAnalysis/ExRootTreeBranch.h"
+#include "ExRootAnalysis/ExRootTask.h"
 
 #include "TClass.h"
 #include "TObjArray.h"
 
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
 using namespace std;
 
+static const Long_t kSlabSize = 512;
+
+//------------------------------------------------------------------------------
+
+// permanent array holding the content of every event of a batch,
+// the selected event is swapped into the array seen by the modules
+
+class DelphesEventArray: public TObjArray
+{
+public:
+  DelphesEventArray() : fEvent(0) {}
+  ~DelphesEventArray();
+
+  void SetNumberOfEvents(Int_t size);
+
+  void SelectEvent(Int_t event);
+
+  TObjArray *GetEvent(Int_t event) { return event == fEvent ? this : fEvents[event]; }
+
+  void ClearEvents();
+
+private:
+  void Swap(DelphesEventArray *array);
+
+  Int_t fEvent;
+
+  // content of the other events and empty storage for the selected one
+  vector<DelphesEventArray *> fEvents;
+};
+
+//------------------------------------------------------------------------------
+
+DelphesEventArray::~DelphesEventArray()
+{
+  vector<DelphesEventArray *>::iterator itEvents;
+
+  for(itEvents = fEvents.begin(); itEvents != fEvents.end(); ++itEvents)
+  {
+    delete(*itEvents);
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesEventArray::SetNumberOfEvents(Int_t size)
+{
+  if(size < 1) size = 1;
+  if(size == Int_t(fEvents.size())) return;
+
+  SelectEvent(0);
+
+  while(Int_t(fEvents.size()) > size)
+  {
+    delete fEvents.back();
+    fEvents.pop_back();
+  }
+
+  while(Int_t(fEvents.size()) < size)
+  {
+    fEvents.push_back(new DelphesEventArray);
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesEventArray::SelectEvent(Int_t event)
+{
+  if(event == fEvent || fEvents.empty()) return;
+
+  Swap(fEvents[fEvent]);
+  Swap(fEvents[event]);
+
+  fEvent = event;
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesEventArray::ClearEvents()
+{
+  vector<DelphesEventArray *>::iterator itEvents;
+
+  Clear();
+
+  for(itEvents = fEvents.begin(); itEvents != fEvents.end(); ++itEvents)
+  {
+    (*itEvents)->Clear();
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesEventArray::Swap(DelphesEventArray *array)
+{
+  std::swap(fCont, array->fCont);
+  std::swap(fSize, array->fSize);
+  std::swap(fLowerBound, array->fLowerBound);
+  std::swap(fLast, array->fLast);
+  std::swap(fSorted, array->fSorted);
+}
+
 //------------------------------------------------------------------------------
 
 DelphesFactory::DelphesFactory(const char *name) :
-  TNamed(name, ""), fObjArrays(0)
+  TNamed(name, ""), fThreadSafe(kFALSE), fAccounting(kFALSE), fLastCandidateID(0), fBatchSize(1), fCandidatePool(0), fArrayPool(0)
 {
-  fObjArrays = new ExRootTreeBranch("PermanentObjArrays", TObjArray::Class(), 0);
+  fCandidatePool = GetPool(Candidate::Class());
+  fArrayPool = GetPool(TObjArray::Class());
 }
 
 //------------------------------------------------------------------------------
 
 DelphesFactory::~DelphesFactory()
 {
-  if(fObjArrays) delete fObjArrays;
+  map<const TClass *, ObjectPool *>::iterator itPools;
+  vector<char *>::iterator itSlabs;
+  vector<TObjArray *>::iterator itArrays;
+  ObjectPool *pool;
+
+  for(itPools = fPools.begin(); itPools != fPools.end(); ++itPools)
+  {
+    pool = itPools->second;
+    for(itSlabs = pool->fSlabs.begin(); itSlabs != pool->fSlabs.end(); ++itSlabs)
+    {
+      pool->fClass->DeleteArray(*itSlabs);
+    }
+    delete pool;
+  }
 
-  map<const TClass *, ExRootTreeBranch *>::iterator itBranches;
-  for(itBranches = fBranches.begin(); itBranches != fBranches.end(); ++itBranches)
+  for(itArrays = fPermanentArrays.begin(); itArrays != fPermanentArrays.end(); ++itArrays)
   {
-    delete(itBranches->second);
+    delete(*itArrays);
   }
 }
 
@@ -60,18 +181,23 @@ DelphesFactory::~DelphesFactory()
 
 void DelphesFactory::Clear(Option_t *option)
 {
-  set<TObject *>::iterator itPool;
-  for(itPool = fPool.begin(); itPool != fPool.end(); ++itPool)
+  map<const TClass *, ObjectPool *>::iterator itPools;
+  vector<TObjArray *>::iterator itArrays;
+
+  for(itArrays = fPermanentArrays.begin(); itArrays != fPermanentArrays.end(); ++itArrays)
   {
-    (*itPool)->Clear();
+    static_cast<DelphesEventArray *>(*itArrays)->ClearEvents();
   }
 
+  // TRef numbers are only given to the candidates that are written out
   TProcessID::SetObjectCount(0);
 
-  map<const TClass *, ExRootTreeBranch *>::iterator itBranches;
-  for(itBranches = fBranches.begin(); itBranches != fBranches.end(); ++itBranches)
+  fAllocations.clear();
+
+  // objects are cleared when they are reused, here the slabs are only rewound
+  for(itPools = fPools.begin(); itPools != fPools.end(); ++itPools)
   {
-    itBranches->second->Clear();
+    itPools->second->fUsed = 0;
   }
 }
 
@@ -79,18 +205,72 @@ void DelphesFactory::Clear(Option_t *option)
 
 TObjArray *DelphesFactory::NewPermanentArray()
 {
-  TObjArray *array = static_cast<TObjArray *>(fObjArrays->NewEntry());
-  fPool.insert(array);
+  DelphesEventArray *array = new DelphesEventArray;
+  if(fBatchSize > 1) array->SetNumberOfEvents(fBatchSize);
+  fPermanentArrays.push_back(array);
   return array;
 }
 
 //------------------------------------------------------------------------------
 
+void DelphesFactory::SetBatchSize(Int_t size)
+{
+  vector<TObjArray *>::iterator itArrays;
+
+  fBatchSize = size > 1 ? size : 1;
+
+  for(itArrays = fPermanentArrays.begin(); itArrays != fPermanentArrays.end(); ++itArrays)
+  {
+    static_cast<DelphesEventArray *>(*itArrays)->SetNumberOfEvents(fBatchSize);
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesFactory::SelectEvent(Int_t event)
+{
+  vector<TObjArray *>::iterator itArrays;
+
+  for(itArrays = fPermanentArrays.begin(); itArrays != fPermanentArrays.end(); ++itArrays)
+  {
+    static_cast<DelphesEventArray *>(*itArrays)->SelectEvent(event);
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesFactory::SelectEvent(TObjArray *array, Int_t event)
+{
+  static_cast<DelphesEventArray *>(array)->SelectEvent(event);
+}
+
+//------------------------------------------------------------------------------
+
+TObjArray *DelphesFactory::GetEventArray(const TObjArray *array, Int_t event) const
+{
+  return static_cast<DelphesEventArray *>(const_cast<TObjArray *>(array))->GetEvent(event);
+}
+
+//------------------------------------------------------------------------------
+
+TObjArray *DelphesFactory::NewArray()
+{
+  unique_lock<mutex> lock(fMutex, defer_lock);
+  if(fThreadSafe) lock.lock();
+
+  return static_cast<TObjArray *>(NewObject(fArrayPool));
+}
+
+//------------------------------------------------------------------------------
+
 Candidate *DelphesFactory::NewCandidate()
 {
-  Candidate *object = New<Candidate>();
+  unique_lock<mutex> lock(fMutex, defer_lock);
+  if(fThreadSafe) lock.lock();
+
+  Candidate *object = static_cast<Candidate *>(NewObject(fCandidatePool));
   object->SetFactory(this);
-  TProcessID::AssignID(object);
+  object->fCandidateID = ++fLastCandidateID;
   return object;
 }
 
@@ -98,23 +278,96 @@ Candidate *DelphesFactory::NewCandidate()
 
 TObject *DelphesFactory::New(TClass *cl)
 {
-  TObject *object = 0;
-  ExRootTreeBranch *branch = 0;
-  map<const TClass *, ExRootTreeBranch *>::iterator it = fBranches.find(cl);
+  unique_lock<mutex> lock(fMutex, defer_lock);
+  if(fThreadSafe) lock.lock();
+
+  return NewObject(GetPool(cl));
+}
+
+//------------------------------------------------------------------------------
+
+DelphesFactory::ObjectPool *DelphesFactory::GetPool(TClass *cl)
+{
+  stringstream message;
+  ObjectPool *pool = 0;
+  map<const TClass *, ObjectPool *>::iterator it = fPools.find(cl);
 
-  if(it != fBranches.end())
+  if(it != fPools.end())
   {
-    branch = it->second;
+    pool = it->second;
   }
   else
   {
-    branch = new ExRootTreeBranch(cl->GetName(), cl, 0);
-    fBranches.insert(make_pair(cl, branch));
+    if(!cl->InheritsFrom(TObject::Class()))
+    {
+      message << "class '" << cl->GetName() << "' does not inherit from TObject";
+      throw runtime_error(message.str());
+    }
+    pool = new ObjectPool;
+    pool->fClass = cl;
+    pool->fObjectSize = cl->Size();
+    pool->fUsed = 0;
+    fPools.insert(make_pair(cl, pool));
+  }
+
+  return pool;
+}
+
+//------------------------------------------------------------------------------
+
+TObject *DelphesFactory::NewObject(ObjectPool *pool)
+{
+  TObject *object;
+  Long_t slab = pool->fUsed / kSlabSize;
+
+  if(slab >= Long_t(pool->fSlabs.size()))
+  {
+    pool->fSlabs.push_back(static_cast<char *>(pool->fClass->NewArray(kSlabSize)));
+  }
+
+  object = reinterpret_cast<TObject *>(pool->fSlabs[slab] + (pool->fUsed % kSlabSize) * pool->fObjectSize);
+  ++pool->fUsed;
+
+  if(fAccounting)
+  {
+    Allocation &allocation = fAllocations[ExRootTask::GetCurrentTask()];
+    ++allocation.fObjects;
+    allocation.fBytes += pool->fObjectSize;
   }
 
-  object = branch->NewEntry();
   object->Clear();
   return object;
 }
 
 //------------------------------------------------------------------------------
+
+Long64_t DelphesFactory::GetAllocatedObjects(const TObject *task) const
+{
+  map<const TObject *, Allocation>::const_iterator it = fAllocations.find(task);
+  return it != fAllocations.end() ? it->second.fObjects : 0;
+}
+
+//------------------------------------------------------------------------------
+
+Long64_t DelphesFactory::GetAllocatedBytes(const TObject *task) const
+{
+  map<const TObject *, Allocation>::const_iterator it = fAllocations.find(task);
+  return it != fAllocations.end() ? it->second.fBytes : 0;
+}
+
+//------------------------------------------------------------------------------
+
+Long64_t DelphesFactory::GetReservedBytes() const
+{
+  map<const TClass *, ObjectPool *>::const_iterator itPools;
+  Long64_t bytes = 0;
+
+  for(itPools = fPools.begin(); itPools != fPools.end(); ++itPools)
+  {
+    bytes += Long64_t(itPools->second->fSlabs.size()) * kSlabSize * itPools->second->fObjectSize;
+  }
+
+  return bytes;
+}
+
+//------------------------------------------------------------------------------
@@ -24,6 +24,14 @@
  *  Class handling creation of Candidate,
  *  TObjArray and all other objects.
  *
+ *  Objects are taken from fixed-size slabs that are kept from one
+ *  event to the next: addresses are stable, an event reset only
+ *  rewinds the slabs and each object is cleared when it is reused.
+ *
+ *  With a batch size larger than one, the permanent arrays keep the
+ *  content of several events at the same time and the objects of all
+ *  these events are kept until the next reset.
+ *
  *  \author P. Demin - UCL, Louvain-la-Neuve
  *
  */
@@ -31,13 +39,15 @@
 #include "TNamed.h"
 
 #include <map>
-#include <set>
+#include <vector>
+
+#if !defined(__CINT__) && !defined(__CLING__)
+#include <mutex>
+#endif
 
 class TObjArray;
 class Candidate;
 
-class ExRootTreeBranch;
-
 class DelphesFactory: public TNamed
 {
 public:
@@ -46,9 +56,28 @@ public:
 
   virtual void Clear(Option_t *option = "");
 
+  void SetThreadSafe(Bool_t flag) { fThreadSafe = flag; }
+
+  // count the objects allocated by each task since the last Clear
+  void SetAccounting(Bool_t flag) { fAccounting = flag; }
+  Long64_t GetAllocatedObjects(const TObject *task) const;
+  Long64_t GetAllocatedBytes(const TObject *task) const;
+  Long64_t GetReservedBytes() const;
+
   TObjArray *NewPermanentArray();
 
-  TObjArray *NewArray() { return New<TObjArray>(); }
+  // number of events held by the permanent arrays, each array
+  // shows the content of its selected event
+  void SetBatchSize(Int_t size);
+  Int_t GetBatchSize() const { return fBatchSize; }
+
+  void SelectEvent(Int_t event);
+  void SelectEvent(TObjArray *array, Int_t event);
+
+  // content of a permanent array for any event of the batch
+  TObjArray *GetEventArray(const TObjArray *array, Int_t event) const;
+
+  TObjArray *NewArray();
 
   Candidate *NewCandidate();
 
@@ -58,13 +87,42 @@ public:
   T *New() { return static_cast<T *>(New(T::Class())); }
 
 private:
-  ExRootTreeBranch *fObjArrays; //!
-
 #if !defined(__CINT__) && !defined(__CLING__)
-  std::map<const TClass *, ExRootTreeBranch *> fBranches; //!
-#endif
+  struct ObjectPool
+  {
+    TClass *fClass;
+    Long_t fObjectSize;
+    Long_t fUsed;
+    std::vector<char *> fSlabs;
+  };
+
+  struct Allocation
+  {
+    Long64_t fObjects;
+    Long64_t fBytes;
+  };
+
+  ObjectPool *GetPool(TClass *cl);
+  TObject *NewObject(ObjectPool *pool);
+
+  Bool_t fThreadSafe; //!
+  Bool_t fAccounting; //!
+
+  ULong64_t fLastCandidateID; //!
+
+  Int_t fBatchSize; //!
 
-  std::set<TObject *> fPool; //!
+  std::mutex fMutex; //!
+
+  ObjectPool *fCandidatePool; //!
+  ObjectPool *fArrayPool; //!
+
+  std::map<const TClass *, ObjectPool *> fPools; //!
+
+  std::map<const TObject *, Allocation> fAllocations; //!
+
+  std::vector<TObjArray *> fPermanentArrays; //!
+#endif
 
   ClassDef(DelphesFactory, 1)
 };
@@ -35,14 +35,13 @@
 
 #include <stdio.h>
 
-#include "TDatabasePDG.h"
 #include "TLorentzVector.h"
 #include "TObjArray.h"
-#include "TParticlePDG.h"
 #include "TStopwatch.h"
 
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
+#include "classes/DelphesPDGTable.h"
 #include "classes/DelphesStream.h"
 
 #include "ExRootAnalysis/ExRootTreeBranch.h"
@@ -60,7 +59,7 @@ DelphesHepMCReader::DelphesHepMCReader() :
 {
   fBuffer = new char[kBufferSize];
 
-  fPDG = TDatabasePDG::Instance();
+  fPDG = DelphesPDGTable::Instance();
 }
 
 //---------------------------------------------------------------------------
@@ -368,8 +367,7 @@ void DelphesHepMCReader::AnalyzeParticle(DelphesFactory *factory,
   TObjArray *partonOutputArray)
 {
   Candidate *candidate;
-  TParticlePDG *pdgParticle;
-  int pdgCode;
+  int pdgCode, pdgIndex;
 
   candidate = factory->NewCandidate();
 
@@ -378,8 +376,8 @@ void DelphesHepMCReader::AnalyzeParticle(DelphesFactory *factory,
 
   candidate->Status = fStatus;
 
-  pdgParticle = fPDG->GetParticle(fPID);
-  candidate->Charge = pdgParticle ? int(pdgParticle->Charge() / 3.0) : -999;
+  pdgIndex = fPDG->GetIndex(fPID);
+  candidate->Charge = fPDG->GetCharge(pdgIndex);
   candidate->Mass = fMass;
 
   candidate->Momentum.SetPxPyPzE(fPx, fPy, fPz, fE);
@@ -415,7 +413,7 @@ void DelphesHepMCReader::AnalyzeParticle(DelphesFactory *factory,
 
   allParticleOutputArray->Add(candidate);
 
-  if(!pdgParticle) return;
+  if(!fPDG->IsKnown(pdgIndex)) return;
 
   if(fStatus == 1)
   {
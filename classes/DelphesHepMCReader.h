@@ -34,7 +34,7 @@
 
 class TObjArray;
 class TStopwatch;
-class TDatabasePDG;
+class DelphesPDGTable;
 class ExRootTreeBranch;
 class DelphesFactory;
 
@@ -71,7 +71,7 @@ private:
 
   char *fBuffer;
 
-  TDatabasePDG *fPDG;
+  DelphesPDGTable *fPDG;
 
   int fEventNumber, fMPI, fProcessID, fSignalCode, fVertexCounter, fBeamCode[2];
   double fScale, fAlphaQCD, fAlphaQED;
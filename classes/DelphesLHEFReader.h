@@ -34,7 +34,7 @@
 
 class TObjArray;
 class TStopwatch;
-class TDatabasePDG;
+class DelphesPDGTable;
 class ExRootTreeBranch;
 class DelphesFactory;
 
@@ -69,7 +69,7 @@ private:
 
   char *fBuffer;
 
-  TDatabasePDG *fPDG;
+  DelphesPDGTable *fPDG;
 
   bool fEventReady;
 
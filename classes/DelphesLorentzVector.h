@@ -0,0 +1,207 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DelphesLorentzVector_h
+#define DelphesLorentzVector_h
+
+/** \class DelphesLorentzVector
+ *
+ *  TLorentzVector that remembers pt, eta, phi and rapidity
+ *  once they have been computed.
+ *
+ *  Every method that modifies the vector forgets the cached values.
+ *  Modifications made through a TLorentzVector reference or pointer
+ *  bypass this class and must be avoided.
+ *
+ *  The cached values are transient and are not written to file.
+ *
+ */
+
+#include "TLorentzVector.h"
+#include "TVector2.h"
+#include "TVector3.h"
+
+class DelphesLorentzVector: public TLorentzVector
+{
+public:
+  DelphesLorentzVector() :
+    TLorentzVector(), fCached(0) {}
+  DelphesLorentzVector(Double_t x, Double_t y, Double_t z, Double_t t) :
+    TLorentzVector(x, y, z, t), fCached(0) {}
+  DelphesLorentzVector(const TLorentzVector &vector) :
+    TLorentzVector(vector), fCached(0) {}
+  DelphesLorentzVector(const DelphesLorentzVector &vector) :
+    TLorentzVector(vector), fCached(0) {}
+
+  DelphesLorentzVector &operator=(const TLorentzVector &vector)
+  {
+    TLorentzVector::operator=(vector);
+    Invalidate();
+    return *this;
+  }
+
+  DelphesLorentzVector &operator=(const DelphesLorentzVector &vector)
+  {
+    TLorentzVector::operator=(vector);
+    Invalidate();
+    return *this;
+  }
+
+  // cached quantities
+
+  Double_t Pt() const { return Get(kPt); }
+  Double_t Perp() const { return Get(kPt); }
+  Double_t Eta() const { return Get(kEta); }
+  Double_t PseudoRapidity() const { return Get(kEta); }
+  Double_t Phi() const { return Get(kPhi); }
+  Double_t Rapidity() const { return Get(kRapidity); }
+
+  using TLorentzVector::DeltaPhi;
+  using TLorentzVector::DeltaR;
+
+  Double_t DeltaPhi(const DelphesLorentzVector &vector) const
+  {
+    return TVector2::Phi_mpi_pi(Phi() - vector.Phi());
+  }
+
+  Double_t DeltaR(const DelphesLorentzVector &vector) const
+  {
+    Double_t deta = Eta() - vector.Eta();
+    Double_t dphi = DeltaPhi(vector);
+    return TMath::Sqrt(deta * deta + dphi * dphi);
+  }
+
+  // modifiers
+
+  using TLorentzVector::operator();
+  using TLorentzVector::operator[];
+
+  Double_t &operator()(int i) { Invalidate(); return TLorentzVector::operator()(i); }
+  Double_t &operator[](int i) { Invalidate(); return TLorentzVector::operator[](i); }
+
+  DelphesLorentzVector &operator+=(const TLorentzVector &vector)
+  {
+    TLorentzVector::operator+=(vector);
+    Invalidate();
+    return *this;
+  }
+
+  DelphesLorentzVector &operator-=(const TLorentzVector &vector)
+  {
+    TLorentzVector::operator-=(vector);
+    Invalidate();
+    return *this;
+  }
+
+  DelphesLorentzVector &operator*=(Double_t a)
+  {
+    TLorentzVector::operator*=(a);
+    Invalidate();
+    return *this;
+  }
+
+  void SetX(Double_t a) { TLorentzVector::SetX(a); Invalidate(); }
+  void SetY(Double_t a) { TLorentzVector::SetY(a); Invalidate(); }
+  void SetZ(Double_t a) { TLorentzVector::SetZ(a); Invalidate(); }
+  void SetT(Double_t a) { TLorentzVector::SetT(a); Invalidate(); }
+  void SetPx(Double_t a) { TLorentzVector::SetPx(a); Invalidate(); }
+  void SetPy(Double_t a) { TLorentzVector::SetPy(a); Invalidate(); }
+  void SetPz(Double_t a) { TLorentzVector::SetPz(a); Invalidate(); }
+  void SetE(Double_t a) { TLorentzVector::SetE(a); Invalidate(); }
+
+  void SetVect(const TVector3 &vector) { TLorentzVector::SetVect(vector); Invalidate(); }
+  void SetVectM(const TVector3 &vector, Double_t m) { TLorentzVector::SetVectM(vector, m); Invalidate(); }
+  void SetVectMag(const TVector3 &vector, Double_t m) { TLorentzVector::SetVectMag(vector, m); Invalidate(); }
+
+  void SetXYZT(Double_t x, Double_t y, Double_t z, Double_t t) { TLorentzVector::SetXYZT(x, y, z, t); Invalidate(); }
+  void SetPxPyPzE(Double_t px, Double_t py, Double_t pz, Double_t e) { TLorentzVector::SetPxPyPzE(px, py, pz, e); Invalidate(); }
+  void SetXYZM(Double_t x, Double_t y, Double_t z, Double_t m) { TLorentzVector::SetXYZM(x, y, z, m); Invalidate(); }
+  void SetPtEtaPhiM(Double_t pt, Double_t eta, Double_t phi, Double_t m) { TLorentzVector::SetPtEtaPhiM(pt, eta, phi, m); Invalidate(); }
+  void SetPtEtaPhiE(Double_t pt, Double_t eta, Double_t phi, Double_t e) { TLorentzVector::SetPtEtaPhiE(pt, eta, phi, e); Invalidate(); }
+
+  void SetPerp(Double_t a) { TLorentzVector::SetPerp(a); Invalidate(); }
+  void SetPhi(Double_t a) { TLorentzVector::SetPhi(a); Invalidate(); }
+  void SetTheta(Double_t a) { TLorentzVector::SetTheta(a); Invalidate(); }
+  void SetRho(Double_t a) { TLorentzVector::SetRho(a); Invalidate(); }
+
+  void Boost(Double_t bx, Double_t by, Double_t bz) { TLorentzVector::Boost(bx, by, bz); Invalidate(); }
+  void Boost(const TVector3 &vector) { TLorentzVector::Boost(vector); Invalidate(); }
+
+  void RotateX(Double_t angle) { TLorentzVector::RotateX(angle); Invalidate(); }
+  void RotateY(Double_t angle) { TLorentzVector::RotateY(angle); Invalidate(); }
+  void RotateZ(Double_t angle) { TLorentzVector::RotateZ(angle); Invalidate(); }
+  void RotateUz(const TVector3 &vector) { TLorentzVector::RotateUz(vector); Invalidate(); }
+
+private:
+  enum
+  {
+    kPt,
+    kEta,
+    kPhi,
+    kRapidity,
+    kNumberOfValues
+  };
+
+  Double_t Get(Int_t index) const;
+  void Invalidate();
+
+  mutable Double_t fValues[kNumberOfValues]; //!
+  mutable UInt_t fCached; //!
+
+  ClassDef(DelphesLorentzVector, 1)
+};
+
+//---------------------------------------------------------------------------
+
+#if !defined(__CINT__)
+
+// modules running concurrently can read the same vector,
+// a value is published before the bit announcing it
+
+inline Double_t DelphesLorentzVector::Get(Int_t index) const
+{
+  Double_t value;
+  if(__atomic_load_n(&fCached, __ATOMIC_ACQUIRE) & (1U << index))
+  {
+    __atomic_load(&fValues[index], &value, __ATOMIC_RELAXED);
+    return value;
+  }
+
+  switch(index)
+  {
+    case kPt: value = TLorentzVector::Pt(); break;
+    case kEta: value = TLorentzVector::Eta(); break;
+    case kPhi: value = TLorentzVector::Phi(); break;
+    default: value = TLorentzVector::Rapidity(); break;
+  }
+
+  __atomic_store(&fValues[index], &value, __ATOMIC_RELAXED);
+  __atomic_fetch_or(&fCached, 1U << index, __ATOMIC_RELEASE);
+  return value;
+}
+
+//---------------------------------------------------------------------------
+
+inline void DelphesLorentzVector::Invalidate()
+{
+  __atomic_store_n(&fCached, 0U, __ATOMIC_RELAXED);
+}
+
+#endif
+
+#endif // DelphesLorentzVector_h
@@ -26,7 +26,9 @@
 
 #include "classes/DelphesModule.h"
 
+#include "classes/DelphesArrayChain.h"
 #include "classes/DelphesFactory.h"
+#include "classes/DelphesRandom.h"
 
 #include "ExRootAnalysis/ExRootResult.h"
 #include "ExRootAnalysis/ExRootTreeBranch.h"
@@ -45,15 +47,24 @@
 using namespace std;
 
 DelphesModule::DelphesModule() :
-  fTreeWriter(0), fFactory(0), fPlots(0),
-  fPlotFolder(0), fExportFolder(0)
+  fTreeWriter(0), fFactory(0), fPlots(0), fRandom(0), fHasBranches(kFALSE), fFirstEvent(0),
+  fPlotFolder(0), fExportFolder(0), fChainFolder(0)
 {
+  fRandom = new DelphesRandom;
 }
 
 //------------------------------------------------------------------------------
 
 DelphesModule::~DelphesModule()
 {
+  vector<DelphesArrayChain *>::iterator itChains;
+
+  for(itChains = fChains.begin(); itChains != fChains.end(); ++itChains)
+  {
+    delete(*itChains);
+  }
+
+  if(fRandom) delete fRandom;
 }
 
 //------------------------------------------------------------------------------
@@ -76,10 +87,70 @@ void DelphesModule::Finish()
 
 //------------------------------------------------------------------------------
 
+void DelphesModule::InitRun()
+{
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesModule::ProcessBatch(Int_t size)
+{
+  Int_t event;
+  for(event = 0; event < size; ++event)
+  {
+    SelectEvent(event);
+    Process();
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesModule::SelectEvent(Int_t event)
+{
+  DelphesFactory *factory = GetFactory();
+  vector<TObjArray *>::iterator itArrays;
+  vector<const DelphesArrayChain *>::iterator itChains;
+  Int_t i, size;
+
+  for(itArrays = fArrays.begin(); itArrays != fArrays.end(); ++itArrays)
+  {
+    factory->SelectEvent(*itArrays, event);
+  }
+
+  // the arrays of an imported chain belong to other modules
+  for(itChains = fImportedChains.begin(); itChains != fImportedChains.end(); ++itChains)
+  {
+    size = (*itChains)->GetNumberOfSegments();
+    for(i = 0; i < size; ++i)
+    {
+      factory->SelectEvent(const_cast<TObjArray *>((*itChains)->GetSegment(i)), event);
+    }
+  }
+
+  SelectRandomEvent(event);
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesModule::SelectRandomEvent(Int_t event)
+{
+  fRandom->SetEvent(fFirstEvent + event);
+}
+
+//------------------------------------------------------------------------------
+
+TObjArray *DelphesModule::GetEventArray(const TObjArray *array, Int_t event)
+{
+  return GetFactory()->GetEventArray(array, event);
+}
+
+//------------------------------------------------------------------------------
+
 TObjArray *DelphesModule::ImportArray(const char *name)
 {
   stringstream message;
   TObjArray *object;
+  DelphesArrayChain *chain;
 
   object = static_cast<TObjArray *>(GetObject(Form("Export/%s", name), TObjArray::Class()));
   if(!object)
@@ -89,6 +160,26 @@ TObjArray *DelphesModule::ImportArray(const char *name)
     throw runtime_error(message.str());
   }
 
+  // the content of a chain is only copied into its array when it is imported this way
+  chain = static_cast<DelphesArrayChain *>(GetObject(Form("Chain/%s", name), DelphesArrayChain::Class()));
+  if(chain) chain->SetFilled(kTRUE);
+
+  fImportedArrays.push_back(name);
+  fArrays.push_back(object);
+
+  return object;
+}
+
+//------------------------------------------------------------------------------
+
+TObjArray *DelphesModule::UpdateArray(const char *name)
+{
+  // same as ImportArray for a module that modifies the imported
+  // array or its candidates in place
+  TObjArray *object = ImportArray(name);
+
+  fUpdatedArrays.push_back(name);
+
   return object;
 }
 
@@ -107,11 +198,58 @@ TObjArray *DelphesModule::ExportArray(const char *name)
   array->SetName(name);
   fExportFolder->Add(array);
 
+  fExportedArrays.push_back(string(GetName()) + "/" + name);
+  fArrays.push_back(array);
+
   return array;
 }
 
 //------------------------------------------------------------------------------
 
+const DelphesArrayChain *DelphesModule::ImportChain(const char *name)
+{
+  // same as ImportArray for a module that only loops over the imported
+  // candidates, any array can be imported as a chain of one array
+  DelphesArrayChain *chain;
+
+  chain = static_cast<DelphesArrayChain *>(GetObject(Form("Chain/%s", name), DelphesArrayChain::Class()));
+  if(chain)
+  {
+    fImportedArrays.push_back(name);
+    fImportedChains.push_back(chain);
+  }
+  else
+  {
+    chain = new DelphesArrayChain(ImportArray(name));
+    chain->Add(chain->GetArray());
+    fChains.push_back(chain);
+  }
+
+  chain->SetImported(kTRUE);
+
+  return chain;
+}
+
+//------------------------------------------------------------------------------
+
+DelphesArrayChain *DelphesModule::ExportChain(const char *name)
+{
+  DelphesArrayChain *chain;
+  if(!fChainFolder)
+  {
+    fChainFolder = NewFolder("Chain");
+  }
+
+  chain = new DelphesArrayChain(ExportArray(name));
+
+  fChainFolder->Add(chain);
+  fChains.push_back(chain);
+
+  return chain;
+}
+
+//------------------------------------------------------------------------------
+
 ExRootTreeBranch *DelphesModule::NewBranch(const char *name, TClass *cl)
 {
   stringstream message;
@@ -124,6 +262,7 @@ ExRootTreeBranch *DelphesModule::NewBranch(const char *name, TClass *cl)
       throw runtime_error(message.str());
     }
   }
+  fHasBranches = kTRUE;
   return fTreeWriter->NewBranch(name, cl);
 }
 
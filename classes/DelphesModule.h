@@ -29,6 +29,13 @@
 
 #include "ExRootAnalysis/ExRootTask.h"
 
+#include <string>
+#include <vector>
+
+#if !defined(__CINT__) && !defined(__CLING__)
+#include "classes/DelphesArrayView.h"
+#endif
+
 class TClass;
 class TObject;
 class TFolder;
@@ -38,7 +45,9 @@ class ExRootResult;
 class ExRootTreeBranch;
 class ExRootTreeWriter;
 
+class DelphesArrayChain;
 class DelphesFactory;
+class DelphesRandom;
 
 class DelphesModule: public ExRootTask
 {
@@ -50,22 +59,75 @@ public:
   virtual void Process();
   virtual void Finish();
 
+  // called after Init when the parameters of a new run have been set,
+  // for the modules holding resources that depend on these parameters
+  virtual void InitRun();
+
+  // parameters read again by InitRun, that can change from one run to the next
+  virtual Bool_t IsRunParameter(const char *name) const { return kFALSE; }
+
+  // by default the events of the batch are selected and processed one by one
+  virtual void ProcessBatch(Int_t size);
+
+  // event number of the first event of the batch
+  void SetFirstEvent(Long64_t event) { fFirstEvent = event; }
+
   TObjArray *ImportArray(const char *name);
+  TObjArray *UpdateArray(const char *name);
   TObjArray *ExportArray(const char *name);
 
+  const DelphesArrayChain *ImportChain(const char *name);
+  DelphesArrayChain *ExportChain(const char *name);
+
   ExRootTreeBranch *NewBranch(const char *name, TClass *cl);
 
   ExRootResult *GetPlots();
   DelphesFactory *GetFactory();
+  DelphesRandom *GetRandom() { return fRandom; }
+
+  Bool_t HasBranches() const { return fHasBranches; }
+
+#if !defined(__CINT__) && !defined(__CLING__)
+  const std::vector<std::string> &GetImportedArrays() const { return fImportedArrays; }
+  const std::vector<std::string> &GetUpdatedArrays() const { return fUpdatedArrays; }
+  const std::vector<std::string> &GetExportedArrays() const { return fExportedArrays; }
+#endif
 
 protected:
+  // show the arrays of this module for the given event of the batch
+  // and position the random stream at this event
+  void SelectEvent(Int_t event);
+
+  // content of an imported or exported array for the given event of the batch
+  TObjArray *GetEventArray(const TObjArray *array, Int_t event);
+
+  // position the random stream at the given event of the batch
+  void SelectRandomEvent(Int_t event);
+
   ExRootTreeWriter *fTreeWriter;
   DelphesFactory *fFactory;
 
 private:
   ExRootResult *fPlots;
 
-  TFolder *fPlotFolder, *fExportFolder;
+  DelphesRandom *fRandom; //!
+
+  Bool_t fHasBranches; //!
+
+  Long64_t fFirstEvent; //!
+
+#if !defined(__CINT__) && !defined(__CLING__)
+  std::vector<std::string> fImportedArrays; //!
+  std::vector<std::string> fUpdatedArrays; //!
+  std::vector<std::string> fExportedArrays; //!
+
+  std::vector<DelphesArrayChain *> fChains; //!
+
+  std::vector<TObjArray *> fArrays; //!
+  std::vector<const DelphesArrayChain *> fImportedChains; //!
+#endif
+
+  TFolder *fPlotFolder, *fExportFolder, *fChainFolder;
 
   ClassDef(DelphesModule, 1)
 };
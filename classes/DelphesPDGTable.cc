@@ -0,0 +1,111 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** \class DelphesPDGTable
+ *
+ *  Particle properties of TDatabasePDG stored in plain arrays.
+ *
+ */
+
+#include "classes/DelphesPDGTable.h"
+
+#include "TDatabasePDG.h"
+#include "THashList.h"
+#include "TParticlePDG.h"
+
+#include <algorithm>
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+
+DelphesPDGTable *DelphesPDGTable::Instance()
+{
+  static DelphesPDGTable table;
+  return &table;
+}
+
+//------------------------------------------------------------------------------
+
+DelphesPDGTable::DelphesPDGTable() :
+  fDirect(2 * kDirectRange, 0)
+{
+  TDatabasePDG *pdg = TDatabasePDG::Instance();
+  TParticlePDG *particle;
+
+  // index 0 is kept for the codes that are not registered
+  fPID.push_back(0);
+  fParticle.push_back(0);
+  fCharge.push_back(-999);
+  fMass.push_back(-999.9);
+  fLifetime.push_back(0.0);
+
+  if(!pdg->ParticleList()) pdg->ReadPDGTable();
+
+  TIter itParticles(pdg->ParticleList());
+  while((particle = static_cast<TParticlePDG *>(itParticles.Next())))
+  {
+    Register(particle->PdgCode());
+  }
+}
+
+//------------------------------------------------------------------------------
+
+Int_t DelphesPDGTable::Register(Int_t pid)
+{
+  TParticlePDG *particle;
+  vector<pair<Int_t, Int_t> >::iterator itSparse;
+  Int_t index = GetIndex(pid);
+
+  if(index > 0) return index;
+
+  index = fPID.size();
+  particle = TDatabasePDG::Instance()->GetParticle(pid);
+
+  fPID.push_back(pid);
+  fParticle.push_back(particle);
+  fCharge.push_back(particle ? Int_t(particle->Charge() / 3.0) : -999);
+  fMass.push_back(particle ? particle->Mass() : -999.9);
+  fLifetime.push_back(particle ? particle->Lifetime() : 0.0);
+
+  if(pid > -kDirectRange && pid < kDirectRange)
+  {
+    fDirect[pid + kDirectRange] = index;
+  }
+  else
+  {
+    itSparse = lower_bound(fSparse.begin(), fSparse.end(), make_pair(pid, 0));
+    fSparse.insert(itSparse, make_pair(pid, index));
+  }
+
+  return index;
+}
+
+//------------------------------------------------------------------------------
+
+Int_t DelphesPDGTable::GetSparseIndex(Int_t pid) const
+{
+  vector<pair<Int_t, Int_t> >::const_iterator itSparse;
+
+  itSparse = lower_bound(fSparse.begin(), fSparse.end(), make_pair(pid, 0));
+  if(itSparse == fSparse.end() || itSparse->first != pid) return 0;
+
+  return itSparse->second;
+}
+
+//------------------------------------------------------------------------------
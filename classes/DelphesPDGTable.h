@@ -0,0 +1,159 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DelphesPDGTable_h
+#define DelphesPDGTable_h
+
+/** \class DelphesPDGTable
+ *
+ *  Particle properties of TDatabasePDG stored in plain arrays.
+ *
+ *  Every PDG code known to TDatabasePDG, and every code registered by
+ *  the modules during their initialization, gets a dense index.
+ *  Codes that are not registered have index 0. Small codes are found
+ *  with a single array load, larger ones with a binary search.
+ *
+ *  Codes are only registered before the event processing starts,
+ *  the table is then read concurrently without locking.
+ *
+ */
+
+#include "Rtypes.h"
+
+#include <utility>
+#include <vector>
+
+class TParticlePDG;
+
+class DelphesPDGTable
+{
+public:
+  static DelphesPDGTable *Instance();
+
+  // index of a code, 0 if the code is not registered
+  Int_t GetIndex(Int_t pid) const
+  {
+    if(pid > -kDirectRange && pid < kDirectRange) return fDirect[pid + kDirectRange];
+    return GetSparseIndex(pid);
+  }
+
+  // index of a code, registered if needed
+  Int_t Register(Int_t pid);
+
+  Int_t GetSize() const { return fPID.size(); }
+
+  Int_t GetPID(Int_t index) const { return fPID[index]; }
+
+  // properties of TDatabasePDG, charge -999 and mass -999.9 for unknown particles
+
+  Bool_t IsKnown(Int_t index) const { return fParticle[index] != 0; }
+  const TParticlePDG *GetParticle(Int_t index) const { return fParticle[index]; }
+
+  Int_t GetCharge(Int_t index) const { return fCharge[index]; }
+  Double_t GetMass(Int_t index) const { return fMass[index]; }
+  Double_t GetLifetime(Int_t index) const { return fLifetime[index]; }
+
+private:
+  DelphesPDGTable();
+
+  Int_t GetSparseIndex(Int_t pid) const;
+
+  static const Int_t kDirectRange = 1 << 14;
+
+  // index of the codes in (-kDirectRange, kDirectRange)
+  std::vector<Int_t> fDirect;
+
+  // code and index of the other codes, sorted by code
+  std::vector<std::pair<Int_t, Int_t> > fSparse;
+
+  std::vector<Int_t> fPID;
+  std::vector<const TParticlePDG *> fParticle;
+  std::vector<Int_t> fCharge;
+  std::vector<Double_t> fMass;
+  std::vector<Double_t> fLifetime;
+};
+
+//---------------------------------------------------------------------------
+
+/** \class DelphesPDGMap
+ *
+ *  Value per PDG code stored by dense index of DelphesPDGTable.
+ *
+ *  As in the configuration cards, the value of code 0 is used for
+ *  the codes without a value, including the codes registered after
+ *  the map was filled.
+ *
+ */
+
+template <typename T>
+class DelphesPDGMap
+{
+public:
+  DelphesPDGMap() :
+    fTable(DelphesPDGTable::Instance()), fDefault() {}
+
+  void Set(Int_t pid, const T &value)
+  {
+    Int_t index = fTable->Register(pid);
+
+    if(index >= Int_t(fValues.size()))
+    {
+      fValues.resize(fTable->GetSize(), fDefault);
+      fSet.resize(fTable->GetSize(), false);
+    }
+
+    fValues[index] = value;
+    fSet[index] = true;
+
+    if(pid == 0) SetDefault(value);
+  }
+
+  void Clear()
+  {
+    fDefault = T();
+    fValues.clear();
+    fSet.clear();
+  }
+
+  const T &Get(Int_t pid) const
+  {
+    Int_t index = fTable->GetIndex(pid);
+    return index < Int_t(fValues.size()) ? fValues[index] : fDefault;
+  }
+
+  const T &operator[](Int_t pid) const { return Get(pid); }
+
+private:
+  void SetDefault(const T &value)
+  {
+    Int_t i, size = fValues.size();
+
+    fDefault = value;
+    for(i = 0; i < size; ++i)
+    {
+      if(!fSet[i]) fValues[i] = value;
+    }
+  }
+
+  DelphesPDGTable *fTable;
+  T fDefault;
+  std::vector<T> fValues;
+  std::vector<bool> fSet;
+};
+
+#endif /* DelphesPDGTable_h */
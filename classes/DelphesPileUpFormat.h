@@ -0,0 +1,208 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DelphesPileUpFormat_h
+#define DelphesPileUpFormat_h
+
+/** \class DelphesPileUpFormat
+ *
+ *  Layout of the pile-up binary files of version 2.
+ *
+ *  The values are stored in the byte order of the machine that wrote
+ *  the file. The file starts with a header and is followed by blocks of
+ *  particles, the table of events and a trailer giving the position of
+ *  the table and the number of events.
+ *
+ *  Each block stores the particles of consecutive events column by
+ *  column: PID, mass, x, y, z, t, px, py, pz, e and charge. The position
+ *  and momentum columns can be stored as half-precision floats. Each
+ *  column is padded to a multiple of 8 bytes.
+ *
+ *  Each entry of the table gives the block of the event, the position
+ *  of its first particle in the block, its number of particles, its
+ *  number of charged particles and the sum of their squared transverse
+ *  momenta.
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+class DelphesPileUpFormat
+{
+public:
+  enum
+  {
+    kHalfPosition = 1 << 0,
+    kHalfMomentum = 1 << 1
+  };
+
+  enum
+  {
+    kPID,
+    kMass,
+    kX,
+    kY,
+    kZ,
+    kT,
+    kPx,
+    kPy,
+    kPz,
+    kE,
+    kCharge,
+    kNumberOfColumns
+  };
+
+  struct Header
+  {
+    char fMagic[16];
+    uint32_t fByteOrder;
+    uint32_t fVersion;
+    uint32_t fFlags;
+    uint32_t fReserved;
+  };
+
+  struct Block
+  {
+    int64_t fParticles;
+    int64_t fReserved;
+  };
+
+  struct Event
+  {
+    int64_t fBlock;
+    int32_t fFirst;
+    int32_t fSize;
+    int32_t fCharged;
+    int32_t fReserved;
+    double fSumPT2;
+  };
+
+  struct Trailer
+  {
+    int64_t fEvents;
+    int64_t fEntries;
+  };
+
+  static const uint32_t kVersion = 2;
+  static const uint32_t kByteOrder = 0x01020304;
+
+  static void SetMagic(Header &header)
+  {
+    memcpy(header.fMagic, "DelphesPileUpV2", sizeof(header.fMagic));
+  }
+
+  static bool HasMagic(const Header &header)
+  {
+    return memcmp(header.fMagic, "DelphesPileUpV2", sizeof(header.fMagic)) == 0;
+  }
+
+  // number of bytes used by one value of a column
+  static size_t GetWidth(int column, uint32_t flags)
+  {
+    if(column == kCharge) return 2;
+    if(column >= kX && column <= kT && (flags & kHalfPosition)) return 2;
+    if(column >= kPx && column <= kE && (flags & kHalfMomentum)) return 2;
+    return 4;
+  }
+
+  // position of each column after the block header and size of the block
+  static size_t GetColumns(int64_t particles, uint32_t flags, size_t offsets[kNumberOfColumns])
+  {
+    size_t offset = sizeof(Block);
+    int column;
+
+    for(column = 0; column < kNumberOfColumns; ++column)
+    {
+      offsets[column] = offset;
+      offset += (particles * GetWidth(column, flags) + 7) & ~size_t(7);
+    }
+
+    return offset;
+  }
+
+  // IEEE 754 half-precision conversions, rounding to the nearest even value
+
+  static uint16_t FloatToHalf(float value)
+  {
+    uint32_t bits, sign, mantissa, half, remainder, halfway;
+    int32_t exponent, shift;
+
+    memcpy(&bits, &value, 4);
+
+    sign = (bits >> 16) & 0x8000;
+    exponent = int32_t((bits >> 23) & 0xff) - 127 + 15;
+    mantissa = bits & 0x7fffff;
+
+    // infinity and not-a-number
+    if(((bits >> 23) & 0xff) == 0xff) return sign | 0x7c00 | (mantissa ? 0x200 : 0);
+
+    // overflow
+    if(exponent >= 31) return sign | 0x7c00;
+
+    // subnormal values and underflow
+    if(exponent <= 0)
+    {
+      if(exponent < -10) return sign;
+      mantissa |= 0x800000;
+      shift = 14 - exponent;
+      half = mantissa >> shift;
+      remainder = mantissa & ((1U << shift) - 1);
+      halfway = 1U << (shift - 1);
+      if(remainder > halfway || (remainder == halfway && (half & 1))) ++half;
+      return sign | half;
+    }
+
+    // a carry out of the mantissa correctly increments the exponent
+    half = (uint32_t(exponent) << 10) | (mantissa >> 13);
+    remainder = mantissa & 0x1fff;
+    if(remainder > 0x1000 || (remainder == 0x1000 && (half & 1))) ++half;
+    return sign | half;
+  }
+
+  static float HalfToFloat(uint16_t half)
+  {
+    uint32_t bits, sign, exponent, mantissa;
+    float value;
+
+    sign = uint32_t(half & 0x8000) << 16;
+    exponent = (half >> 10) & 0x1f;
+    mantissa = half & 0x3ff;
+
+    if(exponent == 0)
+    {
+      value = mantissa * (1.0f / 16777216.0f);
+      return sign ? -value : value;
+    }
+
+    if(exponent == 31)
+    {
+      bits = sign | 0x7f800000 | (mantissa << 13);
+    }
+    else
+    {
+      bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+    }
+
+    memcpy(&value, &bits, 4);
+    return value;
+  }
+};
+
+#endif // DelphesPileUpFormat_h
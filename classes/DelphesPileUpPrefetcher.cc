@@ -0,0 +1,229 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** \class DelphesPileUpPrefetcher
+ *
+ *  Reads the pile-up of the next events in a background thread.
+ *
+ */
+
+#include "classes/DelphesPileUpPrefetcher.h"
+
+#include "classes/DelphesPileUpReader.h"
+#include "classes/DelphesRandom.h"
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+
+DelphesPileUpPrefetcher::DelphesPileUpPrefetcher(DelphesPileUpReader *reader, DrawFunction draw, Int_t size) :
+  fReader(reader), fDraw(draw), fSeed(0), fStream(0), fBegin(0), fEnd(0), fGeneration(0),
+  fStarted(kFALSE), fStop(kFALSE), fEvent(0), fParticle(0), fLast(0), fCharged(0), fSumPT2(0.0)
+{
+  fEvents.resize(size > 0 ? size : 1);
+}
+
+//------------------------------------------------------------------------------
+
+DelphesPileUpPrefetcher::~DelphesPileUpPrefetcher()
+{
+  {
+    lock_guard<mutex> lock(fMutex);
+    fStop = kTRUE;
+  }
+  fCondition.notify_all();
+
+  if(fThread.joinable()) fThread.join();
+}
+
+//------------------------------------------------------------------------------
+
+Int_t DelphesPileUpPrefetcher::SelectEvent(UInt_t seed, UInt_t stream, ULong64_t number)
+{
+  unique_lock<mutex> lock(fMutex);
+
+  if(!fStarted)
+  {
+    fStarted = kTRUE;
+    fThread = thread(&DelphesPileUpPrefetcher::Loop, this);
+  }
+
+  if(fGeneration == 0 || seed != fSeed || stream != fStream || number < fBegin || number > fEnd)
+  {
+    // restart from the requested event
+    fSeed = seed;
+    fStream = stream;
+    fBegin = number;
+    fEnd = number;
+    fException = nullptr;
+    ++fGeneration;
+  }
+  else
+  {
+    // the events before this one are no longer needed
+    fBegin = number;
+  }
+
+  fCondition.notify_all();
+  fCondition.wait(lock, [this, number] { return fEnd > number || fException; });
+
+  if(fException) rethrow_exception(fException);
+
+  fEvent = &fEvents[number % fEvents.size()];
+  fParticle = 0;
+  fLast = 0;
+
+  return fEvent->fEntries.size();
+}
+
+//------------------------------------------------------------------------------
+
+Bool_t DelphesPileUpPrefetcher::ReadEntry(Int_t entry)
+{
+  if(!fEvent || entry >= Int_t(fEvent->fEntries.size())) return kFALSE;
+
+  fParticle = fEvent->fFirst[entry];
+  fLast = fEvent->fFirst[entry + 1];
+  fCharged = fEvent->fCharged[entry];
+  fSumPT2 = fEvent->fSumPT2[entry];
+
+  return kTRUE;
+}
+
+//------------------------------------------------------------------------------
+
+Bool_t DelphesPileUpPrefetcher::ReadParticle(Int_t &pid, Int_t &charge, Float_t &mass,
+  Float_t &x, Float_t &y, Float_t &z, Float_t &t,
+  Float_t &px, Float_t &py, Float_t &pz, Float_t &e)
+{
+  if(fParticle >= fLast) return kFALSE;
+
+  const Particle &particle = fEvent->fParticles[fParticle];
+
+  pid = particle.fPID;
+  charge = particle.fCharge;
+  mass = particle.fMass;
+  x = particle.fValues[0];
+  y = particle.fValues[1];
+  z = particle.fValues[2];
+  t = particle.fValues[3];
+  px = particle.fValues[4];
+  py = particle.fValues[5];
+  pz = particle.fValues[6];
+  e = particle.fValues[7];
+
+  ++fParticle;
+
+  return kTRUE;
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesPileUpPrefetcher::Loop()
+{
+  unique_lock<mutex> lock(fMutex);
+  ULong64_t number;
+  Long64_t generation;
+  UInt_t seed, stream;
+
+  while(kTRUE)
+  {
+    fCondition.wait(lock, [this] {
+      return fStop || (fGeneration > 0 && !fException && fEnd < fBegin + fEvents.size());
+    });
+
+    if(fStop) return;
+
+    number = fEnd;
+    generation = fGeneration;
+    seed = fSeed;
+    stream = fStream;
+
+    // the slot of this event is not read until the event is published
+    Event &event = fEvents[number % fEvents.size()];
+
+    lock.unlock();
+
+    try
+    {
+      Read(event, seed, stream, number);
+      lock.lock();
+    }
+    catch(...)
+    {
+      lock.lock();
+      if(generation == fGeneration) fException = current_exception();
+      fCondition.notify_all();
+      continue;
+    }
+
+    // a restart while the event was read makes it useless
+    if(generation == fGeneration)
+    {
+      fEnd = number + 1;
+      fCondition.notify_all();
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesPileUpPrefetcher::Read(Event &event, UInt_t seed, UInt_t stream, ULong64_t number)
+{
+  DelphesRandom random(seed, stream);
+  vector<Long64_t>::const_iterator itEntries;
+  Particle particle;
+  Int_t charged;
+  Double_t sumPT2;
+
+  random.SetEvent(number);
+
+  event.fEntries.clear();
+  event.fFirst.clear();
+  event.fCharged.clear();
+  event.fSumPT2.clear();
+  event.fParticles.clear();
+
+  fDraw(&random, event.fEntries);
+
+  for(itEntries = event.fEntries.begin(); itEntries != event.fEntries.end(); ++itEntries)
+  {
+    fReader->ReadEntry(*itEntries);
+
+    charged = fReader->HasParticleData() ? fReader->GetEntryCharged() : 0;
+    sumPT2 = fReader->HasParticleData() ? fReader->GetEntrySumPT2() : 0.0;
+
+    event.fFirst.push_back(event.fParticles.size());
+    event.fCharged.push_back(charged);
+    event.fSumPT2.push_back(sumPT2);
+
+    particle.fCharge = 0;
+    particle.fMass = 0.0;
+
+    while(fReader->ReadParticle(particle.fPID, particle.fCharge, particle.fMass,
+      particle.fValues[0], particle.fValues[1], particle.fValues[2], particle.fValues[3],
+      particle.fValues[4], particle.fValues[5], particle.fValues[6], particle.fValues[7]))
+    {
+      event.fParticles.push_back(particle);
+    }
+  }
+
+  event.fFirst.push_back(event.fParticles.size());
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,129 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DelphesPileUpPrefetcher_h
+#define DelphesPileUpPrefetcher_h
+
+/** \class DelphesPileUpPrefetcher
+ *
+ *  Reads the pile-up of the next events in a background thread.
+ *
+ *  The entries of the pile-up events overlaid on an event are drawn by
+ *  a function of the module from a random stream positioned at the
+ *  event number, so the thread can draw them for the following events
+ *  in advance. Their particles are decoded into a ring buffer holding
+ *  the given number of events.
+ *
+ *  Events are expected in increasing order. Any other request, or a
+ *  change of the random key, discards the buffer and restarts reading
+ *  from the requested event.
+ *
+ *  The thread is started by the first request, so that a process
+ *  forked after the initialization of the module runs its own thread.
+ *
+ */
+
+#include "Rtypes.h"
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class TRandom;
+class DelphesPileUpReader;
+
+class DelphesPileUpPrefetcher
+{
+public:
+  // draws the entries of the pile-up events overlaid on one event
+  typedef std::function<void(TRandom *random, std::vector<Long64_t> &entries)> DrawFunction;
+
+  DelphesPileUpPrefetcher(DelphesPileUpReader *reader, DrawFunction draw, Int_t size);
+  ~DelphesPileUpPrefetcher();
+
+  // wait for the pile-up of an event and select it,
+  // returns the number of pile-up events
+  Int_t SelectEvent(UInt_t seed, UInt_t stream, ULong64_t event);
+
+  // same interface as DelphesPileUpReader for the pile-up events of the selected event
+
+  Bool_t ReadEntry(Int_t entry);
+
+  Bool_t ReadParticle(Int_t &pid, Int_t &charge, Float_t &mass,
+    Float_t &x, Float_t &y, Float_t &z, Float_t &t,
+    Float_t &px, Float_t &py, Float_t &pz, Float_t &e);
+
+  Int_t GetEntryCharged() const { return fCharged; }
+  Double_t GetEntrySumPT2() const { return fSumPT2; }
+
+private:
+  struct Particle
+  {
+    Int_t fPID;
+    Int_t fCharge;
+    Float_t fMass;
+    Float_t fValues[8];
+  };
+
+  struct Event
+  {
+    std::vector<Long64_t> fEntries;
+    std::vector<Long64_t> fFirst;
+    std::vector<Int_t> fCharged;
+    std::vector<Double_t> fSumPT2;
+    std::vector<Particle> fParticles;
+  };
+
+  void Loop();
+  void Read(Event &event, UInt_t seed, UInt_t stream, ULong64_t number);
+
+  DelphesPileUpReader *fReader;
+  DrawFunction fDraw;
+
+  std::vector<Event> fEvents;
+
+  // key of the random stream of the buffered events
+  UInt_t fSeed;
+  UInt_t fStream;
+
+  // buffered events are in [fBegin, fEnd), events up to fBegin + size can be read
+  ULong64_t fBegin;
+  ULong64_t fEnd;
+  Long64_t fGeneration;
+
+  Bool_t fStarted;
+  Bool_t fStop;
+
+  std::mutex fMutex;
+  std::condition_variable fCondition;
+  std::thread fThread;
+
+  std::exception_ptr fException;
+
+  // selected event and pile-up event
+  const Event *fEvent;
+  Long64_t fParticle;
+  Long64_t fLast;
+  Int_t fCharged;
+  Double_t fSumPT2;
+};
+
+#endif /* DelphesPileUpPrefetcher_h */
@@ -30,70 +30,175 @@
 #include <sstream>
 #include <stdexcept>
 
+#include <fcntl.h>
 #include <stdint.h>
-#include <stdio.h>
-
-#include "classes/DelphesXDRReader.h"
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 using namespace std;
 
-static const int kIndexSize = 10000000;
-static const int kBufferSize = 1000000;
 static const int kRecordSize = 9;
 
+const char *const DelphesPileUpReader::kSharedMagic = "DelphesPileUpShm";
+
+//------------------------------------------------------------------------------
+
+// the file is written in XDR format, with big-endian values
+
+static inline uint32_t DecodeValue(uint32_t value)
+{
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  return __builtin_bswap32(value);
+#else
+  return value;
+#endif
+}
+
+//------------------------------------------------------------------------------
+
+static inline int64_t DecodeOffset(const uint8_t *data)
+{
+  uint64_t value;
+  memcpy(&value, data, 8);
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  return __builtin_bswap64(value);
+#else
+  return value;
+#endif
+}
+
 //------------------------------------------------------------------------------
 
 DelphesPileUpReader::DelphesPileUpReader(const char *fileName) :
-  fEntries(0), fEntrySize(0), fCounter(0),
-  fPileUpFile(0), fIndex(0), fBuffer(0),
-  fInputReader(0), fIndexReader(0), fBufferReader(0)
+  fEntries(0), fEntrySize(0), fCounter(0), fFileSize(0),
+  fShared(false), fVersion(1), fFlags(0), fCharged(0), fSumPT2(0.0),
+  fData(0), fIndex(0), fRecord(0)
 {
   stringstream message;
+  struct stat status;
+  const SharedHeader *header;
+  const DelphesPileUpFormat::Header *fileHeader;
+  DelphesPileUpFormat::Trailer trailer;
+  const int64_t *index;
+  void *data;
+  int file;
 
-  fIndex = new uint8_t[kIndexSize * 8];
-  fBuffer = new uint8_t[kBufferSize * kRecordSize * 4];
-  fInputReader = new DelphesXDRReader;
-  fIndexReader = new DelphesXDRReader;
-  fBufferReader = new DelphesXDRReader;
+  fShared = strncmp(fileName, "shm:", 4) == 0;
 
-  fIndexReader->SetBuffer(fIndex);
-  fBufferReader->SetBuffer(fBuffer);
-
-  fPileUpFile = fopen(fileName, "rb");
+  if(fShared)
+  {
+    file = shm_open(fileName + 4, O_RDONLY, 0);
+  }
+  else
+  {
+    file = open(fileName, O_RDONLY);
+  }
 
-  if(fPileUpFile == NULL)
+  if(file < 0)
   {
     message << "can't open pile-up file " << fileName;
     throw runtime_error(message.str());
   }
 
-  fInputReader->SetFile(fPileUpFile);
+  if(fstat(file, &status) < 0 || status.st_size < 8)
+  {
+    close(file);
+    message << "can't read pile-up file " << fileName;
+    throw runtime_error(message.str());
+  }
+
+  fFileSize = status.st_size;
+
+  data = mmap(0, fFileSize, PROT_READ, MAP_SHARED, file, 0);
+  close(file);
+
+  if(data == MAP_FAILED)
+  {
+    message << "can't map pile-up file " << fileName;
+    throw runtime_error(message.str());
+  }
+
+  fData = static_cast<const uint8_t *>(data);
+
+  if(fShared)
+  {
+    header = static_cast<const SharedHeader *>(data);
+    index = reinterpret_cast<const int64_t *>(header + 1);
+
+    if(fFileSize < sizeof(SharedHeader) || memcmp(header->fMagic, kSharedMagic, sizeof(header->fMagic)) != 0)
+    {
+      munmap(data, fFileSize);
+      message << "pile-up library " << fileName << " is not ready";
+      throw runtime_error(message.str());
+    }
+
+    fEntries = header->fEntries;
+
+    if(fEntries < 0 || header->fParticles < 0
+      || sizeof(SharedHeader) + 8 * (fEntries + 1) + sizeof(SharedParticle) * header->fParticles != fFileSize
+      || index[fEntries] != header->fParticles)
+    {
+      munmap(data, fFileSize);
+      message << "corrupted pile-up library " << fileName;
+      throw runtime_error(message.str());
+    }
+
+    fIndex = reinterpret_cast<const uint8_t *>(index);
+    return;
+  }
+
+  fileHeader = static_cast<const DelphesPileUpFormat::Header *>(data);
+
+  if(fFileSize >= sizeof(DelphesPileUpFormat::Header) + sizeof(DelphesPileUpFormat::Trailer)
+    && DelphesPileUpFormat::HasMagic(*fileHeader))
+  {
+    if(fileHeader->fByteOrder != DelphesPileUpFormat::kByteOrder || fileHeader->fVersion != DelphesPileUpFormat::kVersion)
+    {
+      munmap(data, fFileSize);
+      message << "unsupported version or byte order of pile-up file " << fileName;
+      throw runtime_error(message.str());
+    }
+
+    fVersion = fileHeader->fVersion;
+    fFlags = fileHeader->fFlags;
+
+    // read position of the table of events and number of events
+    memcpy(&trailer, fData + fFileSize - sizeof(trailer), sizeof(trailer));
+    fEntries = trailer.fEntries;
+
+    if(fEntries < 0 || trailer.fEvents < int64_t(sizeof(DelphesPileUpFormat::Header))
+      || trailer.fEvents + fEntries * sizeof(DelphesPileUpFormat::Event) + sizeof(trailer) != fFileSize)
+    {
+      munmap(data, fFileSize);
+      message << "corrupted index in pile-up file " << fileName;
+      throw runtime_error(message.str());
+    }
+
+    fIndex = fData + trailer.fEvents;
+    return;
+  }
 
   // read number of events
-  fseeko(fPileUpFile, -8, SEEK_END);
-  fInputReader->ReadValue(&fEntries, 8);
+  fEntries = DecodeOffset(fData + fFileSize - 8);
 
-  if(fEntries >= kIndexSize)
+  if(fEntries < 0 || fEntries > int64_t((fFileSize - 8) / 8))
   {
-    message << "too many events in pile-up file " << fileName;
+    munmap(data, fFileSize);
+    message << "corrupted index in pile-up file " << fileName;
     throw runtime_error(message.str());
   }
 
-  // read index of events
-  fseeko(fPileUpFile, -8 - 8 * fEntries, SEEK_END);
-  fInputReader->ReadRaw(fIndex, fEntries * 8);
+  // index of events
+  fIndex = fData + fFileSize - 8 - 8 * fEntries;
 }
 
 //------------------------------------------------------------------------------
 
 DelphesPileUpReader::~DelphesPileUpReader()
 {
-  if(fPileUpFile) fclose(fPileUpFile);
-  if(fBufferReader) delete fBufferReader;
-  if(fIndexReader) delete fIndexReader;
-  if(fInputReader) delete fInputReader;
-  if(fBuffer) delete[] fBuffer;
-  if(fIndex) delete[] fIndex;
+  if(fData) munmap(const_cast<uint8_t *>(fData), fFileSize);
 }
 
 //------------------------------------------------------------------------------
@@ -102,18 +207,63 @@ bool DelphesPileUpReader::ReadParticle(int32_t &pid,
   float &x, float &y, float &z, float &t,
   float &px, float &py, float &pz, float &e)
 {
+  uint32_t record[kRecordSize];
+  int i;
+
   if(fCounter >= fEntrySize) return false;
 
-  fBufferReader->ReadValue(&pid, 4);
-  fBufferReader->ReadValue(&x, 4);
-  fBufferReader->ReadValue(&y, 4);
-  fBufferReader->ReadValue(&z, 4);
-  fBufferReader->ReadValue(&t, 4);
-  fBufferReader->ReadValue(&px, 4);
-  fBufferReader->ReadValue(&py, 4);
-  fBufferReader->ReadValue(&pz, 4);
-  fBufferReader->ReadValue(&e, 4);
+  if(fVersion == 2)
+  {
+    pid = reinterpret_cast<const int32_t *>(fColumns[DelphesPileUpFormat::kPID])[fCounter];
+    x = ReadColumn(DelphesPileUpFormat::kX);
+    y = ReadColumn(DelphesPileUpFormat::kY);
+    z = ReadColumn(DelphesPileUpFormat::kZ);
+    t = ReadColumn(DelphesPileUpFormat::kT);
+    px = ReadColumn(DelphesPileUpFormat::kPx);
+    py = ReadColumn(DelphesPileUpFormat::kPy);
+    pz = ReadColumn(DelphesPileUpFormat::kPz);
+    e = ReadColumn(DelphesPileUpFormat::kE);
+
+    ++fCounter;
+
+    return true;
+  }
+
+  if(fShared)
+  {
+    const SharedParticle *particle = reinterpret_cast<const SharedParticle *>(fRecord);
+
+    pid = particle->pid;
+    x = particle->x;
+    y = particle->y;
+    z = particle->z;
+    t = particle->t;
+    px = particle->px;
+    py = particle->py;
+    pz = particle->pz;
+    e = particle->e;
+
+    fRecord += sizeof(SharedParticle);
+    ++fCounter;
+
+    return true;
+  }
 
+  // decode the whole record at once
+  memcpy(record, fRecord, kRecordSize * 4);
+  for(i = 0; i < kRecordSize; ++i) record[i] = DecodeValue(record[i]);
+
+  memcpy(&pid, &record[0], 4);
+  memcpy(&x, &record[1], 4);
+  memcpy(&y, &record[2], 4);
+  memcpy(&z, &record[3], 4);
+  memcpy(&t, &record[4], 4);
+  memcpy(&px, &record[5], 4);
+  memcpy(&py, &record[6], 4);
+  memcpy(&pz, &record[7], 4);
+  memcpy(&e, &record[8], 4);
+
+  fRecord += kRecordSize * 4;
   ++fCounter;
 
   return true;
@@ -121,27 +271,117 @@ bool DelphesPileUpReader::ReadParticle(int32_t &pid,
 
 //------------------------------------------------------------------------------
 
+bool DelphesPileUpReader::ReadParticle(int32_t &pid, int32_t &charge, float &mass,
+  float &x, float &y, float &z, float &t,
+  float &px, float &py, float &pz, float &e)
+{
+  if(fVersion == 2 && fCounter < fEntrySize)
+  {
+    charge = reinterpret_cast<const int16_t *>(fColumns[DelphesPileUpFormat::kCharge])[fCounter];
+    mass = reinterpret_cast<const float *>(fColumns[DelphesPileUpFormat::kMass])[fCounter];
+  }
+
+  return ReadParticle(pid, x, y, z, t, px, py, pz, e);
+}
+
+//------------------------------------------------------------------------------
+
+float DelphesPileUpReader::ReadColumn(int column) const
+{
+  uint16_t half;
+
+  if(DelphesPileUpFormat::GetWidth(column, fFlags) == 4)
+  {
+    return reinterpret_cast<const float *>(fColumns[column])[fCounter];
+  }
+
+  half = reinterpret_cast<const uint16_t *>(fColumns[column])[fCounter];
+  return DelphesPileUpFormat::HalfToFloat(half);
+}
+
+//------------------------------------------------------------------------------
+
 bool DelphesPileUpReader::ReadEntry(int64_t entry)
 {
-  int64_t offset;
+  const DelphesPileUpFormat::Event *event;
+  const DelphesPileUpFormat::Block *block;
+  size_t offsets[DelphesPileUpFormat::kNumberOfColumns];
+  int64_t offset, end;
+  uint32_t size;
+  int column;
 
   if(entry >= fEntries) return false;
 
+  if(fVersion == 2)
+  {
+    event = reinterpret_cast<const DelphesPileUpFormat::Event *>(fIndex) + entry;
+
+    fEntrySize = event->fSize;
+    fCharged = event->fCharged;
+    fSumPT2 = event->fSumPT2;
+    fCounter = 0;
+
+    if(fEntrySize == 0) return true;
+
+    end = fIndex - fData;
+    offset = event->fBlock;
+
+    if(offset < int64_t(sizeof(DelphesPileUpFormat::Header)) || offset + int64_t(sizeof(DelphesPileUpFormat::Block)) > end)
+    {
+      throw runtime_error("corrupted index in pile-up file");
+    }
+
+    block = reinterpret_cast<const DelphesPileUpFormat::Block *>(fData + offset);
+
+    if(fEntrySize < 0 || event->fFirst < 0 || event->fFirst + int64_t(fEntrySize) > block->fParticles
+      || offset + int64_t(DelphesPileUpFormat::GetColumns(block->fParticles, fFlags, offsets)) > end)
+    {
+      throw runtime_error("corrupted block in pile-up file");
+    }
+
+    for(column = 0; column < DelphesPileUpFormat::kNumberOfColumns; ++column)
+    {
+      fColumns[column] = fData + offset + offsets[column] + event->fFirst * DelphesPileUpFormat::GetWidth(column, fFlags);
+    }
+
+    return true;
+  }
+
+  if(fShared)
+  {
+    const int64_t *index = reinterpret_cast<const int64_t *>(fIndex);
+
+    if(index[entry] < 0 || index[entry] > index[entry + 1] || index[entry + 1] > index[fEntries])
+    {
+      throw runtime_error("corrupted index in pile-up library");
+    }
+
+    fEntrySize = index[entry + 1] - index[entry];
+    fRecord = fIndex + 8 * (fEntries + 1) + sizeof(SharedParticle) * index[entry];
+    fCounter = 0;
+
+    return true;
+  }
+
   // read event position
-  fIndexReader->SetOffset(8 * entry);
-  fIndexReader->ReadValue(&offset, 8);
+  offset = DecodeOffset(fIndex + 8 * entry);
+  end = fIndex - fData;
+
+  if(offset < 0 || offset + 4 > end)
+  {
+    throw runtime_error("corrupted index in pile-up file");
+  }
 
   // read event
-  fseeko(fPileUpFile, offset, SEEK_SET);
-  fInputReader->ReadValue(&fEntrySize, 4);
+  memcpy(&size, fData + offset, 4);
+  fEntrySize = DecodeValue(size);
 
-  if(fEntrySize >= kBufferSize)
+  if(fEntrySize < 0 || fEntrySize > (end - offset - 4) / (kRecordSize * 4))
   {
     throw runtime_error("too many particles in pile-up event");
   }
 
-  fInputReader->ReadRaw(fBuffer, fEntrySize * kRecordSize * 4);
-  fBufferReader->SetOffset(0);
+  fRecord = fData + offset + 4;
   fCounter = 0;
 
   return true;
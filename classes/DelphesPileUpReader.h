@@ -23,18 +23,50 @@
  *
  *  Reads pile-up binary file
  *
+ *  The file is mapped in memory and the events are read directly
+ *  from the mapping, so the pages of a pile-up file are shared by
+ *  all the processes reading it on the same machine.
+ *
+ *  A file name starting with "shm:" designates a pile-up library
+ *  loaded in POSIX shared memory by pileup2shm, where the particles
+ *  are stored with the native layout and are read without decoding.
+ *
+ *  Files of version 2, described in DelphesPileUpFormat, are detected
+ *  from their header. They also give the charge and the mass of the
+ *  particles and a summary of each event.
+ *
  *  \author P. Demin - UCL, Louvain-la-Neuve
  *
  */
 
+#include <stddef.h>
 #include <stdint.h>
-#include <stdio.h>
 
-class DelphesXDRReader;
+#include "classes/DelphesPileUpFormat.h"
 
 class DelphesPileUpReader
 {
 public:
+  // layout of a pile-up library in shared memory: the header, the index
+  // of the first particle of each event followed by the total number of
+  // particles, and the particles
+  struct SharedHeader
+  {
+    char fMagic[16];
+    int64_t fEntries;
+    int64_t fParticles;
+  };
+
+  struct SharedParticle
+  {
+    int32_t pid;
+    float x, y, z, t;
+    float px, py, pz, e;
+  };
+
+  // written by pileup2shm once the library is complete
+  static const char *const kSharedMagic;
+
   DelphesPileUpReader(const char *fileName);
 
   ~DelphesPileUpReader();
@@ -43,23 +75,51 @@ public:
     float &x, float &y, float &z, float &t,
     float &px, float &py, float &pz, float &e);
 
+  // charge and mass are only read when HasParticleData is true
+  bool ReadParticle(int32_t &pid, int32_t &charge, float &mass,
+    float &x, float &y, float &z, float &t,
+    float &px, float &py, float &pz, float &e);
+
   bool ReadEntry(int64_t entry);
 
   int64_t GetEntries() const { return fEntries; }
 
+  // number of particles in the entry read by ReadEntry
+  int32_t GetEntrySize() const { return fEntrySize; }
+
+  int GetVersion() const { return fVersion; }
+
+  // charge and mass of the particles and summaries of the entries are stored
+  bool HasParticleData() const { return fVersion >= 2; }
+
+  // number of charged particles in the entry read by ReadEntry
+  // and sum of their squared transverse momenta
+  int32_t GetEntryCharged() const { return fCharged; }
+  double GetEntrySumPT2() const { return fSumPT2; }
+
 private:
   int64_t fEntries;
 
   int32_t fEntrySize;
   int32_t fCounter;
 
-  FILE *fPileUpFile;
-  uint8_t *fIndex;
-  uint8_t *fBuffer;
+  size_t fFileSize;
+
+  bool fShared;
+  int fVersion;
+  uint32_t fFlags;
+
+  int32_t fCharged;
+  double fSumPT2;
+
+  const uint8_t *fData;
+  const uint8_t *fIndex;
+  const uint8_t *fRecord;
+
+  // columns of the entry read by ReadEntry in a file of version 2
+  const uint8_t *fColumns[DelphesPileUpFormat::kNumberOfColumns];
 
-  DelphesXDRReader *fInputReader;
-  DelphesXDRReader *fIndexReader;
-  DelphesXDRReader *fBufferReader;
+  float ReadColumn(int column) const;
 };
 
 #endif // DelphesPileUpReader_h
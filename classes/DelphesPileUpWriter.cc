@@ -41,23 +41,48 @@ static const int kIndexSize = 10000000;
 static const int kBufferSize = 1000000;
 static const int kRecordSize = 9;
 
+// events are added to a block of version 2 until it holds this number of particles
+static const int kBlockSize = 65536;
+
 //------------------------------------------------------------------------------
 
-DelphesPileUpWriter::DelphesPileUpWriter(const char *fileName) :
+static void WriteData(FILE *file, const void *data, size_t size)
+{
+  if(size > 0 && fwrite(data, 1, size, file) != size)
+  {
+    throw runtime_error("can't write pile-up file");
+  }
+}
+
+//------------------------------------------------------------------------------
+
+DelphesPileUpWriter::DelphesPileUpWriter(const char *fileName, int version, uint32_t flags) :
+  fVersion(version), fFlags(flags),
   fEntries(0), fEntrySize(0), fOffset(0),
   fPileUpFile(0), fIndex(0), fBuffer(0),
-  fOutputWriter(0), fIndexWriter(0), fBufferWriter(0)
+  fOutputWriter(0), fIndexWriter(0), fBufferWriter(0),
+  fCharged(0), fSumPT2(0.0)
 {
   stringstream message;
+  DelphesPileUpFormat::Header header;
 
-  fIndex = new uint8_t[kIndexSize * 8];
-  fBuffer = new uint8_t[kBufferSize * kRecordSize * 4];
-  fOutputWriter = new DelphesXDRWriter;
-  fIndexWriter = new DelphesXDRWriter;
-  fBufferWriter = new DelphesXDRWriter;
+  if(fVersion != 1 && fVersion != 2)
+  {
+    message << "unknown version " << fVersion << " of pile-up file";
+    throw runtime_error(message.str());
+  }
+
+  if(fVersion == 1)
+  {
+    fIndex = new uint8_t[kIndexSize * 8];
+    fBuffer = new uint8_t[kBufferSize * kRecordSize * 4];
+    fOutputWriter = new DelphesXDRWriter;
+    fIndexWriter = new DelphesXDRWriter;
+    fBufferWriter = new DelphesXDRWriter;
 
-  fIndexWriter->SetBuffer(fIndex);
-  fBufferWriter->SetBuffer(fBuffer);
+    fIndexWriter->SetBuffer(fIndex);
+    fBufferWriter->SetBuffer(fBuffer);
+  }
 
   fPileUpFile = fopen(fileName, "wb");
 
@@ -67,7 +92,20 @@ DelphesPileUpWriter::DelphesPileUpWriter(const char *fileName) :
     throw runtime_error(message.str());
   }
 
-  fOutputWriter->SetFile(fPileUpFile);
+  if(fVersion == 1)
+  {
+    fOutputWriter->SetFile(fPileUpFile);
+    return;
+  }
+
+  memset(&header, 0, sizeof(header));
+  DelphesPileUpFormat::SetMagic(header);
+  header.fByteOrder = DelphesPileUpFormat::kByteOrder;
+  header.fVersion = DelphesPileUpFormat::kVersion;
+  header.fFlags = fFlags;
+
+  WriteData(fPileUpFile, &header, sizeof(header));
+  fOffset = sizeof(header);
 }
 
 //------------------------------------------------------------------------------
@@ -88,6 +126,11 @@ void DelphesPileUpWriter::WriteParticle(int32_t pid,
   float x, float y, float z, float t,
   float px, float py, float pz, float e)
 {
+  if(fVersion == 2)
+  {
+    throw runtime_error("pile-up files of version 2 need the charge and the mass of the particles");
+  }
+
   if(fEntrySize >= kBufferSize)
   {
     throw runtime_error("too many particles in pile-up event");
@@ -108,8 +151,65 @@ void DelphesPileUpWriter::WriteParticle(int32_t pid,
 
 //------------------------------------------------------------------------------
 
+void DelphesPileUpWriter::WriteParticle(int32_t pid, int32_t charge, float mass,
+  float x, float y, float z, float t,
+  float px, float py, float pz, float e)
+{
+  if(fVersion == 1)
+  {
+    WriteParticle(pid, x, y, z, t, px, py, pz, e);
+    return;
+  }
+
+  fPID.push_back(pid);
+  fCharge.push_back(charge);
+  fColumns[DelphesPileUpFormat::kMass].push_back(mass);
+  fColumns[DelphesPileUpFormat::kX].push_back(x);
+  fColumns[DelphesPileUpFormat::kY].push_back(y);
+  fColumns[DelphesPileUpFormat::kZ].push_back(z);
+  fColumns[DelphesPileUpFormat::kT].push_back(t);
+  fColumns[DelphesPileUpFormat::kPx].push_back(px);
+  fColumns[DelphesPileUpFormat::kPy].push_back(py);
+  fColumns[DelphesPileUpFormat::kPz].push_back(pz);
+  fColumns[DelphesPileUpFormat::kE].push_back(e);
+
+  // same selection of charged particles as in PileUpMerger
+  if(charge != 0)
+  {
+    ++fCharged;
+    fSumPT2 += double(px) * px + double(py) * py;
+  }
+
+  ++fEntrySize;
+}
+
+//------------------------------------------------------------------------------
+
 void DelphesPileUpWriter::WriteEntry()
 {
+  DelphesPileUpFormat::Event event;
+
+  if(fVersion == 2)
+  {
+    memset(&event, 0, sizeof(event));
+    event.fBlock = fOffset;
+    event.fFirst = fPID.size() - fEntrySize;
+    event.fSize = fEntrySize;
+    event.fCharged = fCharged;
+    event.fSumPT2 = fSumPT2;
+    fEvents.push_back(event);
+
+    fEntrySize = 0;
+    fCharged = 0;
+    fSumPT2 = 0.0;
+
+    ++fEntries;
+
+    if(fPID.size() >= size_t(kBlockSize)) WriteBlock();
+
+    return;
+  }
+
   if(fEntries >= kIndexSize)
   {
     throw runtime_error("too many pile-up events");
@@ -129,8 +229,85 @@ void DelphesPileUpWriter::WriteEntry()
 
 //------------------------------------------------------------------------------
 
+void DelphesPileUpWriter::WriteBlock()
+{
+  DelphesPileUpFormat::Block block;
+  size_t offsets[DelphesPileUpFormat::kNumberOfColumns];
+  vector<uint16_t> halves;
+  vector<uint8_t> padding(8, 0);
+  size_t size, particles, written, end, i;
+  int column;
+
+  particles = fPID.size();
+  if(particles == 0) return;
+
+  size = DelphesPileUpFormat::GetColumns(particles, fFlags, offsets);
+
+  memset(&block, 0, sizeof(block));
+  block.fParticles = particles;
+  WriteData(fPileUpFile, &block, sizeof(block));
+
+  for(column = 0; column < DelphesPileUpFormat::kNumberOfColumns; ++column)
+  {
+    written = particles * DelphesPileUpFormat::GetWidth(column, fFlags);
+
+    if(column == DelphesPileUpFormat::kPID)
+    {
+      WriteData(fPileUpFile, &fPID[0], written);
+    }
+    else if(column == DelphesPileUpFormat::kCharge)
+    {
+      WriteData(fPileUpFile, &fCharge[0], written);
+    }
+    else if(DelphesPileUpFormat::GetWidth(column, fFlags) == 2)
+    {
+      halves.resize(particles);
+      for(i = 0; i < particles; ++i)
+      {
+        halves[i] = DelphesPileUpFormat::FloatToHalf(fColumns[column][i]);
+      }
+      WriteData(fPileUpFile, &halves[0], written);
+    }
+    else
+    {
+      WriteData(fPileUpFile, &fColumns[column][0], written);
+    }
+
+    // pad the column to a multiple of 8 bytes
+    end = (column + 1 < DelphesPileUpFormat::kNumberOfColumns) ? offsets[column + 1] : size;
+    WriteData(fPileUpFile, &padding[0], end - offsets[column] - written);
+  }
+
+  fOffset += size;
+
+  fPID.clear();
+  fCharge.clear();
+  for(column = 0; column < DelphesPileUpFormat::kNumberOfColumns; ++column)
+  {
+    fColumns[column].clear();
+  }
+}
+
+//------------------------------------------------------------------------------
+
 void DelphesPileUpWriter::WriteIndex()
 {
+  DelphesPileUpFormat::Trailer trailer;
+
+  if(fVersion == 2)
+  {
+    WriteBlock();
+
+    trailer.fEvents = fOffset;
+    trailer.fEntries = fEntries;
+
+    WriteData(fPileUpFile, fEvents.empty() ? 0 : &fEvents[0], fEvents.size() * sizeof(DelphesPileUpFormat::Event));
+    WriteData(fPileUpFile, &trailer, sizeof(trailer));
+
+    fOffset += fEvents.size() * sizeof(DelphesPileUpFormat::Event) + sizeof(trailer);
+    return;
+  }
+
   fOutputWriter->WriteRaw(fIndex, fEntries * 8);
   fOutputWriter->WriteValue(&fEntries, 8);
 }
@@ -23,6 +23,9 @@
  *
  *  Writes pile-up binary file
  *
+ *  Version 1 files store XDR records, version 2 files store blocks of
+ *  columns described in DelphesPileUpFormat.
+ *
  *  \author P. Demin - UCL, Louvain-la-Neuve
  *
  */
@@ -30,24 +33,39 @@
 #include <stdint.h>
 #include <stdio.h>
 
+#include <vector>
+
+#include "classes/DelphesPileUpFormat.h"
+
 class DelphesXDRWriter;
 
 class DelphesPileUpWriter
 {
 public:
-  DelphesPileUpWriter(const char *fileName);
+  // flags are those of DelphesPileUpFormat and are used by version 2 only
+  DelphesPileUpWriter(const char *fileName, int version = 1, uint32_t flags = 0);
 
   ~DelphesPileUpWriter();
 
+  // version 2 files also need the charge and the mass of the particles
   void WriteParticle(int32_t pid,
     float x, float y, float z, float t,
     float px, float py, float pz, float e);
 
+  void WriteParticle(int32_t pid, int32_t charge, float mass,
+    float x, float y, float z, float t,
+    float px, float py, float pz, float e);
+
   void WriteEntry();
 
   void WriteIndex();
 
 private:
+  void WriteBlock();
+
+  int fVersion;
+  uint32_t fFlags;
+
   int64_t fEntries;
   int32_t fEntrySize;
   int64_t fOffset;
@@ -59,6 +77,17 @@ private:
   DelphesXDRWriter *fOutputWriter;
   DelphesXDRWriter *fIndexWriter;
   DelphesXDRWriter *fBufferWriter;
+
+  // version 2: columns of the current block and table of events
+
+  int32_t fCharged;
+  double fSumPT2;
+
+  std::vector<int32_t> fPID;
+  std::vector<int16_t> fCharge;
+  std::vector<float> fColumns[DelphesPileUpFormat::kNumberOfColumns];
+
+  std::vector<DelphesPileUpFormat::Event> fEvents;
 };
 
 #endif // DelphesPileUpWriter_h
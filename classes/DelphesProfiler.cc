@@ -0,0 +1,467 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** \class DelphesProfiler
+ *
+ *  Collects the per-module timing measured by ExRootTask together with
+ *  the number of candidates in the arrays imported and exported by each
+ *  module, the objects allocated by each module from DelphesFactory and,
+ *  optionally, the hardware counters read around each Process call,
+ *  prints a summary and writes it to a JSON or ROOT file.
+ *
+ */
+
+#include "classes/DelphesProfiler.h"
+#include "classes/DelphesFactory.h"
+
+#include "ExRootAnalysis/ExRootTask.h"
+
+#include "TClass.h"
+#include "TFile.h"
+#include "TH1.h"
+#include "TObjArray.h"
+#include "TString.h"
+#include "TTree.h"
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#include <string.h>
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+
+static Double_t Ratio(Long64_t numerator, Long64_t denominator)
+{
+  return denominator > 0 ? Double_t(numerator) / denominator : 0.0;
+}
+
+//------------------------------------------------------------------------------
+
+DelphesProfiler::DelphesProfiler(DelphesFactory *factory) :
+  fFactory(factory), fNumberOfEvents(0), fCounting(kFALSE)
+{
+  fInputMemory.fObjectSum = 0.0;
+  fInputMemory.fObjectMax = 0;
+  fInputMemory.fByteSum = 0.0;
+  fInputMemory.fByteMax = 0;
+}
+
+//------------------------------------------------------------------------------
+
+DelphesProfiler::~DelphesProfiler()
+{
+}
+
+//------------------------------------------------------------------------------
+
+Int_t DelphesProfiler::AddTask(ExRootTask *task)
+{
+  TaskProfile profile;
+  profile.fTask = task;
+  profile.fInputSum = 0.0;
+  profile.fOutputSum = 0.0;
+  profile.fMemory.fObjectSum = 0.0;
+  profile.fMemory.fObjectMax = 0;
+  profile.fMemory.fByteSum = 0.0;
+  profile.fMemory.fByteMax = 0;
+  fTasks.push_back(profile);
+  return fTasks.size() - 1;
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesProfiler::AddArray(Int_t task, const char *name, TObjArray *array, Bool_t output)
+{
+  ArrayProfile profile;
+  profile.fName = name;
+  profile.fArray = array;
+  profile.fOutput = output;
+  profile.fSum = 0.0;
+  profile.fMax = 0;
+  profile.fByteSum = 0.0;
+  profile.fByteMax = 0;
+  fTasks[task].fArrays.push_back(profile);
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesProfiler::AddMemory(MemoryProfile &profile, Long64_t objects, Long64_t bytes)
+{
+  profile.fObjectSum += objects;
+  profile.fByteSum += bytes;
+  if(objects > profile.fObjectMax) profile.fObjectMax = objects;
+  if(bytes > profile.fByteMax) profile.fByteMax = bytes;
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesProfiler::ProcessEvent()
+{
+  vector<TaskProfile>::iterator itTasks;
+  vector<ArrayProfile>::iterator itArrays;
+  TObject *object;
+  Int_t entries;
+  Long64_t bytes;
+
+  // arrays are only filled by their producer, so their size at the end
+  // of the event is the number of candidates seen by every module
+  for(itTasks = fTasks.begin(); itTasks != fTasks.end(); ++itTasks)
+  {
+    for(itArrays = itTasks->fArrays.begin(); itArrays != itTasks->fArrays.end(); ++itArrays)
+    {
+      entries = itArrays->fArray->GetEntriesFast();
+      itArrays->fSum += entries;
+      if(entries > itArrays->fMax) itArrays->fMax = entries;
+      if(itArrays->fOutput)
+        itTasks->fOutputSum += entries;
+      else
+        itTasks->fInputSum += entries;
+
+      // objects held by the array plus its table of pointers
+      object = entries > 0 ? itArrays->fArray->UncheckedAt(0) : 0;
+      bytes = Long64_t(itArrays->fArray->GetSize()) * sizeof(TObject *);
+      if(object) bytes += Long64_t(entries) * object->IsA()->Size();
+      itArrays->fByteSum += bytes;
+      if(bytes > itArrays->fByteMax) itArrays->fByteMax = bytes;
+    }
+
+    AddMemory(itTasks->fMemory, fFactory->GetAllocatedObjects(itTasks->fTask),
+      fFactory->GetAllocatedBytes(itTasks->fTask));
+  }
+
+  AddMemory(fInputMemory, fFactory->GetAllocatedObjects(0), fFactory->GetAllocatedBytes(0));
+
+  ++fNumberOfEvents;
+}
+
+//------------------------------------------------------------------------------
+
+Double_t DelphesProfiler::GetQuantile(const TaskProfile &profile, Double_t probability) const
+{
+  Double_t quantile = 0.0;
+  TH1 *latency = profile.fTask->GetLatency();
+
+  if(!latency || latency->GetEntries() == 0) return 0.0;
+
+  latency->GetQuantiles(1, &quantile, &probability);
+  return quantile;
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesProfiler::Print() const
+{
+  vector<TaskProfile>::const_iterator itTasks;
+  vector<ArrayProfile>::const_iterator itArrays;
+  Double_t total = 0.0, events = fNumberOfEvents > 0 ? fNumberOfEvents : 1;
+  ExRootTask *task;
+  const MemoryProfile *memory;
+
+  for(itTasks = fTasks.begin(); itTasks != fTasks.end(); ++itTasks)
+  {
+    total += itTasks->fTask->GetWallTime();
+  }
+  if(total <= 0.0) total = 1.0;
+
+  cout << "** INFO: module profile for " << fNumberOfEvents << " events" << endl;
+  cout << left << setw(25) << "** Module" << right;
+  cout << setw(11) << "wall [s]" << setw(11) << "cpu [s]" << setw(8) << "[%]";
+  cout << setw(11) << "mean [ms]" << setw(11) << "p50 [ms]" << setw(11) << "p99 [ms]";
+  cout << setw(11) << "in/event" << setw(11) << "out/event" << endl;
+
+  for(itTasks = fTasks.begin(); itTasks != fTasks.end(); ++itTasks)
+  {
+    task = itTasks->fTask;
+    cout << left << setw(25) << TString("   ") + task->GetName() << right << fixed;
+    cout << setprecision(3) << setw(11) << task->GetWallTime() << setw(11) << task->GetCpuTime();
+    cout << setprecision(1) << setw(8) << 100.0 * task->GetWallTime() / total;
+    cout << setprecision(3) << setw(11) << 1.0e3 * task->GetWallTime() / events;
+    cout << setw(11) << 1.0e3 * GetQuantile(*itTasks, 0.5) << setw(11) << 1.0e3 * GetQuantile(*itTasks, 0.99);
+    cout << setprecision(1) << setw(11) << itTasks->fInputSum / events << setw(11) << itTasks->fOutputSum / events;
+    cout << endl;
+  }
+
+  cout << "** INFO: objects allocated per event, ";
+  cout << setprecision(1) << fFactory->GetReservedBytes() / 1024.0 << " kB reserved by the factory" << endl;
+  cout << left << setw(45) << "** Module / array" << right;
+  cout << setw(11) << "objects" << setw(11) << "peak" << setw(11) << "kB" << setw(11) << "peak kB" << endl;
+
+  cout << left << setw(45) << "   (input)" << right;
+  cout << setw(11) << fInputMemory.fObjectSum / events << setw(11) << fInputMemory.fObjectMax;
+  cout << setw(11) << fInputMemory.fByteSum / events / 1024.0 << setw(11) << fInputMemory.fByteMax / 1024.0 << endl;
+
+  for(itTasks = fTasks.begin(); itTasks != fTasks.end(); ++itTasks)
+  {
+    memory = &itTasks->fMemory;
+    cout << left << setw(45) << TString("   ") + itTasks->fTask->GetName() << right;
+    cout << setw(11) << memory->fObjectSum / events << setw(11) << memory->fObjectMax;
+    cout << setw(11) << memory->fByteSum / events / 1024.0 << setw(11) << memory->fByteMax / 1024.0 << endl;
+
+    for(itArrays = itTasks->fArrays.begin(); itArrays != itTasks->fArrays.end(); ++itArrays)
+    {
+      if(!itArrays->fOutput) continue;
+      cout << left << setw(45) << TString("     ") + itArrays->fName.c_str() << right;
+      cout << setw(11) << itArrays->fSum / events << setw(11) << itArrays->fMax;
+      cout << setw(11) << itArrays->fByteSum / events / 1024.0 << setw(11) << itArrays->fByteMax / 1024.0 << endl;
+    }
+  }
+
+  if(fCounting)
+  {
+    cout << "** INFO: hardware counters per event" << endl;
+    cout << left << setw(25) << "** Module" << right;
+    cout << setw(13) << "cycles [M]" << setw(13) << "instr [M]" << setw(8) << "IPC";
+    cout << setw(15) << "LLC miss [k]" << setw(14) << "br miss [k]" << setw(14) << "LLC/kinstr" << endl;
+
+    for(itTasks = fTasks.begin(); itTasks != fTasks.end(); ++itTasks)
+    {
+      task = itTasks->fTask;
+      cout << left << setw(25) << TString("   ") + task->GetName() << right;
+      cout << setprecision(3) << setw(13) << task->GetCounter(ExRootTask::kCycles) / events * 1.0e-6;
+      cout << setw(13) << task->GetCounter(ExRootTask::kInstructions) / events * 1.0e-6;
+      cout << setprecision(2) << setw(8) << Ratio(task->GetCounter(ExRootTask::kInstructions), task->GetCounter(ExRootTask::kCycles));
+      cout << setprecision(1) << setw(15) << task->GetCounter(ExRootTask::kCacheMisses) / events * 1.0e-3;
+      cout << setw(14) << task->GetCounter(ExRootTask::kBranchMisses) / events * 1.0e-3;
+      cout << setprecision(2) << setw(14) << 1.0e3 * Ratio(task->GetCounter(ExRootTask::kCacheMisses), task->GetCounter(ExRootTask::kInstructions));
+      cout << endl;
+    }
+  }
+
+  cout.unsetf(ios::fixed);
+  cout << setprecision(6) << left;
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesProfiler::Write(const char *fileName) const
+{
+  if(TString(fileName).EndsWith(".root"))
+  {
+    WriteTree(fileName);
+  }
+  else
+  {
+    WriteJSON(fileName);
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesProfiler::WriteJSON(const char *fileName) const
+{
+  stringstream message;
+  vector<TaskProfile>::const_iterator itTasks;
+  vector<ArrayProfile>::const_iterator itArrays;
+  Double_t events = fNumberOfEvents > 0 ? fNumberOfEvents : 1;
+  ExRootTask *task;
+  const MemoryProfile *memory;
+  Bool_t output;
+  Int_t i;
+  const char *separator;
+
+  ofstream file(fileName);
+  if(!file)
+  {
+    message << "can't open profile file '" << fileName << "'";
+    throw runtime_error(message.str());
+  }
+
+  file << "{" << endl;
+  file << "  \"events\": " << fNumberOfEvents << "," << endl;
+  file << "  \"reserved_bytes\": " << fFactory->GetReservedBytes() << "," << endl;
+  file << "  \"input_memory\": {\"objects_mean\": " << fInputMemory.fObjectSum / events;
+  file << ", \"objects_peak\": " << fInputMemory.fObjectMax;
+  file << ", \"bytes_mean\": " << fInputMemory.fByteSum / events;
+  file << ", \"bytes_peak\": " << fInputMemory.fByteMax << "}," << endl;
+  file << "  \"modules\": [" << endl;
+
+  for(itTasks = fTasks.begin(); itTasks != fTasks.end(); ++itTasks)
+  {
+    task = itTasks->fTask;
+    memory = &itTasks->fMemory;
+    file << "    {" << endl;
+    file << "      \"name\": \"" << task->GetName() << "\"," << endl;
+    file << "      \"class\": \"" << task->ClassName() << "\"," << endl;
+    file << "      \"init_time\": " << task->GetInitTime() << "," << endl;
+    file << "      \"finish_time\": " << task->GetFinishTime() << "," << endl;
+    file << "      \"wall_time\": " << task->GetWallTime() << "," << endl;
+    file << "      \"cpu_time\": " << task->GetCpuTime() << "," << endl;
+    file << "      \"latency\": {\"mean\": " << task->GetWallTime() / events;
+    file << ", \"p50\": " << GetQuantile(*itTasks, 0.5);
+    file << ", \"p90\": " << GetQuantile(*itTasks, 0.9);
+    file << ", \"p99\": " << GetQuantile(*itTasks, 0.99) << "}," << endl;
+    file << "      \"memory\": {\"objects_mean\": " << memory->fObjectSum / events;
+    file << ", \"objects_peak\": " << memory->fObjectMax;
+    file << ", \"bytes_mean\": " << memory->fByteSum / events;
+    file << ", \"bytes_peak\": " << memory->fByteMax << "}," << endl;
+    if(fCounting)
+    {
+      file << "      \"counters\": {\"cycles\": " << task->GetCounter(ExRootTask::kCycles);
+      file << ", \"instructions\": " << task->GetCounter(ExRootTask::kInstructions);
+      file << ", \"cache_misses\": " << task->GetCounter(ExRootTask::kCacheMisses);
+      file << ", \"branch_misses\": " << task->GetCounter(ExRootTask::kBranchMisses) << "}," << endl;
+    }
+
+    for(i = 0; i < 2; ++i)
+    {
+      output = (i == 1);
+      file << "      \"" << (output ? "outputs" : "inputs") << "\": [";
+      separator = "";
+      for(itArrays = itTasks->fArrays.begin(); itArrays != itTasks->fArrays.end(); ++itArrays)
+      {
+        if(itArrays->fOutput != output) continue;
+        file << separator << endl;
+        file << "        {\"array\": \"" << itArrays->fName << "\", \"mean\": " << itArrays->fSum / events;
+        file << ", \"max\": " << itArrays->fMax;
+        file << ", \"bytes_mean\": " << itArrays->fByteSum / events;
+        file << ", \"bytes_max\": " << itArrays->fByteMax << "}";
+        separator = ",";
+      }
+      file << "]" << (output ? "" : ",") << endl;
+    }
+
+    file << "    }" << (itTasks + 1 != fTasks.end() ? "," : "") << endl;
+  }
+
+  file << "  ]" << endl;
+  file << "}" << endl;
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesProfiler::WriteTree(const char *fileName) const
+{
+  stringstream message;
+  vector<TaskProfile>::const_iterator itTasks;
+  vector<ArrayProfile>::const_iterator itArrays;
+  Double_t events = fNumberOfEvents > 0 ? fNumberOfEvents : 1;
+  ExRootTask *task;
+
+  Char_t name[256], array[256];
+  Double_t initTime, finishTime, wallTime, cpuTime, latencyMean, latencyP50, latencyP99;
+  Double_t inputCandidates, outputCandidates, objectsMean, bytesMean, mean;
+  Long64_t objectsPeak, bytesPeak, bytesMax;
+  Long64_t counters[ExRootTask::kNumberOfCounters];
+  Bool_t output;
+  Int_t i, max;
+
+  TFile *file = TFile::Open(fileName, "RECREATE");
+  if(!file || file->IsZombie())
+  {
+    message << "can't open profile file '" << fileName << "'";
+    throw runtime_error(message.str());
+  }
+
+  TTree *moduleTree = new TTree("ModuleProfile", "Per-module processing time and memory");
+  moduleTree->Branch("Name", name, "Name/C");
+  moduleTree->Branch("InitTime", &initTime, "InitTime/D");
+  moduleTree->Branch("FinishTime", &finishTime, "FinishTime/D");
+  moduleTree->Branch("WallTime", &wallTime, "WallTime/D");
+  moduleTree->Branch("CpuTime", &cpuTime, "CpuTime/D");
+  moduleTree->Branch("LatencyMean", &latencyMean, "LatencyMean/D");
+  moduleTree->Branch("LatencyP50", &latencyP50, "LatencyP50/D");
+  moduleTree->Branch("LatencyP99", &latencyP99, "LatencyP99/D");
+  moduleTree->Branch("InputCandidates", &inputCandidates, "InputCandidates/D");
+  moduleTree->Branch("OutputCandidates", &outputCandidates, "OutputCandidates/D");
+  moduleTree->Branch("ObjectsMean", &objectsMean, "ObjectsMean/D");
+  moduleTree->Branch("ObjectsPeak", &objectsPeak, "ObjectsPeak/L");
+  moduleTree->Branch("BytesMean", &bytesMean, "BytesMean/D");
+  moduleTree->Branch("BytesPeak", &bytesPeak, "BytesPeak/L");
+  if(fCounting)
+  {
+    moduleTree->Branch("Cycles", &counters[ExRootTask::kCycles], "Cycles/L");
+    moduleTree->Branch("Instructions", &counters[ExRootTask::kInstructions], "Instructions/L");
+    moduleTree->Branch("CacheMisses", &counters[ExRootTask::kCacheMisses], "CacheMisses/L");
+    moduleTree->Branch("BranchMisses", &counters[ExRootTask::kBranchMisses], "BranchMisses/L");
+  }
+
+  TTree *arrayTree = new TTree("ArrayProfile", "Per-array number of candidates");
+  arrayTree->Branch("Module", name, "Module/C");
+  arrayTree->Branch("Array", array, "Array/C");
+  arrayTree->Branch("Output", &output, "Output/O");
+  arrayTree->Branch("Mean", &mean, "Mean/D");
+  arrayTree->Branch("Max", &max, "Max/I");
+  arrayTree->Branch("BytesMean", &bytesMean, "BytesMean/D");
+  arrayTree->Branch("BytesMax", &bytesMax, "BytesMax/L");
+
+  // objects allocated outside of the modules
+  strcpy(name, "(input)");
+  initTime = finishTime = wallTime = cpuTime = 0.0;
+  latencyMean = latencyP50 = latencyP99 = 0.0;
+  inputCandidates = outputCandidates = 0.0;
+  objectsMean = fInputMemory.fObjectSum / events;
+  objectsPeak = fInputMemory.fObjectMax;
+  bytesMean = fInputMemory.fByteSum / events;
+  bytesPeak = fInputMemory.fByteMax;
+  for(i = 0; i < ExRootTask::kNumberOfCounters; ++i)
+  {
+    counters[i] = 0;
+  }
+  moduleTree->Fill();
+
+  for(itTasks = fTasks.begin(); itTasks != fTasks.end(); ++itTasks)
+  {
+    task = itTasks->fTask;
+    strncpy(name, task->GetName(), sizeof(name) - 1);
+    name[sizeof(name) - 1] = 0;
+
+    initTime = task->GetInitTime();
+    finishTime = task->GetFinishTime();
+    wallTime = task->GetWallTime();
+    cpuTime = task->GetCpuTime();
+    latencyMean = wallTime / events;
+    latencyP50 = GetQuantile(*itTasks, 0.5);
+    latencyP99 = GetQuantile(*itTasks, 0.99);
+    inputCandidates = itTasks->fInputSum / events;
+    outputCandidates = itTasks->fOutputSum / events;
+    objectsMean = itTasks->fMemory.fObjectSum / events;
+    objectsPeak = itTasks->fMemory.fObjectMax;
+    bytesMean = itTasks->fMemory.fByteSum / events;
+    bytesPeak = itTasks->fMemory.fByteMax;
+    for(i = 0; i < ExRootTask::kNumberOfCounters; ++i)
+    {
+      counters[i] = task->GetCounter(i);
+    }
+    moduleTree->Fill();
+
+    for(itArrays = itTasks->fArrays.begin(); itArrays != itTasks->fArrays.end(); ++itArrays)
+    {
+      strncpy(array, itArrays->fName.c_str(), sizeof(array) - 1);
+      array[sizeof(array) - 1] = 0;
+      output = itArrays->fOutput;
+      mean = itArrays->fSum / events;
+      max = itArrays->fMax;
+      bytesMean = itArrays->fByteSum / events;
+      bytesMax = itArrays->fByteMax;
+      arrayTree->Fill();
+    }
+
+    if(task->GetLatency()) task->GetLatency()->Write();
+  }
+
+  file->Write();
+  file->Close();
+  delete file;
+}
+
+//------------------------------------------------------------------------------
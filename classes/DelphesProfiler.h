@@ -0,0 +1,107 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DelphesProfiler_h
+#define DelphesProfiler_h
+
+/** \class DelphesProfiler
+ *
+ *  Collects the per-module timing measured by ExRootTask together with
+ *  the number of candidates in the arrays imported and exported by each
+ *  module, the objects allocated by each module from DelphesFactory and,
+ *  optionally, the hardware counters read around each Process call,
+ *  prints a summary and writes it to a JSON or ROOT file.
+ *
+ */
+
+#include "Rtypes.h"
+
+#include <string>
+#include <vector>
+
+class TObjArray;
+
+class ExRootTask;
+
+class DelphesFactory;
+
+class DelphesProfiler
+{
+public:
+  DelphesProfiler(DelphesFactory *factory);
+  ~DelphesProfiler();
+
+  Int_t AddTask(ExRootTask *task);
+  void AddArray(Int_t task, const char *name, TObjArray *array, Bool_t output);
+
+  void SetCounting(Bool_t flag) { fCounting = flag; }
+
+  void ProcessEvent();
+
+  void Print() const;
+  void Write(const char *fileName) const;
+
+private:
+  struct MemoryProfile
+  {
+    Double_t fObjectSum;
+    Long64_t fObjectMax;
+    Double_t fByteSum;
+    Long64_t fByteMax;
+  };
+
+  struct ArrayProfile
+  {
+    std::string fName;
+    TObjArray *fArray;
+    Bool_t fOutput;
+    Double_t fSum;
+    Int_t fMax;
+    Double_t fByteSum;
+    Long64_t fByteMax;
+  };
+
+  struct TaskProfile
+  {
+    ExRootTask *fTask;
+    std::vector<ArrayProfile> fArrays;
+    Double_t fInputSum;
+    Double_t fOutputSum;
+    MemoryProfile fMemory;
+  };
+
+  static void AddMemory(MemoryProfile &profile, Long64_t objects, Long64_t bytes);
+
+  void WriteJSON(const char *fileName) const;
+  void WriteTree(const char *fileName) const;
+
+  Double_t GetQuantile(const TaskProfile &profile, Double_t probability) const;
+
+  DelphesFactory *fFactory;
+
+  std::vector<TaskProfile> fTasks;
+
+  // objects allocated outside of the modules, i.e. by the reader
+  MemoryProfile fInputMemory;
+
+  Long64_t fNumberOfEvents;
+
+  Bool_t fCounting;
+};
+
+#endif /* DelphesProfiler_h */
@@ -0,0 +1,154 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** \class DelphesRandom
+ *
+ *  Counter-based random number generator (Philox4x32-10).
+ *
+ *  The sequence is fully determined by the key (random seed, stream)
+ *  and by the event number, so every module draws from its own
+ *  reproducible stream independently of the event processing order.
+ *
+ */
+
+#include "classes/DelphesRandom.h"
+
+using namespace std;
+
+static const UInt_t kPhiloxM0 = 0xD2511F53;
+static const UInt_t kPhiloxM1 = 0xCD9E8D57;
+static const UInt_t kPhiloxW0 = 0x9E3779B9;
+static const UInt_t kPhiloxW1 = 0xBB67AE85;
+
+// event number used for the draws made outside of the event loop
+static const ULong64_t kInitEvent = ~0ULL;
+
+//------------------------------------------------------------------------------
+
+DelphesRandom::DelphesRandom(UInt_t seed, UInt_t stream) :
+  TRandom(seed), fPosition(4)
+{
+  SetKey(seed, stream);
+}
+
+//------------------------------------------------------------------------------
+
+DelphesRandom::~DelphesRandom()
+{
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesRandom::SetKey(UInt_t seed, UInt_t stream)
+{
+  fKey[0] = seed;
+  fKey[1] = stream;
+  SetEvent(kInitEvent);
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesRandom::SetEvent(ULong64_t event)
+{
+  fCounter[0] = 0;
+  fCounter[1] = 0;
+  fCounter[2] = UInt_t(event);
+  fCounter[3] = UInt_t(event >> 32);
+  fPosition = 4;
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesRandom::SetSeed(ULong_t seed)
+{
+  SetKey(UInt_t(seed), fKey[1]);
+}
+
+//------------------------------------------------------------------------------
+
+Double_t DelphesRandom::Rndm()
+{
+  // uniform in the open interval (0, 1)
+  return (Double_t(NextInteger()) + 0.5) * 2.3283064365386963e-10;
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesRandom::RndmArray(Int_t n, Float_t *array)
+{
+  Int_t i;
+  for(i = 0; i < n; ++i) array[i] = Float_t(Rndm());
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesRandom::RndmArray(Int_t n, Double_t *array)
+{
+  Int_t i;
+  for(i = 0; i < n; ++i) array[i] = Rndm();
+}
+
+//------------------------------------------------------------------------------
+
+UInt_t DelphesRandom::Hash(const char *name)
+{
+  // 32-bit FNV-1a hash
+  UInt_t hash = 2166136261U;
+  const char *it;
+  for(it = name; *it; ++it)
+  {
+    hash ^= UChar_t(*it);
+    hash *= 16777619U;
+  }
+  return hash;
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesRandom::Generate()
+{
+  Int_t i;
+  ULong64_t product0, product1;
+  UInt_t key0 = fKey[0], key1 = fKey[1];
+  UInt_t c0 = fCounter[0], c1 = fCounter[1], c2 = fCounter[2], c3 = fCounter[3];
+
+  for(i = 0; i < 10; ++i)
+  {
+    product0 = ULong64_t(kPhiloxM0) * c0;
+    product1 = ULong64_t(kPhiloxM1) * c2;
+
+    c0 = UInt_t(product1 >> 32) ^ c1 ^ key0;
+    c1 = UInt_t(product1);
+    c2 = UInt_t(product0 >> 32) ^ c3 ^ key1;
+    c3 = UInt_t(product0);
+
+    key0 += kPhiloxW0;
+    key1 += kPhiloxW1;
+  }
+
+  fBuffer[0] = c0;
+  fBuffer[1] = c1;
+  fBuffer[2] = c2;
+  fBuffer[3] = c3;
+  fPosition = 0;
+
+  // advance the 64-bit draw counter
+  if(++fCounter[0] == 0) ++fCounter[1];
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,70 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DelphesRandom_h
+#define DelphesRandom_h
+
+/** \class DelphesRandom
+ *
+ *  Counter-based random number generator (Philox4x32-10).
+ *
+ *  The sequence is fully determined by the key (random seed, stream)
+ *  and by the event number, so every module draws from its own
+ *  reproducible stream independently of the event processing order.
+ *
+ */
+
+#include "TRandom.h"
+
+class DelphesRandom: public TRandom
+{
+public:
+  DelphesRandom(UInt_t seed = 0, UInt_t stream = 0);
+  ~DelphesRandom();
+
+  void SetKey(UInt_t seed, UInt_t stream);
+  void SetEvent(ULong64_t event);
+
+  virtual Double_t Rndm();
+  virtual void RndmArray(Int_t n, Float_t *array);
+  virtual void RndmArray(Int_t n, Double_t *array);
+
+  virtual void SetSeed(ULong_t seed = 0);
+  virtual UInt_t GetSeed() const { return fKey[0]; }
+
+  UInt_t GetStream() const { return fKey[1]; }
+  ULong64_t GetEvent() const { return (ULong64_t(fCounter[3]) << 32) | fCounter[2]; }
+
+  static UInt_t Hash(const char *name);
+
+private:
+  void Generate();
+
+  UInt_t NextInteger()
+  {
+    if(fPosition > 3) Generate();
+    return fBuffer[fPosition++];
+  }
+
+  UInt_t fKey[2];
+  UInt_t fCounter[4];
+  UInt_t fBuffer[4];
+  Int_t fPosition;
+};
+
+#endif /* DelphesRandom_h */
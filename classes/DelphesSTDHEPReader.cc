@@ -35,14 +35,13 @@
 #include <stdio.h>
 #include <string.h>
 
-#include "TDatabasePDG.h"
 #include "TLorentzVector.h"
 #include "TObjArray.h"
-#include "TParticlePDG.h"
 #include "TStopwatch.h"
 
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
+#include "classes/DelphesPDGTable.h"
 #include "classes/DelphesXDRReader.h"
 
 #include "ExRootAnalysis/ExRootTreeBranch.h"
@@ -58,7 +57,7 @@ DelphesSTDHEPReader::DelphesSTDHEPReader() :
 {
   fBuffer = new uint8_t[kBufferSize * 96 + 24];
 
-  fPDG = TDatabasePDG::Instance();
+  fPDG = DelphesPDGTable::Instance();
 }
 
 //---------------------------------------------------------------------------
@@ -460,8 +459,7 @@ void DelphesSTDHEPReader::AnalyzeParticles(DelphesFactory *factory,
   TObjArray *partonOutputArray)
 {
   Candidate *candidate;
-  TParticlePDG *pdgParticle;
-  int pdgCode;
+  int pdgCode, pdgIndex;
 
   int number;
   int32_t pid, status, m1, m2, d1, d2;
@@ -501,8 +499,8 @@ void DelphesSTDHEPReader::AnalyzeParticles(DelphesFactory *factory,
     candidate->D1 = d1 - 1;
     candidate->D2 = d2 - 1;
 
-    pdgParticle = fPDG->GetParticle(pid);
-    candidate->Charge = pdgParticle ? int(pdgParticle->Charge() / 3.0) : -999;
+    pdgIndex = fPDG->GetIndex(pid);
+    candidate->Charge = fPDG->GetCharge(pdgIndex);
     candidate->Mass = mass;
 
     candidate->Momentum.SetPxPyPzE(px, py, pz, e);
@@ -511,7 +509,7 @@ void DelphesSTDHEPReader::AnalyzeParticles(DelphesFactory *factory,
 
     allParticleOutputArray->Add(candidate);
 
-    if(!pdgParticle) continue;
+    if(!fPDG->IsKnown(pdgIndex)) continue;
 
     if(status == 1)
     {
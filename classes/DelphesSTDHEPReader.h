@@ -34,7 +34,7 @@
 
 class TObjArray;
 class TStopwatch;
-class TDatabasePDG;
+class DelphesPDGTable;
 class ExRootTreeBranch;
 class DelphesFactory;
 class DelphesXDRReader;
@@ -92,7 +92,7 @@ private:
 
   uint8_t *fBuffer;
 
-  TDatabasePDG *fPDG;
+  DelphesPDGTable *fPDG;
 
   uint32_t fEntries;
   int32_t fBlockType, fEventNumber, fEventSize;
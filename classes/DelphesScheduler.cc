@@ -0,0 +1,295 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** \class DelphesScheduler
+ *
+ *  Runs the modules of one event on a pool of threads.
+ *
+ *  Modules are the nodes of a dependency graph: a module is queued as
+ *  soon as all the modules it depends on have been processed. Every
+ *  thread keeps its own queue of ready modules and steals from the
+ *  other queues when its own queue is empty.
+ *
+ */
+
+#include "classes/DelphesScheduler.h"
+
+#include "ExRootAnalysis/ExRootTask.h"
+
+#include <algorithm>
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+
+DelphesScheduler::DelphesScheduler(Int_t numberOfThreads) :
+  fNumberOfThreads(numberOfThreads < 1 ? 1 : numberOfThreads),
+  fPending(0), fQueued(0), fFailed(kFALSE), fCancelled(kFALSE), fStop(kFALSE)
+{
+}
+
+//------------------------------------------------------------------------------
+
+DelphesScheduler::~DelphesScheduler()
+{
+  vector<atomic<Int_t> *>::iterator itRemaining;
+  vector<TaskQueue *>::iterator itQueues;
+
+  Stop();
+
+  for(itRemaining = fRemaining.begin(); itRemaining != fRemaining.end(); ++itRemaining)
+  {
+    delete(*itRemaining);
+  }
+
+  for(itQueues = fQueues.begin(); itQueues != fQueues.end(); ++itQueues)
+  {
+    delete(*itQueues);
+  }
+}
+
+//------------------------------------------------------------------------------
+
+Int_t DelphesScheduler::AddTask(ExRootTask *task)
+{
+  fTasks.push_back(task);
+  fSuccessors.push_back(vector<Int_t>());
+  fNumberOfDependencies.push_back(0);
+  fChecks.push_back(function<Bool_t()>());
+  fRemaining.push_back(new atomic<Int_t>(0));
+  return fTasks.size() - 1;
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesScheduler::AddDependency(Int_t task, Int_t dependency)
+{
+  vector<Int_t> &successors = fSuccessors[dependency];
+
+  if(task == dependency) return;
+  if(find(successors.begin(), successors.end(), task) != successors.end()) return;
+
+  successors.push_back(task);
+  ++fNumberOfDependencies[task];
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesScheduler::AddCheck(Int_t task, function<Bool_t()> check)
+{
+  fChecks[task] = check;
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesScheduler::ProcessTasks()
+{
+  Int_t i, worker, size = fTasks.size();
+
+  // threads are started on the first event, after any fork of the caller
+  if(fQueues.empty()) Start();
+
+  if(size == 0) return;
+
+  fFailed = kFALSE;
+  fCancelled = kFALSE;
+  fException = exception_ptr();
+  fPending = size;
+
+  for(i = 0; i < size; ++i)
+  {
+    *fRemaining[i] = fNumberOfDependencies[i];
+  }
+
+  worker = 0;
+  for(i = 0; i < size; ++i)
+  {
+    if(fNumberOfDependencies[i] > 0) continue;
+    Push(worker, i);
+    worker = (worker + 1) % fNumberOfThreads;
+  }
+
+  // the calling thread works as thread 0 until the event is complete
+  while(fPending > 0)
+  {
+    if(Step(0)) continue;
+
+    unique_lock<mutex> lock(fMutex);
+    if(fPending > 0 && fQueued == 0) fCondition.wait(lock);
+  }
+
+  if(fException) rethrow_exception(fException);
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesScheduler::Start()
+{
+  Int_t i;
+
+  for(i = 0; i < fNumberOfThreads; ++i)
+  {
+    fQueues.push_back(new TaskQueue);
+  }
+
+  fStop = kFALSE;
+  for(i = 1; i < fNumberOfThreads; ++i)
+  {
+    fThreads.push_back(thread(&DelphesScheduler::Loop, this, i));
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesScheduler::Stop()
+{
+  vector<thread>::iterator itThreads;
+
+  {
+    lock_guard<mutex> lock(fMutex);
+    fStop = kTRUE;
+  }
+  fCondition.notify_all();
+
+  for(itThreads = fThreads.begin(); itThreads != fThreads.end(); ++itThreads)
+  {
+    itThreads->join();
+  }
+  fThreads.clear();
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesScheduler::Loop(Int_t worker)
+{
+  while(true)
+  {
+    if(Step(worker)) continue;
+
+    unique_lock<mutex> lock(fMutex);
+    if(fStop) return;
+    if(fQueued == 0) fCondition.wait(lock);
+  }
+}
+
+//------------------------------------------------------------------------------
+
+Bool_t DelphesScheduler::Step(Int_t worker)
+{
+  Int_t task;
+
+  if(!Pop(worker, task)) return kFALSE;
+
+  Execute(worker, task);
+
+  return kTRUE;
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesScheduler::Push(Int_t worker, Int_t task)
+{
+  TaskQueue *queue = fQueues[worker];
+
+  {
+    lock_guard<mutex> lock(queue->fMutex);
+    queue->fTasks.push_back(task);
+  }
+  ++fQueued;
+
+  // taking the lock orders the wake-up after the check made by a sleeping thread
+  {
+    lock_guard<mutex> lock(fMutex);
+  }
+  fCondition.notify_one();
+}
+
+//------------------------------------------------------------------------------
+
+Bool_t DelphesScheduler::Pop(Int_t worker, Int_t &task)
+{
+  Int_t i;
+  TaskQueue *queue;
+
+  if(fQueued == 0) return kFALSE;
+
+  // newest task from the own queue, oldest task from the other queues
+  for(i = 0; i < fNumberOfThreads; ++i)
+  {
+    queue = fQueues[(worker + i) % fNumberOfThreads];
+
+    lock_guard<mutex> lock(queue->fMutex);
+    if(queue->fTasks.empty()) continue;
+
+    if(i == 0)
+    {
+      task = queue->fTasks.back();
+      queue->fTasks.pop_back();
+    }
+    else
+    {
+      task = queue->fTasks.front();
+      queue->fTasks.pop_front();
+    }
+    --fQueued;
+    return kTRUE;
+  }
+
+  return kFALSE;
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesScheduler::Execute(Int_t worker, Int_t task)
+{
+  ExRootTask *object = fTasks[task];
+  vector<Int_t>::iterator itSuccessors;
+
+  // after a failure or a failed check the remaining modules
+  // are only released, not processed
+  if(!fFailed && !fCancelled && object->IsActive())
+  {
+    try
+    {
+      object->ProcessEvent();
+      if(fChecks[task] && !fChecks[task]()) fCancelled = kTRUE;
+    }
+    catch(...)
+    {
+      lock_guard<mutex> lock(fMutex);
+      if(!fFailed)
+      {
+        fException = current_exception();
+        fFailed = kTRUE;
+      }
+    }
+  }
+
+  for(itSuccessors = fSuccessors[task].begin(); itSuccessors != fSuccessors[task].end(); ++itSuccessors)
+  {
+    if(--(*fRemaining[*itSuccessors]) == 0) Push(worker, *itSuccessors);
+  }
+
+  if(--fPending == 0)
+  {
+    lock_guard<mutex> lock(fMutex);
+    fCondition.notify_all();
+  }
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,104 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DelphesScheduler_h
+#define DelphesScheduler_h
+
+/** \class DelphesScheduler
+ *
+ *  Runs the modules of one event on a pool of threads.
+ *
+ *  Modules are the nodes of a dependency graph: a module is queued as
+ *  soon as all the modules it depends on have been processed. Every
+ *  thread keeps its own queue of ready modules and steals from the
+ *  other queues when its own queue is empty.
+ *
+ */
+
+#include "Rtypes.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ExRootTask;
+
+class DelphesScheduler
+{
+public:
+  DelphesScheduler(Int_t numberOfThreads);
+  ~DelphesScheduler();
+
+  Int_t AddTask(ExRootTask *task);
+  void AddDependency(Int_t task, Int_t dependency);
+
+  // when the check of a task fails after the task has been processed,
+  // the tasks that have not started yet are skipped for this event
+  void AddCheck(Int_t task, std::function<Bool_t()> check);
+
+  Int_t GetNumberOfThreads() const { return fNumberOfThreads; }
+
+  void ProcessTasks();
+
+private:
+  struct TaskQueue
+  {
+    std::mutex fMutex;
+    std::deque<Int_t> fTasks;
+  };
+
+  void Start();
+  void Stop();
+
+  void Loop(Int_t worker);
+  Bool_t Step(Int_t worker);
+
+  void Push(Int_t worker, Int_t task);
+  Bool_t Pop(Int_t worker, Int_t &task);
+
+  void Execute(Int_t worker, Int_t task);
+
+  Int_t fNumberOfThreads;
+
+  std::vector<ExRootTask *> fTasks;
+  std::vector<std::vector<Int_t> > fSuccessors;
+  std::vector<Int_t> fNumberOfDependencies;
+  std::vector<std::function<Bool_t()> > fChecks;
+
+  std::vector<std::atomic<Int_t> *> fRemaining;
+  std::vector<TaskQueue *> fQueues;
+  std::vector<std::thread> fThreads;
+
+  std::atomic<Int_t> fPending;
+  std::atomic<Int_t> fQueued;
+  std::atomic<Bool_t> fFailed;
+  std::atomic<Bool_t> fCancelled;
+
+  std::mutex fMutex;
+  std::condition_variable fCondition;
+  Bool_t fStop;
+
+  std::exception_ptr fException;
+};
+
+#endif /* DelphesScheduler_h */
@@ -0,0 +1,92 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "TApplication.h"
+#include "TROOT.h"
+
+#include "ExRootAnalysis/ExRootConfReader.h"
+
+using namespace std;
+
+//---------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+  char appName[] = "card2snapshot";
+  stringstream message;
+  ExRootConfReader *confReader = 0;
+  string parameter;
+  size_t position;
+  Int_t i;
+
+  if(argc < 3)
+  {
+    cout << " Usage: " << appName << " config_file"
+         << " snapshot_file"
+         << " [name=value]..." << endl;
+    cout << " config_file - configuration file in Tcl format," << endl;
+    cout << " snapshot_file - output configuration snapshot, to be used" << endl;
+    cout << "   in place of the configuration file by the Delphes readers," << endl;
+    cout << " name=value - replace the value of a parameter of the configuration file." << endl;
+    return 1;
+  }
+
+  gROOT->SetBatch();
+
+  int appargc = 1;
+  char *appargv[] = {appName};
+  TApplication app(appName, &appargc, appargv);
+
+  try
+  {
+    confReader = new ExRootConfReader;
+    confReader->ReadFile(argv[1]);
+
+    for(i = 3; i < argc; ++i)
+    {
+      parameter = argv[i];
+      position = parameter.find('=');
+      if(position == string::npos || position == 0)
+      {
+        message << "parameter " << parameter << " is not of the form name=value" << endl;
+        throw runtime_error(message.str());
+      }
+      confReader->SetParam(parameter.substr(0, position).c_str(), parameter.substr(position + 1).c_str());
+    }
+
+    cout << "** Writing " << argv[2] << endl;
+
+    confReader->WriteSnapshot(argv[2]);
+
+    cout << "** Exiting..." << endl;
+
+    delete confReader;
+    return 0;
+  }
+  catch(runtime_error &e)
+  {
+    if(confReader) delete confReader;
+    cerr << "** ERROR: " << e.what() << endl;
+    return 1;
+  }
+}
@@ -50,15 +50,15 @@ using namespace std;
 void ProcessEvent(DelphesPileUpReader *reader, ExRootTreeBranch *branch)
 {
   GenParticle *particle;
-  Int_t pid;
-  Float_t x, y, z, t;
+  Int_t pid, charge;
+  Float_t mass, x, y, z, t;
   Float_t px, py, pz, e;
   TDatabasePDG *pdg = TDatabasePDG::Instance();
   TParticlePDG *pdgParticle;
   TLorentzVector momentum;
   Double_t pt, signPz, cosTheta, eta, rapidity;
 
-  while(reader->ReadParticle(pid, x, y, z, t, px, py, pz, e))
+  while(reader->ReadParticle(pid, charge, mass, x, y, z, t, px, py, pz, e))
   {
     particle = static_cast<GenParticle *>(branch->NewEntry());
 
@@ -81,10 +81,18 @@ void ProcessEvent(DelphesPileUpReader *reader, ExRootTreeBranch *branch)
     particle->D1 = -1;
     particle->D2 = -1;
 
-    pdgParticle = pdg->GetParticle(pid);
-    particle->Charge = pdgParticle ? Int_t(pdgParticle->Charge() / 3.0) : -999;
+    if(reader->HasParticleData())
+    {
+      particle->Charge = charge;
+      particle->Mass = mass;
+    }
+    else
+    {
+      pdgParticle = pdg->GetParticle(pid);
+      particle->Charge = pdgParticle ? Int_t(pdgParticle->Charge() / 3.0) : -999;
 
-    particle->Mass = pdgParticle ? pdgParticle->Mass() : -999.9;
+      particle->Mass = pdgParticle ? pdgParticle->Mass() : -999.9;
+    }
 
     momentum.SetPxPyPzE(px, py, pz, e);
     pt = momentum.Pt();
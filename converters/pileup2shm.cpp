@@ -0,0 +1,189 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "classes/DelphesPileUpReader.h"
+
+#include "ExRootAnalysis/ExRootProgressBar.h"
+
+using namespace std;
+
+//---------------------------------------------------------------------------
+
+static bool interrupted = false;
+
+void SignalHandler(int sig)
+{
+  interrupted = true;
+}
+
+//---------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+  char appName[] = "pileup2shm";
+  stringstream message;
+  DelphesPileUpReader *reader = 0;
+  DelphesPileUpReader::SharedHeader *header = 0;
+  DelphesPileUpReader::SharedParticle *particle;
+  int64_t *index;
+  Long64_t entry, allEntries, allParticles;
+  string name;
+  size_t size = 0;
+  void *data = MAP_FAILED;
+  bool created = false;
+  int file = -1;
+
+  if(argc != 3)
+  {
+    cout << " Usage: " << appName << " input_file"
+         << " shared_memory_name" << endl;
+    cout << "        " << appName << " -remove"
+         << " shared_memory_name" << endl;
+    cout << " input_file - input binary pile-up file," << endl;
+    cout << " shared_memory_name - name of the POSIX shared memory object receiving" << endl;
+    cout << "   the decoded pile-up library, to be read with PileUpFile \"shm:/name\"," << endl;
+    cout << " -remove - remove the pile-up library from shared memory." << endl;
+    return 1;
+  }
+
+  name = argv[2];
+  if(name[0] != '/') name = "/" + name;
+
+  if(strcmp(argv[1], "-remove") == 0)
+  {
+    if(shm_unlink(name.c_str()) < 0)
+    {
+      cerr << "** ERROR: can't remove shared memory object " << name << endl;
+      return 1;
+    }
+    return 0;
+  }
+
+  signal(SIGINT, SignalHandler);
+
+  try
+  {
+    cout << "** Reading " << argv[1] << endl;
+
+    reader = new DelphesPileUpReader(argv[1]);
+    allEntries = reader->GetEntries();
+
+    cout << "** Input file contains " << allEntries << " events" << endl;
+
+    // count particles
+    allParticles = 0;
+    for(entry = 0; entry < allEntries; ++entry)
+    {
+      reader->ReadEntry(entry);
+      allParticles += reader->GetEntrySize();
+    }
+
+    size = sizeof(DelphesPileUpReader::SharedHeader) + 8 * (allEntries + 1)
+      + sizeof(DelphesPileUpReader::SharedParticle) * allParticles;
+
+    // the object is created empty and is only usable once its header is written
+    file = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+
+    if(file < 0)
+    {
+      message << "can't create shared memory object " << name;
+      throw runtime_error(message.str());
+    }
+
+    created = true;
+
+    if(ftruncate(file, size) < 0
+      || (data = mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0)) == MAP_FAILED)
+    {
+      message << "can't allocate " << size << " bytes of shared memory for " << name;
+      throw runtime_error(message.str());
+    }
+
+    close(file);
+    file = -1;
+
+    cout << "** Loading " << allParticles << " particles into " << name << endl;
+
+    header = static_cast<DelphesPileUpReader::SharedHeader *>(data);
+    index = reinterpret_cast<int64_t *>(header + 1);
+    particle = reinterpret_cast<DelphesPileUpReader::SharedParticle *>(index + allEntries + 1);
+
+    index[0] = 0;
+
+    if(allEntries > 0)
+    {
+      ExRootProgressBar progressBar(allEntries - 1);
+      // Loop over all events
+      for(entry = 0; entry < allEntries && !interrupted; ++entry)
+      {
+        reader->ReadEntry(entry);
+
+        while(reader->ReadParticle(particle->pid,
+          particle->x, particle->y, particle->z, particle->t,
+          particle->px, particle->py, particle->pz, particle->e))
+        {
+          ++particle;
+        }
+
+        index[entry + 1] = index[entry] + reader->GetEntrySize();
+
+        progressBar.Update(entry);
+      }
+      progressBar.Finish();
+    }
+
+    if(interrupted)
+    {
+      throw runtime_error("interrupted");
+    }
+
+    header->fEntries = allEntries;
+    header->fParticles = allParticles;
+
+    __sync_synchronize();
+    memcpy(header->fMagic, DelphesPileUpReader::kSharedMagic, sizeof(header->fMagic));
+
+    munmap(data, size);
+    delete reader;
+
+    cout << "** Exiting..." << endl;
+
+    return 0;
+  }
+  catch(runtime_error &e)
+  {
+    if(data != MAP_FAILED) munmap(data, size);
+    if(file >= 0) close(file);
+    if(created) shm_unlink(name.c_str());
+    if(reader) delete reader;
+    cerr << "** ERROR: " << e.what() << endl;
+    return 1;
+  }
+}
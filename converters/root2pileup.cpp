@@ -22,6 +22,7 @@
 #include <string>
 
 #include <signal.h>
+#include <string.h>
 
 #include "TApplication.h"
 #include "TROOT.h"
@@ -59,12 +60,41 @@ int main(int argc, char *argv[])
   GenParticle *particle = 0;
   DelphesPileUpWriter *writer = 0;
   Long64_t entry, allEntries;
-  Int_t i;
+  Int_t i, version;
+  UInt_t flags;
 
-  if(argc < 3)
+  version = 1;
+  flags = 0;
+  while(argc > 2 && argv[1][0] == '-')
   {
-    cout << " Usage: " << appName << " output_file"
+    if(strcmp(argv[1], "-v2") == 0)
+    {
+      version = 2;
+      argv += 1;
+      argc -= 1;
+      continue;
+    }
+
+    if(strcmp(argv[1], "-half") == 0 && strcmp(argv[2], "position") == 0)
+      flags |= DelphesPileUpFormat::kHalfPosition;
+    else if(strcmp(argv[1], "-half") == 0 && strcmp(argv[2], "momentum") == 0)
+      flags |= DelphesPileUpFormat::kHalfMomentum;
+    else
+      break;
+
+    argv += 2;
+    argc -= 2;
+  }
+
+  if(argc < 3 || (flags != 0 && version < 2))
+  {
+    cout << " Usage: " << appName << " [-v2 [-half position|momentum]...]"
+         << " output_file"
          << " input_file(s)" << endl;
+    cout << " -v2 - write a pile-up file of version 2, with columns of values in blocks," << endl;
+    cout << "   it can't be read by versions of Delphes older than this one," << endl;
+    cout << " -half position|momentum - store positions and times, or momenta and energies," << endl;
+    cout << "   as half-precision floats, with a relative precision of 5e-4, version 2 only," << endl;
     cout << " output_file - output binary pile-up file," << endl;
     cout << " input_file(s) - input file(s) in ROOT format." << endl;
     return 1;
@@ -90,7 +120,7 @@ int main(int argc, char *argv[])
     branchParticle = treeReader->UseBranch("Particle");
     itParticle = branchParticle->MakeIterator();
 
-    writer = new DelphesPileUpWriter(argv[1]);
+    writer = new DelphesPileUpWriter(argv[1], version, flags);
 
     allEntries = treeReader->GetEntries();
     cout << "** Input file(s) contain(s) " << allEntries << " events" << endl;
@@ -110,7 +140,7 @@ int main(int argc, char *argv[])
         itParticle->Reset();
         while((particle = static_cast<GenParticle *>(itParticle->Next())))
         {
-          writer->WriteParticle(particle->PID,
+          writer->WriteParticle(particle->PID, particle->Charge, particle->Mass,
             particle->X, particle->Y, particle->Z, particle->T,
             particle->Px, particle->Py, particle->Pz, particle->E);
         }
@@ -21,6 +21,7 @@
 #include <stdexcept>
 
 #include <signal.h>
+#include <string.h>
 
 #include "TApplication.h"
 #include "TROOT.h"
@@ -65,13 +66,42 @@ int main(int argc, char *argv[])
   Candidate *candidate = 0;
   DelphesPileUpWriter *writer = 0;
   DelphesSTDHEPReader *reader = 0;
-  Int_t i;
+  Int_t i, version;
+  UInt_t flags;
   Long64_t length, eventCounter;
 
-  if(argc < 2)
+  version = 1;
+  flags = 0;
+  while(argc > 2 && argv[1][0] == '-')
   {
-    cout << " Usage: " << appName << " output_file"
+    if(strcmp(argv[1], "-v2") == 0)
+    {
+      version = 2;
+      argv += 1;
+      argc -= 1;
+      continue;
+    }
+
+    if(strcmp(argv[1], "-half") == 0 && strcmp(argv[2], "position") == 0)
+      flags |= DelphesPileUpFormat::kHalfPosition;
+    else if(strcmp(argv[1], "-half") == 0 && strcmp(argv[2], "momentum") == 0)
+      flags |= DelphesPileUpFormat::kHalfMomentum;
+    else
+      break;
+
+    argv += 2;
+    argc -= 2;
+  }
+
+  if(argc < 2 || (flags != 0 && version < 2))
+  {
+    cout << " Usage: " << appName << " [-v2 [-half position|momentum]...]"
+         << " output_file"
          << " [input_file(s)]" << endl;
+    cout << " -v2 - write a pile-up file of version 2, with columns of values in blocks," << endl;
+    cout << "   it can't be read by versions of Delphes older than this one," << endl;
+    cout << " -half position|momentum - store positions and times, or momenta and energies," << endl;
+    cout << "   as half-precision floats, with a relative precision of 5e-4, version 2 only," << endl;
     cout << " output_file - output binary pile-up file," << endl;
     cout << " input_file(s) - input file(s) in STDHEP format," << endl;
     cout << " with no input_file, or when input_file is -, read standard input." << endl;
@@ -88,7 +118,7 @@ int main(int argc, char *argv[])
 
   try
   {
-    writer = new DelphesPileUpWriter(argv[1]);
+    writer = new DelphesPileUpWriter(argv[1], version, flags);
 
     factory = new DelphesFactory("ObjectFactory");
     allParticleOutputArray = factory->NewPermanentArray();
@@ -154,7 +184,7 @@ int main(int argc, char *argv[])
           {
             const TLorentzVector &position = candidate->Position;
             const TLorentzVector &momentum = candidate->Momentum;
-            writer->WriteParticle(candidate->PID,
+            writer->WriteParticle(candidate->PID, candidate->Charge, candidate->Mass,
               position.X(), position.Y(), position.Z(), position.T(),
               momentum.Px(), momentum.Py(), momentum.Pz(), momentum.E());
           }
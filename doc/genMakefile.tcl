@@ -267,6 +267,13 @@ OPT_LIBS += -L$(PYTHIA8)/lib -lpythia8 -ldl -lz
 endif
 endif
 
+# shm_open and shm_unlink are in librt before glibc 2.34
+ifeq ($(PLATFORM),linux)
+OPT_LIBS += -lrt
+endif
+
+OPT_LIBS += -lpthread
+
 DELPHES_LIBS += $(OPT_LIBS)
 DISPLAY_LIBS += $(OPT_LIBS)
 
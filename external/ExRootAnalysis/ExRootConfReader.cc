@@ -20,11 +20,26 @@
 #include <stdexcept>
 #include <string>
 
+#include <string.h>
+
 using namespace std;
 
 static Tcl_ObjCmdProc ModuleObjCmdProc;
 static Tcl_ObjCmdProc SourceObjCmdProc;
 
+// binary snapshot: magic, version, then lists of configuration files
+// with their absolute paths and hashes, modules, namespaces, scalar variables
+// and array variables
+static const char kSnapshotMagic[] = "ExRootConfSnapshot";
+static const ULong64_t kSnapshotVersion = 2;
+
+static ULong64_t HashBuffer(const char *buffer, int length);
+static void WriteNumber(ostream &stream, ULong64_t value);
+static void WriteString(ostream &stream, const string &value);
+static ULong64_t ReadNumber(const char *&position, const char *end, const char *fileName);
+static TString ReadString(const char *&position, const char *end, const char *fileName);
+static void EvalList(Tcl_Interp *interp, const char *command, const char *subcommand, const string &argument, vector<string> &result);
+
 //------------------------------------------------------------------------------
 
 ExRootConfReader::ExRootConfReader() :
@@ -48,6 +63,7 @@ ExRootConfReader::~ExRootConfReader()
 void ExRootConfReader::ReadFile(const char *fileName, bool isTop)
 {
   stringstream message;
+  TString path;
 
   ifstream inputFileStream(fileName, ios::in | ios::ate);
   if(!inputFileStream.is_open())
@@ -64,6 +80,21 @@ void ExRootConfReader::ReadFile(const char *fileName, bool isTop)
   char *cmdBuffer = new char[file_length];
   inputFileStream.read(cmdBuffer, file_length);
 
+  if(isTop && file_length >= int(sizeof(kSnapshotMagic)) && memcmp(cmdBuffer, kSnapshotMagic, sizeof(kSnapshotMagic)) == 0)
+  {
+    ReadSnapshot(fileName, cmdBuffer, file_length);
+    delete[] cmdBuffer;
+    return;
+  }
+
+  // the snapshot can be read from another working directory
+  path = fileName;
+  if(!gSystem->IsAbsoluteFileName(fileName))
+  {
+    path = TString(gSystem->WorkingDirectory()) + "/" + fileName;
+  }
+  fFiles.push_back(make_pair(path, HashBuffer(cmdBuffer, file_length)));
+
   Tcl_Obj *cmdObjPtr = Tcl_NewObj();
   cmdObjPtr->bytes = cmdBuffer;
   cmdObjPtr->length = file_length;
@@ -97,6 +128,237 @@ ExRootConfParam ExRootConfReader::GetParam(const char *name)
 
 //------------------------------------------------------------------------------
 
+void ExRootConfReader::SetParam(const char *name, const char *value)
+{
+  stringstream message;
+  Tcl_Obj *variableName = Tcl_NewStringObj(const_cast<char *>(name), -1);
+  Tcl_Obj *variableValue = Tcl_NewStringObj(const_cast<char *>(value), -1);
+
+  if(!Tcl_ObjSetVar2(fTclInterp, variableName, 0, variableValue, TCL_GLOBAL_ONLY | TCL_LEAVE_ERR_MSG))
+  {
+    message << "can't set parameter " << name << endl;
+    message << Tcl_GetStringResult(fTclInterp);
+    throw runtime_error(message.str());
+  }
+}
+
+//------------------------------------------------------------------------------
+
+bool ExRootConfReader::HasParam(const char *name)
+{
+  Tcl_Obj *variableName = Tcl_NewStringObj(const_cast<char *>(name), -1);
+  return Tcl_ObjGetVar2(fTclInterp, variableName, 0, TCL_GLOBAL_ONLY) != 0;
+}
+
+//------------------------------------------------------------------------------
+
+void ExRootConfReader::UnsetParam(const char *name)
+{
+  Tcl_UnsetVar(fTclInterp, const_cast<char *>(name), TCL_GLOBAL_ONLY);
+}
+
+//------------------------------------------------------------------------------
+
+void ExRootConfReader::WriteSnapshot(const char *fileName)
+{
+  stringstream message;
+  vector<string> namespaces, variables, names, flag, elements;
+  vector<string>::iterator itNames;
+  vector<pair<string, vector<string> > > arrays;
+  vector<pair<string, vector<string> > >::iterator itArrays;
+  ExRootFileList::iterator itFiles;
+  ExRootTaskMap::iterator itModules;
+  Tcl_Obj *object;
+  string pattern;
+  size_t i;
+
+  // collect the namespaces created by the modules and the variables they contain
+
+  namespaces.push_back("::");
+  for(i = 0; i < namespaces.size(); ++i)
+  {
+    EvalList(fTclInterp, "namespace", "children", namespaces[i], names);
+    namespaces.insert(namespaces.end(), names.begin(), names.end());
+  }
+
+  for(i = 0; i < namespaces.size(); ++i)
+  {
+    pattern = namespaces[i] == "::" ? "::*" : namespaces[i] + "::*";
+    EvalList(fTclInterp, "info", "vars", pattern, names);
+    for(itNames = names.begin(); itNames != names.end(); ++itNames)
+    {
+      // variables of the interpreter itself
+      if(itNames->compare(0, 6, "::tcl_") == 0 || *itNames == "::errorInfo" || *itNames == "::errorCode" || *itNames == "::env") continue;
+
+      EvalList(fTclInterp, "array", "exists", *itNames, flag);
+      if(flag.size() == 1 && flag[0] == "1")
+      {
+        // array get returns a flat list of element names and values
+        EvalList(fTclInterp, "array", "get", *itNames, elements);
+        arrays.push_back(make_pair(*itNames, elements));
+        continue;
+      }
+
+      object = Tcl_ObjGetVar2(fTclInterp, Tcl_NewStringObj(const_cast<char *>(itNames->c_str()), -1), 0, TCL_GLOBAL_ONLY);
+      if(!object) continue;
+
+      variables.push_back(*itNames);
+      variables.push_back(Tcl_GetStringFromObj(object, 0));
+    }
+  }
+
+  ofstream outputFileStream(fileName, ios::out | ios::binary | ios::trunc);
+  if(!outputFileStream.is_open())
+  {
+    message << "can't create configuration snapshot " << fileName;
+    throw runtime_error(message.str());
+  }
+
+  outputFileStream.write(kSnapshotMagic, sizeof(kSnapshotMagic));
+  WriteNumber(outputFileStream, kSnapshotVersion);
+
+  WriteNumber(outputFileStream, fFiles.size());
+  for(itFiles = fFiles.begin(); itFiles != fFiles.end(); ++itFiles)
+  {
+    WriteString(outputFileStream, itFiles->first.Data());
+    WriteNumber(outputFileStream, itFiles->second);
+  }
+
+  WriteNumber(outputFileStream, fModules.size());
+  for(itModules = fModules.begin(); itModules != fModules.end(); ++itModules)
+  {
+    WriteString(outputFileStream, itModules->second.Data());
+    WriteString(outputFileStream, itModules->first.Data());
+  }
+
+  WriteNumber(outputFileStream, namespaces.size() - 1);
+  for(i = 1; i < namespaces.size(); ++i)
+  {
+    WriteString(outputFileStream, namespaces[i]);
+  }
+
+  WriteNumber(outputFileStream, variables.size() / 2);
+  for(itNames = variables.begin(); itNames != variables.end(); ++itNames)
+  {
+    WriteString(outputFileStream, *itNames);
+  }
+
+  WriteNumber(outputFileStream, arrays.size());
+  for(itArrays = arrays.begin(); itArrays != arrays.end(); ++itArrays)
+  {
+    WriteString(outputFileStream, itArrays->first);
+    WriteNumber(outputFileStream, itArrays->second.size() / 2);
+    for(itNames = itArrays->second.begin(); itNames != itArrays->second.end(); ++itNames)
+    {
+      WriteString(outputFileStream, *itNames);
+    }
+  }
+
+  if(!outputFileStream.good())
+  {
+    message << "can't write configuration snapshot " << fileName;
+    throw runtime_error(message.str());
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void ExRootConfReader::ReadSnapshot(const char *fileName, const char *buffer, int length)
+{
+  stringstream message;
+  const char *position = buffer + sizeof(kSnapshotMagic);
+  const char *end = buffer + length;
+  ULong64_t i, j, size, elements, hash;
+  TString name, key, value;
+  Tcl_Obj *variableName, *elementName, *variableValue;
+
+  if(ReadNumber(position, end, fileName) != kSnapshotVersion)
+  {
+    message << "configuration snapshot " << fileName << " was written by another version, recompile it";
+    throw runtime_error(message.str());
+  }
+
+  // configuration files must still exist and must not have changed
+
+  fFiles.clear();
+  size = ReadNumber(position, end, fileName);
+  for(i = 0; i < size; ++i)
+  {
+    name = ReadString(position, end, fileName);
+    hash = ReadNumber(position, end, fileName);
+    fFiles.push_back(make_pair(name, hash));
+
+    ifstream inputFileStream(name.Data(), ios::in | ios::binary);
+    if(!inputFileStream.is_open())
+    {
+      message << "configuration snapshot " << fileName << " is out of date, ";
+      message << name << " can't be opened";
+      throw runtime_error(message.str());
+    }
+
+    string contents((istreambuf_iterator<char>(inputFileStream)), istreambuf_iterator<char>());
+    if(HashBuffer(contents.data(), contents.size()) != hash)
+    {
+      message << "configuration snapshot " << fileName << " is out of date, ";
+      message << name << " has changed since it was compiled";
+      throw runtime_error(message.str());
+    }
+  }
+
+  size = ReadNumber(position, end, fileName);
+  for(i = 0; i < size; ++i)
+  {
+    value = ReadString(position, end, fileName);
+    name = ReadString(position, end, fileName);
+    AddModule(value, name);
+  }
+
+  size = ReadNumber(position, end, fileName);
+  for(i = 0; i < size; ++i)
+  {
+    name = ReadString(position, end, fileName);
+    value = "namespace eval " + name + " {}";
+    if(Tcl_GlobalEval(fTclInterp, const_cast<char *>(value.Data())) != TCL_OK)
+    {
+      message << "can't create namespace " << name << endl;
+      message << Tcl_GetStringResult(fTclInterp);
+      throw runtime_error(message.str());
+    }
+  }
+
+  size = ReadNumber(position, end, fileName);
+  for(i = 0; i < size; ++i)
+  {
+    name = ReadString(position, end, fileName);
+    value = ReadString(position, end, fileName);
+    SetParam(name, value);
+  }
+
+  size = ReadNumber(position, end, fileName);
+  for(i = 0; i < size; ++i)
+  {
+    name = ReadString(position, end, fileName);
+    elements = ReadNumber(position, end, fileName);
+    for(j = 0; j < elements; ++j)
+    {
+      key = ReadString(position, end, fileName);
+      value = ReadString(position, end, fileName);
+
+      variableName = Tcl_NewStringObj(const_cast<char *>(name.Data()), -1);
+      elementName = Tcl_NewStringObj(const_cast<char *>(key.Data()), -1);
+      variableValue = Tcl_NewStringObj(const_cast<char *>(value.Data()), -1);
+      if(!Tcl_ObjSetVar2(fTclInterp, variableName, elementName, variableValue, TCL_GLOBAL_ONLY | TCL_LEAVE_ERR_MSG))
+      {
+        message << "can't set parameter " << name << "(" << key << ")" << endl;
+        message << Tcl_GetStringResult(fTclInterp);
+        throw runtime_error(message.str());
+      }
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+
 int ExRootConfReader::GetInt(const char *name, int defaultValue, int index)
 {
   ExRootConfParam object = GetParam(name);
@@ -231,6 +493,110 @@ int SourceObjCmdProc(ClientData clientData, Tcl_Interp *interp, int objc, Tcl_Ob
 
 //------------------------------------------------------------------------------
 
+// FNV-1a hash of the contents of a configuration file
+
+ULong64_t HashBuffer(const char *buffer, int length)
+{
+  ULong64_t hash = 14695981039346656037ULL;
+  int i;
+
+  for(i = 0; i < length; ++i)
+  {
+    hash ^= static_cast<unsigned char>(buffer[i]);
+    hash *= 1099511628211ULL;
+  }
+
+  return hash;
+}
+
+//------------------------------------------------------------------------------
+
+void WriteNumber(ostream &stream, ULong64_t value)
+{
+  stream.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+//------------------------------------------------------------------------------
+
+void WriteString(ostream &stream, const string &value)
+{
+  WriteNumber(stream, value.size());
+  stream.write(value.data(), value.size());
+}
+
+//------------------------------------------------------------------------------
+
+// the snapshot is written and read on the same platform,
+// numbers are stored in native byte order
+
+ULong64_t ReadNumber(const char *&position, const char *end, const char *fileName)
+{
+  stringstream message;
+  ULong64_t value;
+
+  if(end - position < Long64_t(sizeof(value)))
+  {
+    message << "configuration snapshot " << fileName << " is corrupted";
+    throw runtime_error(message.str());
+  }
+
+  memcpy(&value, position, sizeof(value));
+  position += sizeof(value);
+
+  return value;
+}
+
+//------------------------------------------------------------------------------
+
+TString ReadString(const char *&position, const char *end, const char *fileName)
+{
+  stringstream message;
+  ULong64_t size = ReadNumber(position, end, fileName);
+
+  if(ULong64_t(end - position) < size)
+  {
+    message << "configuration snapshot " << fileName << " is corrupted";
+    throw runtime_error(message.str());
+  }
+
+  TString value(position, Ssiz_t(size));
+  position += size;
+
+  return value;
+}
+
+//------------------------------------------------------------------------------
+
+// evaluate "command subcommand argument" and return the elements of its result
+
+void EvalList(Tcl_Interp *interp, const char *command, const char *subcommand, const string &argument, vector<string> &result)
+{
+  stringstream message;
+  Tcl_Obj *object = Tcl_NewListObj(0, 0);
+  Tcl_Obj **elements;
+  int i, size;
+
+  Tcl_ListObjAppendElement(interp, object, Tcl_NewStringObj(const_cast<char *>(command), -1));
+  Tcl_ListObjAppendElement(interp, object, Tcl_NewStringObj(const_cast<char *>(subcommand), -1));
+  Tcl_ListObjAppendElement(interp, object, Tcl_NewStringObj(const_cast<char *>(argument.c_str()), -1));
+
+  if(Tcl_GlobalEvalObj(interp, object) != TCL_OK
+    || Tcl_ListObjGetElements(interp, Tcl_GetObjResult(interp), &size, &elements) != TCL_OK)
+  {
+    message << "can't evaluate " << command << " " << subcommand << " " << argument << endl;
+    message << Tcl_GetStringResult(interp);
+    throw runtime_error(message.str());
+  }
+
+  result.clear();
+  for(i = 0; i < size; ++i)
+  {
+    result.push_back(Tcl_GetStringFromObj(elements[i], 0));
+  }
+}
+
+//------------------------------------------------------------------------------
+
 ExRootConfParam::ExRootConfParam(const char *name, Tcl_Obj *object, Tcl_Interp *interp) :
   fName(name), fObject(object), fTclInterp(interp)
 {
@@ -13,6 +13,7 @@
 
 #include <map>
 #include <utility>
+#include <vector>
 
 struct Tcl_Obj;
 struct Tcl_Interp;
@@ -56,6 +57,16 @@ public:
   const char *GetString(const char *name, const char *defaultValue, int index = -1);
   ExRootConfParam GetParam(const char *name);
 
+  // replace the value given in the configuration file
+  void SetParam(const char *name, const char *value);
+
+  bool HasParam(const char *name);
+  void UnsetParam(const char *name);
+
+  // save the resolved parameters and modules to a binary snapshot,
+  // ReadFile loads it without evaluating the configuration files
+  void WriteSnapshot(const char *fileName);
+
   const ExRootTaskMap *GetModules() const { return &fModules; }
 
   void AddModule(const char *className, const char *moduleName);
@@ -63,12 +74,18 @@ public:
   const char *GetTopDir() const { return fTopDir; }
 
 private:
+  typedef std::vector<std::pair<TString, ULong64_t> > ExRootFileList;
+
+  void ReadSnapshot(const char *fileName, const char *buffer, int length);
+
   const char *fTopDir; //!
 
   Tcl_Interp *fTclInterp; //!
 
   ExRootTaskMap fModules; //!
 
+  ExRootFileList fFiles; //! configuration files and hashes of their contents
+
   ClassDef(ExRootConfReader, 1)
 };
 
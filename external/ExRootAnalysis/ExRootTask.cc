@@ -12,9 +12,21 @@
 
 #include "TClass.h"
 #include "TFolder.h"
+#include "TH1.h"
+#include "TMath.h"
 #include "TROOT.h"
 #include "TString.h"
 
+#include <string.h>
+#include <time.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 #include <iomanip>
 #include <iostream>
 #include <sstream>
@@ -24,17 +36,204 @@ static const char *const kINIT = "0";
 static const char *const kPROCESS = "1";
 static const char *const kFINISH = "2";
 
+// latency histogram: 10 bins per decade from 100 ns to 100 s
+static const Int_t kLatencyBins = 90;
+static const Double_t kLatencyMin = 1.0e-7;
+
 using namespace std;
 
+// task being executed by the calling thread
+static thread_local ExRootTask *gCurrentTask = 0;
+
+//------------------------------------------------------------------------------
+
+static Double_t GetWallClock()
+{
+  timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return time.tv_sec + 1.0e-9 * time.tv_nsec;
+}
+
+//------------------------------------------------------------------------------
+
+static Double_t GetCpuClock()
+{
+  // CPU time of the calling thread, modules can run on several threads
+#ifdef CLOCK_THREAD_CPUTIME_ID
+  timespec time;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+  return time.tv_sec + 1.0e-9 * time.tv_nsec;
+#else
+  return Double_t(clock()) / CLOCKS_PER_SEC;
+#endif
+}
+
+//------------------------------------------------------------------------------
+
+// group of hardware counters counting for the thread that opened them,
+// Read opens the group on its first call and opens it again in a process
+// created by fork, the inherited group counts for the parent process
+
+class ExRootCounters
+{
+public:
+  ExRootCounters();
+  ~ExRootCounters();
+
+  void Open();
+  void Close();
+
+  Bool_t IsOpen() const { return fLeader >= 0; }
+  Bool_t Read(Long64_t *values);
+
+private:
+  Int_t fPid;
+  Int_t fLeader;
+  Int_t fDescriptors[ExRootTask::kNumberOfCounters];
+  Int_t fSlots[ExRootTask::kNumberOfCounters];
+  Int_t fSize;
+};
+
+//------------------------------------------------------------------------------
+
+ExRootCounters::ExRootCounters() :
+  fPid(-1), fLeader(-1), fSize(0)
+{
+  Int_t i;
+
+  for(i = 0; i < ExRootTask::kNumberOfCounters; ++i)
+  {
+    fDescriptors[i] = -1;
+    fSlots[i] = -1;
+  }
+}
+
+//------------------------------------------------------------------------------
+
+ExRootCounters::~ExRootCounters()
+{
+  Close();
+}
+
+//------------------------------------------------------------------------------
+
+void ExRootCounters::Open()
+{
+  Int_t i;
+
+  Close();
+
+#ifdef __linux__
+  fPid = getpid();
+
+  static const ULong64_t configs[ExRootTask::kNumberOfCounters] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES};
+
+  perf_event_attr attr;
+
+  // counters that are not supported by the processor are left at zero
+  for(i = 0; i < ExRootTask::kNumberOfCounters; ++i)
+  {
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = configs[i];
+    attr.disabled = (fLeader < 0);
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+
+    fDescriptors[i] = syscall(__NR_perf_event_open, &attr, 0, -1, fLeader, 0);
+    if(fDescriptors[i] < 0) continue;
+
+    if(fLeader < 0) fLeader = fDescriptors[i];
+    fSlots[i] = fSize++;
+  }
+
+  if(fLeader >= 0)
+  {
+    ioctl(fLeader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(fLeader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  }
+#endif
+}
+
+//------------------------------------------------------------------------------
+
+void ExRootCounters::Close()
+{
+  Int_t i;
+
+  for(i = 0; i < ExRootTask::kNumberOfCounters; ++i)
+  {
+#ifdef __linux__
+    if(fDescriptors[i] >= 0) close(fDescriptors[i]);
+#endif
+    fDescriptors[i] = -1;
+    fSlots[i] = -1;
+  }
+
+  fLeader = -1;
+  fSize = 0;
+}
+
+//------------------------------------------------------------------------------
+
+Bool_t ExRootCounters::Read(Long64_t *values)
+{
+  Int_t i;
+
+  for(i = 0; i < ExRootTask::kNumberOfCounters; ++i)
+  {
+    values[i] = 0;
+  }
+
+#ifdef __linux__
+  // PERF_FORMAT_GROUP layout: number of counters followed by their values
+  ULong64_t buffer[ExRootTask::kNumberOfCounters + 1];
+
+  if(fPid != getpid()) Open();
+
+  if(fLeader < 0) return kFALSE;
+  if(read(fLeader, buffer, sizeof(buffer)) < ssize_t((fSize + 1) * sizeof(ULong64_t))) return kFALSE;
+
+  for(i = 0; i < ExRootTask::kNumberOfCounters; ++i)
+  {
+    if(fSlots[i] >= 0) values[i] = buffer[fSlots[i] + 1];
+  }
+  return kTRUE;
+#else
+  return kFALSE;
+#endif
+}
+
+//------------------------------------------------------------------------------
+
+static thread_local ExRootCounters gCounters;
+
+//------------------------------------------------------------------------------
+
 ExRootTask::ExRootTask() :
-  TTask("", ""), fFolder(0), fConfReader(0)
+  TTask("", ""), fFolder(0), fConfReader(0),
+  fProfiling(kFALSE), fNumberOfEvents(0), fInitTime(0.0), fFinishTime(0.0),
+  fWallTime(0.0), fCpuTime(0.0), fEventWallTime(0.0), fEventCpuTime(0.0),
+  fLatency(0), fCounting(kFALSE)
 {
+  Int_t i;
+  for(i = 0; i < kNumberOfCounters; ++i)
+  {
+    fCounters[i] = 0;
+  }
 }
 
 //------------------------------------------------------------------------------
 
 ExRootTask::~ExRootTask()
 {
+  if(fLatency) delete fLatency;
 }
 
 //------------------------------------------------------------------------------
@@ -57,22 +256,146 @@ void ExRootTask::Finish()
 
 //------------------------------------------------------------------------------
 
+void ExRootTask::ProcessBatch(Int_t size)
+{
+  Int_t i;
+  for(i = 0; i < size; ++i)
+  {
+    Process();
+  }
+}
+
+//------------------------------------------------------------------------------
+
+ExRootTask *ExRootTask::GetCurrentTask()
+{
+  return gCurrentTask;
+}
+
+//------------------------------------------------------------------------------
+
 void ExRootTask::Exec(Option_t *option)
 {
+  Double_t start;
+  ExRootTask *previous = gCurrentTask;
+
+  gCurrentTask = this;
+
   if(option == kINIT)
   {
     cout << left;
     cout << setw(30) << "** INFO: initializing module";
     cout << setw(25) << GetName() << endl;
+    start = fProfiling ? GetWallClock() : 0.0;
     Init();
+    if(fProfiling) fInitTime += GetWallClock() - start;
   }
   else if(option == kPROCESS)
   {
-    Process();
+    ProcessEvent();
   }
   else if(option == kFINISH)
   {
+    start = fProfiling ? GetWallClock() : 0.0;
     Finish();
+    if(fProfiling) fFinishTime += GetWallClock() - start;
+  }
+
+  gCurrentTask = previous;
+}
+
+//------------------------------------------------------------------------------
+
+Bool_t ExRootTask::HasCounters()
+{
+  // the counters of the calling thread are only opened by the first event,
+  // the probe is closed as soon as it is checked
+  ExRootCounters probe;
+  probe.Open();
+  return probe.IsOpen();
+}
+
+//------------------------------------------------------------------------------
+
+void ExRootTask::ProcessEvent()
+{
+  ProcessEvents(0);
+}
+
+//------------------------------------------------------------------------------
+
+void ExRootTask::ProcessEvents(Int_t size)
+{
+  // size 0 processes the current event with Process,
+  // a positive size processes a batch of events with ProcessBatch
+
+  Int_t i, events = size > 0 ? size : 1;
+  Double_t wallTime, cpuTime;
+  Long64_t start[kNumberOfCounters], stop[kNumberOfCounters];
+  ExRootTask *previous = gCurrentTask;
+
+  gCurrentTask = this;
+
+  if(!fProfiling)
+  {
+    if(size > 0)
+      ProcessBatch(size);
+    else
+      Process();
+    gCurrentTask = previous;
+    return;
+  }
+
+  wallTime = GetWallClock();
+  cpuTime = GetCpuClock();
+  if(fCounting) gCounters.Read(start);
+
+  if(size > 0)
+    ProcessBatch(size);
+  else
+    Process();
+
+  if(fCounting && gCounters.Read(stop))
+  {
+    for(i = 0; i < kNumberOfCounters; ++i)
+    {
+      fCounters[i] += stop[i] - start[i];
+    }
+  }
+
+  gCurrentTask = previous;
+
+  wallTime = GetWallClock() - wallTime;
+  cpuTime = GetCpuClock() - cpuTime;
+
+  fWallTime += wallTime;
+  fCpuTime += cpuTime;
+  fNumberOfEvents += events;
+
+  // events of a batch are given the average time
+  fEventWallTime = wallTime / events;
+  fEventCpuTime = cpuTime / events;
+
+  fLatency->Fill(fEventWallTime, events);
+}
+
+//------------------------------------------------------------------------------
+
+void ExRootTask::SetProfiling(Bool_t flag)
+{
+  Int_t i;
+  Double_t edges[kLatencyBins + 1];
+
+  fProfiling = flag;
+
+  if(fProfiling && !fLatency)
+  {
+    for(i = 0; i <= kLatencyBins; ++i)
+    {
+      edges[i] = kLatencyMin * TMath::Power(10.0, i / 10.0);
+    }
+    fLatency = new TH1D(TString(GetName()) + "_latency", TString(GetName()) + ";latency [s];events", kLatencyBins, edges);
+    fLatency->SetDirectory(0);
   }
 }
 
@@ -13,12 +13,22 @@
 
 #include "ExRootAnalysis/ExRootConfReader.h"
 
+class TH1;
 class TClass;
 class TFolder;
 
 class ExRootTask: public TTask
 {
 public:
+  enum
+  {
+    kCycles,
+    kInstructions,
+    kCacheMisses,
+    kBranchMisses,
+    kNumberOfCounters
+  };
+
   ExRootTask();
   virtual ~ExRootTask();
 
@@ -26,6 +36,9 @@ public:
   virtual void Process();
   virtual void Finish();
 
+  // process the events of a batch, by default one after the other with Process
+  virtual void ProcessBatch(Int_t size);
+
   virtual void InitTask();
   virtual void ProcessTask();
   virtual void FinishTask();
@@ -41,6 +54,30 @@ public:
 
   void Exec(Option_t *option);
 
+  void ProcessEvent();
+  void ProcessEvents(Int_t size);
+
+  static ExRootTask *GetCurrentTask();
+
+  void SetProfiling(Bool_t flag);
+  Bool_t GetProfiling() const { return fProfiling; }
+
+  Long64_t GetNumberOfEvents() const { return fNumberOfEvents; }
+  Double_t GetInitTime() const { return fInitTime; }
+  Double_t GetFinishTime() const { return fFinishTime; }
+  Double_t GetWallTime() const { return fWallTime; }
+  Double_t GetCpuTime() const { return fCpuTime; }
+  Double_t GetEventWallTime() const { return fEventWallTime; }
+  Double_t GetEventCpuTime() const { return fEventCpuTime; }
+  TH1 *GetLatency() const { return fLatency; }
+
+  // hardware counters read around Process when profiling, Linux only
+  void SetCounting(Bool_t flag) { fCounting = flag; }
+  Bool_t GetCounting() const { return fCounting; }
+  Long64_t GetCounter(Int_t counter) const { return fCounters[counter]; }
+
+  static Bool_t HasCounters();
+
   int GetInt(const char *name, int defaultValue, int index = -1);
   long GetLong(const char *name, long defaultValue, int index = -1);
   double GetDouble(const char *name, double defaultValue, int index = -1);
@@ -63,6 +100,16 @@ private:
   TFolder *fFolder; //!
   ExRootConfReader *fConfReader; //!
 
+  Bool_t fProfiling; //!
+  Long64_t fNumberOfEvents; //!
+  Double_t fInitTime, fFinishTime; //!
+  Double_t fWallTime, fCpuTime; //!
+  Double_t fEventWallTime, fEventCpuTime; //!
+  TH1 *fLatency; //!
+
+  Bool_t fCounting; //!
+  Long64_t fCounters[kNumberOfCounters]; //!
+
   ClassDef(ExRootTask, 1)
 };
 
@@ -22,7 +22,7 @@
 using namespace std;
 
 ExRootTreeWriter::ExRootTreeWriter(TFile *file, const char *treeName) :
-  fFile(file), fTree(0), fTreeName(treeName)
+  fFile(file), fTree(0), fTreeName(treeName), fSkipEntry(kFALSE)
 {
 }
 
@@ -41,6 +41,14 @@ ExRootTreeWriter::~ExRootTreeWriter()
 
 //------------------------------------------------------------------------------
 
+void ExRootTreeWriter::SetTreeFile(TFile *file)
+{
+  fFile = file;
+  if(fTree) fTree->SetDirectory(fFile);
+}
+
+//------------------------------------------------------------------------------
+
 ExRootTreeBranch *ExRootTreeWriter::NewBranch(const char *name, TClass *cl)
 {
   if(!fTree) fTree = NewTree();
@@ -53,7 +61,7 @@ ExRootTreeBranch *ExRootTreeWriter::NewBranch(const char *name, TClass *cl)
 
 void ExRootTreeWriter::Fill()
 {
-  if(fTree) fTree->Fill();
+  if(fTree && !fSkipEntry) fTree->Fill();
 }
 
 //------------------------------------------------------------------------------
@@ -66,6 +74,34 @@ void ExRootTreeWriter::Write()
 
 //------------------------------------------------------------------------------
 
+void ExRootTreeWriter::Close()
+{
+  if(fTree)
+  {
+    fTree->SetDirectory(0);
+    fTree->Reset();
+  }
+  fFile = 0;
+}
+
+//------------------------------------------------------------------------------
+
+Long64_t ExRootTreeWriter::GetEntries() const
+{
+  return fTree ? fTree->GetEntries() : 0;
+}
+
+//------------------------------------------------------------------------------
+
+void ExRootTreeWriter::Checkpoint()
+{
+  if(!fTree) return;
+  fTree->SetAutoSave(0);
+  fTree->AutoSave("SaveSelf FlushBaskets");
+}
+
+//------------------------------------------------------------------------------
+
 void ExRootTreeWriter::Clear()
 {
   set<ExRootTreeBranch *>::iterator itBranches;
@@ -73,18 +109,17 @@ void ExRootTreeWriter::Clear()
   {
     (*itBranches)->Clear();
   }
+  fSkipEntry = kFALSE;
 }
 
 //------------------------------------------------------------------------------
 
 TTree *ExRootTreeWriter::NewTree()
 {
-  if(!fFile) return 0;
-
   TTree *tree = 0;
   TDirectory *dir = gDirectory;
 
-  fFile->cd();
+  if(fFile) fFile->cd();
   tree = new TTree(fTreeName, "Analysis tree");
   dir->cd();
 
@@ -93,6 +128,7 @@ TTree *ExRootTreeWriter::NewTree()
     throw runtime_error("can't create output ROOT tree");
   }
 
+  // without a file, the tree is kept in memory until SetTreeFile is called
   tree->SetDirectory(fFile);
   tree->SetAutoSave(10000000); // autosave when 10 MB written
 
@@ -24,7 +24,7 @@ public:
   ExRootTreeWriter(TFile *file = 0, const char *treeName = "Analysis");
   ~ExRootTreeWriter();
 
-  void SetTreeFile(TFile *file) { fFile = file; }
+  void SetTreeFile(TFile *file);
   void SetTreeName(const char *name) { fTreeName = name; }
 
   ExRootTreeBranch *NewBranch(const char *name, TClass *cl);
@@ -33,6 +33,19 @@ public:
   void Fill();
   void Write();
 
+  // the next Fill does not write the current entry
+  void SkipEntry() { fSkipEntry = kTRUE; }
+
+  // once written, detach the tree from its file and empty it
+  void Close();
+
+  Long64_t GetEntries() const;
+
+  // save the tree header so that the file can be recovered with the
+  // entries filled so far, after the first call the tree is only saved
+  // by Checkpoint and Write
+  void Checkpoint();
+
 private:
   TTree *NewTree();
 
@@ -41,6 +54,8 @@ private:
 
   TString fTreeName; //!
 
+  Bool_t fSkipEntry; //!
+
   std::set<ExRootTreeBranch *> fBranches; //!
 
   ClassDef(ExRootTreeWriter, 1)
@@ -13,8 +13,9 @@
 using namespace std;
 
 // x(3) track origin, p(3) track momentum at origin, Q charge, B magnetic field in Tesla
-ObsTrk::ObsTrk(TVector3 x, TVector3 p, Double_t Q, Double_t B, SolGridCov *GC)
+ObsTrk::ObsTrk(TVector3 x, TVector3 p, Double_t Q, Double_t B, SolGridCov *GC, TRandom *random)
 {
+  fRandom = random ? random : gRandom;
   fGC = GC;
   fGenX = x;
   fGenP = p;
@@ -134,7 +135,7 @@ TVectorD ObsTrk::GenToObsPar(TVectorD gPar, SolGridCov *GC)
   TMatrixD U = Chl.GetU(); // Get Upper triangular matrix
   TMatrixD Ut(TMatrixD::kTransposed, U); // Transposed of U (lower triangular)
   TVectorD r(5);
-  for (Int_t i = 0; i < 5; i++) r(i) = gRandom->Gaus(0.0, 1.0); // Array of normal random numbers
+  for (Int_t i = 0; i < 5; i++) r(i) = fRandom->Gaus(0.0, 1.0); // Array of normal random numbers
   TVectorD oPar = gPar + DCv * (Ut * r); // Observed parameter vector
 
   return oPar;
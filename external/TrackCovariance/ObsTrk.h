@@ -6,6 +6,7 @@
 #include <TMatrixDSym.h>
 
 class SolGridCov;
+class TRandom;
 
 // Class to handle smearing of generated charged particle tracks
 
@@ -28,9 +29,10 @@ private:
   TVectorD fGenPar; // Generated helix track parameters (D, phi0, C, z0, cot(th))
   TVectorD fObsPar; // Observed  helix track parameters (D, phi0, C, z0, cot(th))
   TMatrixDSym fCov; // INterpolated covariance of track parameters
+  TRandom *fRandom; // Random generator (gRandom if not set)
 public:
   // x(3) track origin, p(3) track momentum at origin, Q charge, B magnetic field in Tesla
-  ObsTrk(TVector3 x, TVector3 p, Double_t Q, Double_t B, SolGridCov *GC); // Initialize and generate smeared track
+  ObsTrk(TVector3 x, TVector3 p, Double_t Q, Double_t B, SolGridCov *GC, TRandom *random = 0); // Initialize and generate smeared track
   ~ObsTrk();
   // Service routines
   TVectorD XPtoPar(TVector3 x, TVector3 p, Double_t Q);
@@ -84,11 +84,13 @@ void ConstituentFilter::Init()
     fInputList.push_back(iterator);
   }
 
+  // the IsConstituent flag is set on the candidates of these arrays
+
   param = GetParam("ConstituentInputArray");
   size = param.GetSize();
   for(i = 0; i < size / 2; ++i)
   {
-    array = ImportArray(param[i * 2].GetString());
+    array = UpdateArray(param[i * 2].GetString());
     iterator = array->MakeIterator();
 
     fInputMap[iterator] = ExportArray(param[i * 2 + 1].GetString());
@@ -36,13 +36,13 @@
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
 #include "classes/DelphesFormula.h"
+#include "classes/DelphesPDGTable.h"
+#include "classes/DelphesRandom.h"
 
 #include "ExRootAnalysis/ExRootClassifier.h"
 #include "ExRootAnalysis/ExRootFilter.h"
 #include "ExRootAnalysis/ExRootResult.h"
 
-#include "TDatabasePDG.h"
-#include "TParticlePDG.h"
 #include "TFormula.h"
 #include "TLorentzVector.h"
 #include "TMath.h"
@@ -95,7 +95,8 @@ void DecayFilter::Finish()
 void DecayFilter::Process()
 {
   Candidate *candidate;
-  TDatabasePDG *pdgdb = TDatabasePDG::Instance();
+  DelphesPDGTable *pdg = DelphesPDGTable::Instance();
+  Int_t pdgIndex;
   const Double_t c = TMath::C(); // [m/s]
   Double_t m, t, p, bgct, L, l;
   Bool_t hasDecayed = kFALSE;
@@ -105,13 +106,13 @@ void DecayFilter::Process()
   while((candidate = static_cast<Candidate *>(fItInputArray->Next())))
   {
     // get particle information from PDG
-    TParticlePDG *pdg = pdgdb->GetParticle(candidate->PID);
-    if (!pdg) { // don't know this particle
+    pdgIndex = pdg->GetIndex(candidate->PID);
+    if (!pdg->IsKnown(pdgIndex)) { // don't know this particle
       fOutputArray->Add(candidate);
       continue;
     }    
-    m = pdg->Mass();
-    t = pdg->Lifetime(); // [s]
+    m = pdg->GetMass(pdgIndex);
+    t = pdg->GetLifetime(pdgIndex); // [s]
     if (t == 0.) { // does not decay
       fOutputArray->Add(candidate);
       continue;
@@ -123,7 +124,7 @@ void DecayFilter::Process()
 
     // get full trajectory length and generate random decay length
     L = candidate->L * 1.0E-3; // [m]
-    l = gRandom->Exp(bgct);
+    l = GetRandom()->Exp(bgct);
 
     // if random decay happens before end of trajectory, reject track
     if (l < L) continue;
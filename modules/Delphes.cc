@@ -26,10 +26,15 @@
  */
 
 #include "modules/Delphes.h"
+#include "modules/Gate.h"
 
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
 #include "classes/DelphesFormula.h"
+#include "classes/DelphesPDGTable.h"
+#include "classes/DelphesProfiler.h"
+#include "classes/DelphesRandom.h"
+#include "classes/DelphesScheduler.h"
 
 #include "ExRootAnalysis/ExRootClassifier.h"
 #include "ExRootAnalysis/ExRootConfReader.h"
@@ -37,20 +42,24 @@
 #include "ExRootAnalysis/ExRootResult.h"
 #include "ExRootAnalysis/ExRootTreeWriter.h"
 
-#include "TDatabasePDG.h"
 #include "TFolder.h"
 #include "TFormula.h"
 #include "TLorentzVector.h"
 #include "TMath.h"
 #include "TObjArray.h"
 #include "TROOT.h"
+#include "RVersion.h"
 #include "TRandom3.h"
 #include "TString.h"
 
 #include <algorithm>
+#include <iomanip>
 #include <iostream>
+#include <map>
+#include <set>
 #include <sstream>
 #include <stdexcept>
+#include <string>
 
 #include <stdio.h>
 #include <string.h>
@@ -58,7 +67,9 @@
 using namespace std;
 
 Delphes::Delphes(const char *name) :
-  fFactory(0)
+  fFactory(0), fScheduler(0), fProfiler(0), fEventNumber(0), fRandomSeed(0),
+  fNumberOfThreads(1), fBatchSize(1), fNumberOfBatchTasks(0),
+  fProfiling(kFALSE), fCounting(kFALSE)
 {
   TFolder *folder = new TFolder(name, "");
   fFactory = new DelphesFactory("ObjectFactory");
@@ -76,6 +87,8 @@ Delphes::Delphes(const char *name) :
 
 Delphes::~Delphes()
 {
+  if(fScheduler) delete fScheduler;
+  if(fProfiler) delete fProfiler;
   TFolder *folder = GetFolder();
   if(folder)
   {
@@ -96,6 +109,7 @@ void Delphes::Clear()
 
 void Delphes::SetTreeWriter(ExRootTreeWriter *treeWriter)
 {
+  fTreeWriter = treeWriter;
   treeWriter->SetName("TreeWriter");
   GetFolder()->Add(treeWriter);
 }
@@ -111,13 +125,51 @@ void Delphes::Init()
 
   TString name;
   ExRootTask *task;
+  DelphesModule *module;
   const ExRootConfReader::ExRootTaskMap *modules = confReader->GetModules();
   ExRootConfReader::ExRootTaskMap::const_iterator itModules;
 
   ExRootConfParam param = confReader->GetParam("::ExecutionPath");
   Long_t i, size = param.GetSize();
 
-  gRandom->SetSeed(confReader->GetInt("::RandomSeed", 0));
+  InitRandom();
+
+  fNumberOfThreads = confReader->GetInt("::NumberOfThreads", 1);
+  if(fNumberOfThreads > 1)
+  {
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6, 8, 0)
+    ROOT::EnableThreadSafety();
+#endif
+    fFactory->SetThreadSafe(kTRUE);
+    // build the particle table before modules look it up concurrently
+    DelphesPDGTable::Instance();
+  }
+
+  // number of events processed at once by every module
+  fBatchSize = confReader->GetInt("::BatchSize", 1);
+  if(fBatchSize < 1) fBatchSize = 1;
+  if(fBatchSize > 1 && fNumberOfThreads > 1)
+  {
+    message << "BatchSize and NumberOfThreads can't be used together";
+    throw runtime_error(message.str());
+  }
+
+  // time spent and candidates produced by every module, ProfileOutput
+  // is a JSON file or, when its name ends with .root, a ROOT file
+  fProfileOutput = confReader->GetString("::ProfileOutput", "");
+  fProfiling = confReader->GetBool("::Profiling", false) || fProfileOutput.Length() > 0;
+
+  // cycles, instructions, last level cache and branch misses per module
+  fCounting = confReader->GetBool("::PerfCounters", false);
+  if(fCounting)
+  {
+    fProfiling = kTRUE;
+    if(!ExRootTask::HasCounters())
+    {
+      cout << "** WARNING: hardware counters are not available,";
+      cout << " check /proc/sys/kernel/perf_event_paranoid" << endl;
+    }
+  }
 
   for(i = 0; i < size; ++i)
   {
@@ -129,7 +181,15 @@ void Delphes::Init()
       if(task)
       {
         task->SetFolder(GetFolder());
+        task->SetProfiling(fProfiling);
+        task->SetCounting(fCounting);
         Add(task);
+        if(task->InheritsFrom(DelphesModule::Class()))
+        {
+          module = static_cast<DelphesModule *>(task);
+          module->GetRandom()->SetKey(fRandomSeed, DelphesRandom::Hash(module->GetName()));
+          fModules.push_back(module);
+        }
       }
     }
     else
@@ -143,8 +203,517 @@ void Delphes::Init()
 
 //------------------------------------------------------------------------------
 
+void Delphes::InitRandom()
+{
+  ExRootConfReader *confReader = GetConfReader();
+
+  gRandom->SetSeed(confReader->GetInt("::RandomSeed", 0));
+
+  // key of the per-module random streams, RandomSeed 0 picks a random key
+  fRandomSeed = confReader->GetInt("::RandomSeed", 0);
+  if(fRandomSeed == 0) fRandomSeed = gRandom->Integer(kMaxUInt);
+}
+
+//------------------------------------------------------------------------------
+
+void Delphes::InitRun()
+{
+  vector<DelphesModule *>::iterator itModules;
+  DelphesModule *module;
+
+  InitRandom();
+
+  for(itModules = fModules.begin(); itModules != fModules.end(); ++itModules)
+  {
+    module = *itModules;
+    module->GetRandom()->SetKey(fRandomSeed, DelphesRandom::Hash(module->GetName()));
+    module->InitRun();
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void Delphes::CheckRunParameter(const char *name) const
+{
+  stringstream message;
+  vector<DelphesModule *>::const_iterator itModules;
+  string moduleName, parameterName = name;
+  size_t position;
+
+  if(parameterName.compare(0, 2, "::") == 0) parameterName.erase(0, 2);
+
+  position = parameterName.rfind("::");
+  if(position == string::npos)
+  {
+    if(parameterName == "RandomSeed") return;
+  }
+  else
+  {
+    moduleName = parameterName.substr(0, position);
+    parameterName.erase(0, position + 2);
+    for(itModules = fModules.begin(); itModules != fModules.end(); ++itModules)
+    {
+      if(moduleName == (*itModules)->GetName() && (*itModules)->IsRunParameter(parameterName.c_str())) return;
+    }
+  }
+
+  message << "parameter " << name << " can't be changed from one run to the next";
+  throw runtime_error(message.str());
+}
+
+//------------------------------------------------------------------------------
+
+void Delphes::InitTask()
+{
+  Int_t i, size;
+  vector<Int_t>::iterator itDependencies;
+
+  ExRootTask::InitTask();
+
+  BuildDependencies();
+  FindDeadModules();
+
+  if(fProfiling) InitProfiler();
+
+  if(fBatchSize > 1) InitBatch();
+
+  if(fNumberOfThreads > 1)
+  {
+    fScheduler = new DelphesScheduler(fNumberOfThreads);
+
+    size = fTasks.size();
+    for(i = 0; i < size; ++i)
+    {
+      fScheduler->AddTask(fTasks[i]);
+      if(fGates[i])
+      {
+        Gate *gate = fGates[i];
+        fScheduler->AddCheck(i, [gate]() { return gate->IsAccepted(); });
+      }
+    }
+
+    for(i = 0; i < size; ++i)
+    {
+      for(itDependencies = fDependencies[i].begin(); itDependencies != fDependencies[i].end(); ++itDependencies)
+      {
+        fScheduler->AddDependency(i, *itDependencies);
+      }
+    }
+
+    cout << "** INFO: processing modules on " << fNumberOfThreads << " threads" << endl;
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void Delphes::ProcessTask()
+{
+  Int_t i, size = fTasks.size();
+
+  if(fScheduler)
+  {
+    Process();
+    fScheduler->ProcessTasks();
+  }
+  else
+  {
+    ProcessEvent();
+
+    for(i = 0; i < size; ++i)
+    {
+      if(!fTasks[i]->IsActive()) continue;
+      fTasks[i]->ProcessEvent();
+      if(fGates[i] && !fGates[i]->IsAccepted()) break;
+    }
+  }
+
+  SkipRejectedEvent();
+
+  if(fProfiler) fProfiler->ProcessEvent();
+}
+
+//------------------------------------------------------------------------------
+
+void Delphes::SelectEvent(Int_t event)
+{
+  fFactory->SelectEvent(event);
+}
+
+//------------------------------------------------------------------------------
+
+void Delphes::ProcessBatch(Int_t size)
+{
+  Int_t i;
+  vector<DelphesModule *>::iterator itModules;
+
+  for(itModules = fModules.begin(); itModules != fModules.end(); ++itModules)
+  {
+    (*itModules)->SetFirstEvent(fEventNumber);
+  }
+
+  for(i = 0; i < fNumberOfBatchTasks; ++i)
+  {
+    if(fTasks[i]->IsActive()) fTasks[i]->ProcessEvents(size);
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void Delphes::ProcessBatchEvent(Int_t event)
+{
+  Int_t i, size = fTasks.size();
+  vector<DelphesModule *>::iterator itModules;
+
+  fFactory->SelectEvent(event);
+
+  for(itModules = fModules.begin(); itModules != fModules.end(); ++itModules)
+  {
+    (*itModules)->GetRandom()->SetEvent(fEventNumber + event);
+  }
+
+  for(i = fNumberOfBatchTasks; i < size; ++i)
+  {
+    if(!fTasks[i]->IsActive()) continue;
+    fTasks[i]->ProcessEvent();
+    if(fGates[i] && !fGates[i]->IsAccepted()) break;
+  }
+
+  SkipRejectedEvent();
+
+  // the memory figures cover the events of the batch processed so far
+  if(fProfiler) fProfiler->ProcessEvent();
+}
+
+//------------------------------------------------------------------------------
+
+void Delphes::SkipRejectedEvent()
+{
+  // the first gate rejecting the event stopped it, the following ones
+  // have not been processed and may hold the result of another event
+
+  Int_t i, size = fGates.size();
+
+  for(i = 0; i < size; ++i)
+  {
+    if(!fGates[i] || !fTasks[i]->IsActive() || fGates[i]->IsAccepted()) continue;
+    if(!fGates[i]->GetWriteRejected() && fTreeWriter) fTreeWriter->SkipEntry();
+    return;
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void Delphes::FinishTask()
+{
+  ExRootTask::FinishTask();
+
+  if(fProfiler)
+  {
+    fProfiler->Print();
+    if(fProfileOutput.Length() > 0) fProfiler->Write(fProfileOutput);
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void Delphes::InitProfiler()
+{
+  Int_t i, size = fTasks.size();
+  DelphesModule *module;
+  TObject *array;
+  set<string> inputs;
+  vector<string>::const_iterator itArrays;
+
+  fProfiler = new DelphesProfiler(fFactory);
+  fFactory->SetAccounting(kTRUE);
+  fProfiler->SetCounting(fCounting);
+
+  for(i = 0; i < size; ++i)
+  {
+    fProfiler->AddTask(fTasks[i]);
+    if(!fTasks[i]->InheritsFrom(DelphesModule::Class())) continue;
+
+    module = static_cast<DelphesModule *>(fTasks[i]);
+    inputs.clear();
+    for(itArrays = module->GetImportedArrays().begin(); itArrays != module->GetImportedArrays().end(); ++itArrays)
+    {
+      if(!inputs.insert(*itArrays).second) continue;
+      array = GetObject(Form("Export/%s", itArrays->c_str()), TObjArray::Class());
+      if(array) fProfiler->AddArray(i, itArrays->c_str(), static_cast<TObjArray *>(array), kFALSE);
+    }
+    for(itArrays = module->GetExportedArrays().begin(); itArrays != module->GetExportedArrays().end(); ++itArrays)
+    {
+      array = GetObject(Form("Export/%s", itArrays->c_str()), TObjArray::Class());
+      if(array) fProfiler->AddArray(i, itArrays->c_str(), static_cast<TObjArray *>(array), kTRUE);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void Delphes::InitBatch()
+{
+  // the tree branches are filled one event at a time, so the modules
+  // writing them and all the following ones are processed event by event,
+  // as are the gates that stop single events and the following modules
+
+  Int_t i, size = fTasks.size();
+
+  fFactory->SetBatchSize(fBatchSize);
+
+  for(i = 0; i < size; ++i)
+  {
+    if(!fTasks[i]->InheritsFrom(DelphesModule::Class())) break;
+    if(static_cast<DelphesModule *>(fTasks[i])->HasBranches() || fGates[i]) break;
+  }
+
+  fNumberOfBatchTasks = i;
+
+  cout << "** INFO: processing " << fNumberOfBatchTasks << " modules";
+  cout << " on batches of " << fBatchSize << " events" << endl;
+}
+
+//------------------------------------------------------------------------------
+
+void Delphes::BuildDependencies()
+{
+  // Modules are ordered as in the execution path whenever they can
+  // interfere: a module depends on the producers of the arrays it imports,
+  // and a module that modifies an imported array in place is kept in order
+  // with every module reading the same array, one of its ancestors or one
+  // of its descendants, since candidates are shared between these arrays.
+  // A gate is processed after all the previous modules and before all the
+  // following ones, which it can skip.
+
+  Int_t i, j, producer, size;
+  TIter itTasks(GetListOfTasks());
+  ExRootTask *task;
+  DelphesModule *module;
+  string array;
+
+  vector<set<Int_t> > dependencies;
+  vector<set<string> > inputs, outputs, updates;
+  vector<Bool_t> barriers;
+  map<string, Int_t> producers;
+  map<string, vector<Int_t> > consumers;
+  set<string> related;
+  vector<string> stack;
+
+  map<string, Int_t>::iterator itProducers;
+  map<string, vector<Int_t> >::iterator itConsumers;
+  set<string>::iterator itArrays, itUpdates;
+  vector<Int_t>::iterator itModules;
+
+  fTasks.clear();
+  fDependencies.clear();
+  fGates.clear();
+
+  while((task = static_cast<ExRootTask *>(itTasks.Next())))
+  {
+    i = fTasks.size();
+    fTasks.push_back(task);
+    fGates.push_back(task->InheritsFrom(Gate::Class()) ? static_cast<Gate *>(task) : 0);
+    inputs.push_back(set<string>());
+    outputs.push_back(set<string>());
+    updates.push_back(set<string>());
+
+    // tasks that do not declare their arrays are processed in order with all others
+    barriers.push_back(!task->InheritsFrom(DelphesModule::Class()) || fGates[i]);
+    if(barriers.back()) continue;
+
+    module = static_cast<DelphesModule *>(task);
+    inputs[i].insert(module->GetImportedArrays().begin(), module->GetImportedArrays().end());
+    updates[i].insert(module->GetUpdatedArrays().begin(), module->GetUpdatedArrays().end());
+    outputs[i].insert(module->GetExportedArrays().begin(), module->GetExportedArrays().end());
+
+    for(itArrays = outputs[i].begin(); itArrays != outputs[i].end(); ++itArrays)
+    {
+      producers[*itArrays] = i;
+    }
+    for(itArrays = inputs[i].begin(); itArrays != inputs[i].end(); ++itArrays)
+    {
+      consumers[*itArrays].push_back(i);
+    }
+  }
+
+  size = fTasks.size();
+  dependencies.resize(size);
+
+  for(i = 0; i < size; ++i)
+  {
+    for(j = 0; j < size; ++j)
+    {
+      if(j < i && (barriers[i] || barriers[j])) dependencies[i].insert(j);
+    }
+
+    for(itArrays = inputs[i].begin(); itArrays != inputs[i].end(); ++itArrays)
+    {
+      itProducers = producers.find(*itArrays);
+      if(itProducers == producers.end()) continue;
+      producer = itProducers->second;
+      if(producer < i) dependencies[i].insert(producer);
+      if(producer > i) dependencies[producer].insert(i);
+    }
+
+    for(itUpdates = updates[i].begin(); itUpdates != updates[i].end(); ++itUpdates)
+    {
+      // collect the updated array with all its ancestors and descendants
+      related.clear();
+      related.insert(*itUpdates);
+
+      stack.assign(1, *itUpdates);
+      while(!stack.empty())
+      {
+        array = stack.back();
+        stack.pop_back();
+        itProducers = producers.find(array);
+        if(itProducers == producers.end()) continue;
+        for(itArrays = inputs[itProducers->second].begin(); itArrays != inputs[itProducers->second].end(); ++itArrays)
+        {
+          if(related.insert(*itArrays).second) stack.push_back(*itArrays);
+        }
+      }
+
+      stack.assign(1, *itUpdates);
+      while(!stack.empty())
+      {
+        array = stack.back();
+        stack.pop_back();
+        itConsumers = consumers.find(array);
+        if(itConsumers == consumers.end()) continue;
+        for(itModules = itConsumers->second.begin(); itModules != itConsumers->second.end(); ++itModules)
+        {
+          for(itArrays = outputs[*itModules].begin(); itArrays != outputs[*itModules].end(); ++itArrays)
+          {
+            if(related.insert(*itArrays).second) stack.push_back(*itArrays);
+          }
+        }
+      }
+
+      for(itArrays = related.begin(); itArrays != related.end(); ++itArrays)
+      {
+        itConsumers = consumers.find(*itArrays);
+        if(itConsumers == consumers.end()) continue;
+        for(itModules = itConsumers->second.begin(); itModules != itConsumers->second.end(); ++itModules)
+        {
+          j = *itModules;
+          if(j < i) dependencies[i].insert(j);
+          if(j > i) dependencies[j].insert(i);
+        }
+      }
+    }
+  }
+
+  fDependencies.resize(size);
+  for(i = 0; i < size; ++i)
+  {
+    fDependencies[i].assign(dependencies[i].begin(), dependencies[i].end());
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void Delphes::FindDeadModules()
+{
+  // A module is needed when it writes tree branches, when it is listed in
+  // SideEffectModules, when it is a gate or when one of the arrays it
+  // exports or updates is imported by a needed module. The other modules
+  // are reported and, with SkipDeadModules, are not processed.
+
+  Int_t i, j, size = fTasks.size();
+  Bool_t changed, found;
+  ExRootConfReader *confReader = GetConfReader();
+  ExRootConfParam param = confReader->GetParam("::SideEffectModules");
+  Bool_t skip = confReader->GetBool("::SkipDeadModules", false);
+  DelphesModule *module;
+
+  set<string> sideEffects, arrays;
+  vector<Bool_t> needed(size, kFALSE);
+  vector<string>::const_iterator itArrays;
+
+  for(i = 0; i < param.GetSize(); ++i)
+  {
+    sideEffects.insert(param[i].GetString());
+  }
+
+  found = kFALSE;
+  for(i = 0; i < size; ++i)
+  {
+    if(!fTasks[i]->InheritsFrom(DelphesModule::Class()) || fGates[i])
+    {
+      needed[i] = kTRUE;
+      continue;
+    }
+    module = static_cast<DelphesModule *>(fTasks[i]);
+    if(module->HasBranches() || sideEffects.count(module->GetName()))
+    {
+      needed[i] = kTRUE;
+      found = kTRUE;
+    }
+  }
+
+  // without any tree branch nor side effect every module is kept
+  if(!found) return;
+
+  do
+  {
+    changed = kFALSE;
+
+    arrays.clear();
+    for(j = 0; j < size; ++j)
+    {
+      if(!needed[j] || !fTasks[j]->InheritsFrom(DelphesModule::Class())) continue;
+      module = static_cast<DelphesModule *>(fTasks[j]);
+      arrays.insert(module->GetImportedArrays().begin(), module->GetImportedArrays().end());
+    }
+
+    for(i = 0; i < size; ++i)
+    {
+      if(needed[i]) continue;
+      module = static_cast<DelphesModule *>(fTasks[i]);
+
+      for(itArrays = module->GetExportedArrays().begin(); itArrays != module->GetExportedArrays().end(); ++itArrays)
+      {
+        if(arrays.count(*itArrays)) needed[i] = kTRUE;
+      }
+      for(itArrays = module->GetUpdatedArrays().begin(); itArrays != module->GetUpdatedArrays().end(); ++itArrays)
+      {
+        if(arrays.count(*itArrays)) needed[i] = kTRUE;
+      }
+
+      if(needed[i]) changed = kTRUE;
+    }
+  } while(changed);
+
+  for(i = 0; i < size; ++i)
+  {
+    if(needed[i]) continue;
+
+    cout << left;
+    cout << setw(30) << "** INFO: unused module";
+    cout << setw(25) << fTasks[i]->GetName();
+    if(skip)
+    {
+      cout << " (skipped)";
+      fTasks[i]->SetActive(kFALSE);
+    }
+    cout << endl;
+  }
+}
+
+//------------------------------------------------------------------------------
+
 void Delphes::Process()
 {
+  vector<DelphesModule *>::iterator itModules;
+
+  // position every module stream at the current event
+  for(itModules = fModules.begin(); itModules != fModules.end(); ++itModules)
+  {
+    (*itModules)->GetRandom()->SetEvent(fEventNumber);
+  }
+
+  ++fEventNumber;
 }
 
 //------------------------------------------------------------------------------
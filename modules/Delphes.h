@@ -30,12 +30,18 @@
 
 #include "classes/DelphesModule.h"
 
+#include <vector>
+
 class TFolder;
 class TObjArray;
 
 class ExRootTreeWriter;
 
 class DelphesFactory;
+class DelphesProfiler;
+class DelphesScheduler;
+
+class Gate;
 
 class Delphes: public DelphesModule
 {
@@ -47,14 +53,80 @@ public:
 
   DelphesFactory *GetFactory() const { return fFactory; }
 
+  void SetEventNumber(Long64_t number) { fEventNumber = number; }
+  Long64_t GetEventNumber() const { return fEventNumber; }
+
+  // key of the module random streams, the RandomSeed parameter
+  // or the key drawn when RandomSeed is 0
+  UInt_t GetRandomSeed() const { return fRandomSeed; }
+
+  // file written by FinishTask when profiling, ProfileOutput by default
+  void SetProfileOutput(const char *fileName) { fProfileOutput = fileName; }
+  const char *GetProfileOutput() const { return fProfileOutput; }
+
   void Clear();
 
+  // With BatchSize larger than one, the reader fills the arrays of up to
+  // BatchSize events, each one after SelectEvent, and calls ProcessBatch.
+  // The modules up to the first one writing tree branches process the whole
+  // batch, the remaining ones are processed event by event with
+  // ProcessBatchEvent. The event number is the one of the first event.
+
+  Int_t GetBatchSize() const { return fBatchSize; }
+
+  void SelectEvent(Int_t event);
+
+  void ProcessBatch(Int_t size);
+  void ProcessBatchEvent(Int_t event);
+
+  virtual void InitTask();
+  virtual void ProcessTask();
+  virtual void FinishTask();
+
   virtual void Init();
   virtual void Process();
   virtual void Finish();
 
+  // start a new run with the current RandomSeed and module parameters
+  virtual void InitRun();
+
+  // throw if a parameter is not read again by InitRun,
+  // its new value would be ignored by the following runs
+  void CheckRunParameter(const char *name) const;
+
 private:
+  void InitRandom();
+  void BuildDependencies();
+  void FindDeadModules();
+  void InitProfiler();
+  void InitBatch();
+  void SkipRejectedEvent();
+
   DelphesFactory *fFactory;
+  DelphesScheduler *fScheduler; //!
+  DelphesProfiler *fProfiler; //!
+
+  Long64_t fEventNumber; //!
+  UInt_t fRandomSeed; //!
+  Int_t fNumberOfThreads; //!
+  Int_t fBatchSize; //!
+  Int_t fNumberOfBatchTasks; //!
+
+  Bool_t fProfiling; //!
+  Bool_t fCounting; //!
+  TString fProfileOutput; //!
+
+#if !defined(__CINT__) && !defined(__CLING__)
+  std::vector<DelphesModule *> fModules; //!
+
+  // modules in execution path order and, for each of them,
+  // the modules that have to be processed before
+  std::vector<ExRootTask *> fTasks; //!
+  std::vector<std::vector<Int_t> > fDependencies; //!
+
+  // gate modules, in execution path order with the tasks
+  std::vector<Gate *> fGates; //!
+#endif
 
   ClassDef(Delphes, 1)
 };
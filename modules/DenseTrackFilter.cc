@@ -29,6 +29,7 @@
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
 #include "classes/DelphesFormula.h"
+#include "classes/DelphesRandom.h"
 
 #include "ExRootAnalysis/ExRootClassifier.h"
 #include "ExRootAnalysis/ExRootFilter.h"
@@ -156,7 +157,7 @@ void DenseTrackFilter::Process()
   number = -1;
   while((track = static_cast<Candidate *>(fItTrackInputArray->Next())))
   {
-    const TLorentzVector &trackPosition = track->Position;
+    const DelphesLorentzVector &trackPosition = track->Position;
     ++number;
 
     // find eta bin [1, fEtaBins.size - 1]
@@ -250,8 +251,8 @@ void DenseTrackFilter::FillTrack()
   pt = candidate->Momentum.Pt();
   eta = candidate->Momentum.Eta();
   phi = candidate->Momentum.Phi();
-  eta = gRandom->Gaus(eta, fEtaPhiRes);
-  phi = gRandom->Gaus(phi, fEtaPhiRes);
+  eta = GetRandom()->Gaus(eta, fEtaPhiRes);
+  phi = GetRandom()->Gaus(phi, fEtaPhiRes);
   candidate->Momentum.SetPtEtaPhiE(pt, eta, phi, pt * TMath::CosH(eta));
   candidate->AddCandidate(track);
 
@@ -36,6 +36,7 @@
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
 #include "classes/DelphesFormula.h"
+#include "classes/DelphesRandom.h"
 
 #include "ExRootAnalysis/ExRootResult.h"
 #include "ExRootAnalysis/ExRootFilter.h"
@@ -148,8 +149,8 @@ void DualReadoutCalorimeter::Init()
   size = param.GetSize();
 
   // set default energy fractions values
-  fFractionMap.clear();
-  fFractionMap[0] = make_pair(0.0, 1.0);
+  fFractionMap.Clear();
+  fFractionMap.Set(0, make_pair(0.0, 1.0));
 
   for(i = 0; i < size/2; ++i)
   {
@@ -158,7 +159,7 @@ void DualReadoutCalorimeter::Init()
     ecalFraction = paramFractions[0].GetDouble();
     hcalFraction = paramFractions[1].GetDouble();
 
-    fFractionMap[param[i*2].GetInt()] = make_pair(ecalFraction, hcalFraction);
+    fFractionMap.Set(param[i*2].GetInt(), make_pair(ecalFraction, hcalFraction));
   }
 
   // read min E value for timing measurement in ECAL
@@ -226,8 +227,6 @@ void DualReadoutCalorimeter::Process()
   Double_t energyGuess, energy;
   Int_t pdgCode;
 
-  TFractionMap::iterator itFractionMap;
-
   vector< Double_t >::iterator itEtaBin;
   vector< Double_t >::iterator itPhiBin;
   vector< Double_t > *phiBins;
@@ -246,19 +245,14 @@ void DualReadoutCalorimeter::Process()
   number = -1;
   while((particle = static_cast<Candidate*>(fItParticleInputArray->Next())))
   {
-    const TLorentzVector &particlePosition = particle->Position;
+    const DelphesLorentzVector &particlePosition = particle->Position;
     ++number;
 
     pdgCode = TMath::Abs(particle->PID);
 
-    itFractionMap = fFractionMap.find(pdgCode);
-    if(itFractionMap == fFractionMap.end())
-    {
-      itFractionMap = fFractionMap.find(0);
-    }
-
-    ecalFraction = itFractionMap->second.first;
-    hcalFraction = itFractionMap->second.second;
+    const pair<Double_t, Double_t> &fractions = fFractionMap[pdgCode];
+    ecalFraction = fractions.first;
+    hcalFraction = fractions.second;
 
     fECalTowerFractions.push_back(ecalFraction);
     fHCalTowerFractions.push_back(hcalFraction);
@@ -292,19 +286,14 @@ void DualReadoutCalorimeter::Process()
   number = -1;
   while((track = static_cast<Candidate*>(fItTrackInputArray->Next())))
   {
-    const TLorentzVector &trackPosition = track->Position;
+    const DelphesLorentzVector &trackPosition = track->Position;
     ++number;
 
     pdgCode = TMath::Abs(track->PID);
 
-    itFractionMap = fFractionMap.find(pdgCode);
-    if(itFractionMap == fFractionMap.end())
-    {
-      itFractionMap = fFractionMap.find(0);
-    }
-
-    ecalFraction = itFractionMap->second.first;
-    hcalFraction = itFractionMap->second.second;
+    const pair<Double_t, Double_t> &fractions = fFractionMap[pdgCode];
+    ecalFraction = fractions.first;
+    hcalFraction = fractions.second;
 
     fECalTrackFractions.push_back(ecalFraction);
     fHCalTrackFractions.push_back(hcalFraction);
@@ -407,7 +396,7 @@ void DualReadoutCalorimeter::Process()
       {
         if(fElectronsFromTrack)
         {
-          fTower->ECalEnergyTimePairs.push_back(make_pair<Float_t, Float_t>(ecalEnergy, track->Position.T()));
+          fTower->Timing()->ECalEnergyTimePairs.push_back(make_pair<Float_t, Float_t>(ecalEnergy, track->Position.T()));
         }
       }
 
@@ -488,7 +477,7 @@ void DualReadoutCalorimeter::Process()
     {
       if (abs(particle->PID) != 11 || !fElectronsFromTrack)
       {
-        fTower->ECalEnergyTimePairs.push_back(make_pair<Float_t, Float_t>(ecalEnergy, particle->Position.T()));
+        fTower->Timing()->ECalEnergyTimePairs.push_back(make_pair<Float_t, Float_t>(ecalEnergy, particle->Position.T()));
       }
     }
 
@@ -505,6 +494,7 @@ void DualReadoutCalorimeter::FinalizeTower()
 {
 
   Candidate *track, *tower, *mother;
+  const CandidateTiming *timing;
   Double_t energy, pt, eta, phi;
   Double_t ecalEnergy, hcalEnergy;
   Double_t ecalNeutralEnergy, hcalNeutralEnergy, neutralEnergy;
@@ -515,7 +505,6 @@ void DualReadoutCalorimeter::FinalizeTower()
   Double_t weightTrack, weightCalo, bestEnergyEstimate, rescaleFactor;
   
   TLorentzVector momentum;
-  TFractionMap::iterator itFractionMap;
 
   Float_t weight, sumWeightedTime, sumWeight;
 
@@ -571,8 +560,8 @@ void DualReadoutCalorimeter::FinalizeTower()
 
   if(fSmearTowerCenter)
   {
-    eta = gRandom->Uniform(fTowerEdges[0], fTowerEdges[1]);
-    phi = gRandom->Uniform(fTowerEdges[2], fTowerEdges[3]);
+    eta = GetRandom()->Uniform(fTowerEdges[0], fTowerEdges[1]);
+    phi = GetRandom()->Uniform(fTowerEdges[2], fTowerEdges[3]);
   }
   else
   {
@@ -583,18 +572,20 @@ void DualReadoutCalorimeter::FinalizeTower()
   pt = energy / TMath::CosH(eta);
 
   // Time calculation for tower
-  fTower->NTimeHits = 0;
+  timing = fTower->GetTiming();
   sumWeightedTime = 0.0;
   sumWeight = 0.0;
 
-  for(size_t i = 0; i < fTower->ECalEnergyTimePairs.size(); ++i)
+  for(size_t i = 0; i < timing->ECalEnergyTimePairs.size(); ++i)
   {
-    weight = TMath::Sqrt(fTower->ECalEnergyTimePairs[i].first);
-    sumWeightedTime += weight * fTower->ECalEnergyTimePairs[i].second;
+    weight = TMath::Sqrt(timing->ECalEnergyTimePairs[i].first);
+    sumWeightedTime += weight * timing->ECalEnergyTimePairs[i].second;
     sumWeight += weight;
-    fTower->NTimeHits++;
   }
 
+  // towers without time measurements keep the default timing payload
+  if(!timing->ECalEnergyTimePairs.empty()) fTower->Timing()->NTimeHits = timing->ECalEnergyTimePairs.size();
+
   if(sumWeight > 0.0)
   {
     fTower->Position.SetPtEtaPhiE(1.0, eta, phi, sumWeightedTime/sumWeight);
@@ -813,7 +804,7 @@ Double_t DualReadoutCalorimeter::LogNormal(Double_t mean, Double_t sigma)
     b = TMath::Sqrt(TMath::Log((1.0 + (sigma*sigma)/(mean*mean))));
     a = TMath::Log(mean) - 0.5*b*b;
 
-    return TMath::Exp(a + b*gRandom->Gaus(0.0, 1.0));
+    return TMath::Exp(a + b*GetRandom()->Gaus(0.0, 1.0));
   }
   else
   {
@@ -29,6 +29,7 @@
  */
 
 #include "classes/DelphesModule.h"
+#include "classes/DelphesPDGTable.h"
 
 #include <map>
 #include <set>
@@ -51,7 +52,7 @@ public:
 
 private:
 
-  typedef std::map< Long64_t, std::pair< Double_t, Double_t > > TFractionMap; //!
+  typedef DelphesPDGMap<std::pair<Double_t, Double_t> > TFractionMap; //!
   typedef std::map< Double_t, std::set< Double_t > > TBinMap; //!
 
   Candidate *fTower;
@@ -29,6 +29,7 @@
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
 #include "classes/DelphesFormula.h"
+#include "classes/DelphesRandom.h"
 
 #include "ExRootAnalysis/ExRootClassifier.h"
 #include "ExRootAnalysis/ExRootFilter.h"
@@ -52,7 +53,7 @@ using namespace std;
 //------------------------------------------------------------------------------
 
 Efficiency::Efficiency() :
-  fFormula(0), fItInputArray(0)
+  fFormula(0)
 {
   fFormula = new DelphesFormula;
 }
@@ -75,7 +76,6 @@ void Efficiency::Init()
   // import input array
 
   fInputArray = ImportArray(GetString("InputArray", "ParticlePropagator/stableParticles"));
-  fItInputArray = fInputArray->MakeIterator();
 
   // create output array
 
@@ -86,30 +86,48 @@ void Efficiency::Init()
 
 void Efficiency::Finish()
 {
-  if(fItInputArray) delete fItInputArray;
 }
 
 //------------------------------------------------------------------------------
 
 void Efficiency::Process()
 {
-  Candidate *candidate;
+  ProcessArray(fInputArray, fOutputArray);
+}
+
+//------------------------------------------------------------------------------
+
+void Efficiency::ProcessBatch(Int_t size)
+{
+  Int_t event;
+
+  // read the arrays of every event without selecting the events
+  for(event = 0; event < size; ++event)
+  {
+    SelectRandomEvent(event);
+    ProcessArray(GetEventArray(fInputArray, event), GetEventArray(fOutputArray, event));
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void Efficiency::ProcessArray(const TObjArray *inputArray, TObjArray *outputArray)
+{
   Double_t pt, eta, phi, e;
 
-  fItInputArray->Reset();
-  while((candidate = static_cast<Candidate *>(fItInputArray->Next())))
+  for(Candidate *candidate : DelphesArrayView<Candidate>(inputArray))
   {
-    const TLorentzVector &candidatePosition = candidate->Position;
-    const TLorentzVector &candidateMomentum = candidate->Momentum;
+    const DelphesLorentzVector &candidatePosition = candidate->Position;
+    const DelphesLorentzVector &candidateMomentum = candidate->Momentum;
     eta = candidatePosition.Eta();
     phi = candidatePosition.Phi();
     pt = candidateMomentum.Pt();
     e = candidateMomentum.E();
     
     // apply an efficency formula
-    if(gRandom->Uniform() > fFormula->Eval(pt, eta, phi, e, candidate)) continue;
+    if(GetRandom()->Uniform() > fFormula->Eval(pt, eta, phi, e, candidate)) continue;
 
-    fOutputArray->Add(candidate);
+    outputArray->Add(candidate);
   }
 }
 
@@ -29,6 +29,7 @@
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
 #include "classes/DelphesFormula.h"
+#include "classes/DelphesRandom.h"
 
 #include "ExRootAnalysis/ExRootClassifier.h"
 #include "ExRootAnalysis/ExRootFilter.h"
@@ -52,7 +53,7 @@ using namespace std;
 //------------------------------------------------------------------------------
 
 EnergySmearing::EnergySmearing() :
-  fFormula(0), fItInputArray(0)
+  fFormula(0)
 {
   fFormula = new DelphesFormula;
 }
@@ -75,7 +76,6 @@ void EnergySmearing::Init()
   // import input array
 
   fInputArray = ImportArray(GetString("InputArray", "ParticlePropagator/stableParticles"));
-  fItInputArray = fInputArray->MakeIterator();
 
   // create output array
 
@@ -86,21 +86,39 @@ void EnergySmearing::Init()
 
 void EnergySmearing::Finish()
 {
-  if(fItInputArray) delete fItInputArray;
 }
 
 //------------------------------------------------------------------------------
 
 void EnergySmearing::Process()
 {
-  Candidate *candidate, *mother;
+  ProcessArray(fInputArray, fOutputArray);
+}
+
+//------------------------------------------------------------------------------
+
+void EnergySmearing::ProcessBatch(Int_t size)
+{
+  Int_t event;
+
+  for(event = 0; event < size; ++event)
+  {
+    SelectRandomEvent(event);
+    ProcessArray(GetEventArray(fInputArray, event), GetEventArray(fOutputArray, event));
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void EnergySmearing::ProcessArray(const TObjArray *inputArray, TObjArray *outputArray)
+{
+  Candidate *mother;
   Double_t pt, energy, eta, phi;
 
-  fItInputArray->Reset();
-  while((candidate = static_cast<Candidate *>(fItInputArray->Next())))
+  for(Candidate *candidate : DelphesArrayView<Candidate>(inputArray))
   {
-    const TLorentzVector &candidatePosition = candidate->Position;
-    const TLorentzVector &candidateMomentum = candidate->Momentum;
+    const DelphesLorentzVector &candidatePosition = candidate->Position;
+    const DelphesLorentzVector &candidateMomentum = candidate->Momentum;
 
     pt = candidatePosition.Pt();
     eta = candidatePosition.Eta();
@@ -108,7 +126,7 @@ void EnergySmearing::Process()
     energy = candidateMomentum.E();
 
     // apply smearing formula
-    energy = gRandom->Gaus(energy, fFormula->Eval(pt, eta, phi, energy));
+    energy = GetRandom()->Gaus(energy, fFormula->Eval(pt, eta, phi, energy));
 
     if(energy <= 0.0) continue;
 
@@ -120,7 +138,7 @@ void EnergySmearing::Process()
     candidate->TrackResolution = fFormula->Eval(pt, eta, phi, energy) / candidateMomentum.E();
     candidate->AddCandidate(mother);
 
-    fOutputArray->Add(candidate);
+    outputArray->Add(candidate);
   }
 }
 
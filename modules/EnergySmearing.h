@@ -29,7 +29,6 @@
 
 #include "classes/DelphesModule.h"
 
-class TIterator;
 class TObjArray;
 class DelphesFormula;
 
@@ -41,12 +40,13 @@ public:
 
   void Init();
   void Process();
+  void ProcessBatch(Int_t size);
   void Finish();
 
 private:
-  DelphesFormula *fFormula; //!
+  void ProcessArray(const TObjArray *inputArray, TObjArray *outputArray);
 
-  TIterator *fItInputArray; //!
+  DelphesFormula *fFormula; //!
 
   const TObjArray *fInputArray; //!
 
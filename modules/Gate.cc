@@ -0,0 +1,144 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** \class Gate
+ *
+ *  Stops the processing of the events that do not meet its requirements:
+ *  the modules following the gate in the execution path are skipped and,
+ *  unless WriteRejected is set, the event is not written.
+ *
+ *  Each requirement asks for a minimum number of candidates, taken from
+ *  a list of input arrays, for which the selection formula is non-zero.
+ *
+ */
+
+#include "modules/Gate.h"
+
+#include "classes/DelphesClasses.h"
+#include "classes/DelphesFormula.h"
+
+#include "TObjArray.h"
+
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+
+Gate::Gate() :
+  fAccepted(kTRUE), fWriteRejected(kFALSE)
+{
+}
+
+//------------------------------------------------------------------------------
+
+Gate::~Gate()
+{
+}
+
+//------------------------------------------------------------------------------
+
+void Gate::Init()
+{
+  stringstream message;
+  ExRootConfParam param, paramArrays;
+  Long_t i, j, size, sizeArrays;
+  DelphesFormula *formula;
+
+  fWriteRejected = GetBool("WriteRejected", false);
+
+  // read requirements: list of input arrays, minimum number of candidates
+  // and selection formula
+
+  param = GetParam("Requirement");
+  size = param.GetSize();
+
+  if(size == 0 || size % 3 != 0)
+  {
+    message << "module '" << GetName() << "' needs requirements made of";
+    message << " input arrays, minimum number of candidates and selection formula";
+    throw runtime_error(message.str());
+  }
+
+  for(i = 0; i < size / 3; ++i)
+  {
+    fInputArrays.push_back(vector<const TObjArray *>());
+
+    paramArrays = param[i * 3];
+    sizeArrays = paramArrays.GetSize();
+    for(j = 0; j < sizeArrays; ++j)
+    {
+      fInputArrays.back().push_back(ImportArray(paramArrays[j].GetString()));
+    }
+
+    fMinimumCounts.push_back(param[i * 3 + 1].GetInt());
+
+    formula = new DelphesFormula;
+    formula->Compile(param[i * 3 + 2].GetString());
+    fFormulas.push_back(formula);
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void Gate::Finish()
+{
+  vector<DelphesFormula *>::iterator itFormulas;
+
+  for(itFormulas = fFormulas.begin(); itFormulas != fFormulas.end(); ++itFormulas)
+  {
+    delete *itFormulas;
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void Gate::Process()
+{
+  Int_t count;
+  Double_t pt, eta, phi, e;
+  size_t i;
+  vector<const TObjArray *>::iterator itInputArrays;
+
+  fAccepted = kTRUE;
+
+  for(i = 0; i < fFormulas.size() && fAccepted; ++i)
+  {
+    count = 0;
+    for(itInputArrays = fInputArrays[i].begin(); itInputArrays != fInputArrays[i].end(); ++itInputArrays)
+    {
+      for(Candidate *candidate : DelphesArrayView<Candidate>(*itInputArrays))
+      {
+        const DelphesLorentzVector &candidateMomentum = candidate->Momentum;
+        pt = candidateMomentum.Pt();
+        eta = candidateMomentum.Eta();
+        phi = candidateMomentum.Phi();
+        e = candidateMomentum.E();
+
+        if(fFormulas[i]->Eval(pt, eta, phi, e, candidate) != 0.0) ++count;
+        if(count >= fMinimumCounts[i]) break;
+      }
+      if(count >= fMinimumCounts[i]) break;
+    }
+
+    fAccepted = (count >= fMinimumCounts[i]);
+  }
+}
+
+//------------------------------------------------------------------------------
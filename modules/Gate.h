@@ -0,0 +1,64 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef Gate_h
+#define Gate_h
+
+/** \class Gate
+ *
+ *  Stops the processing of the events that do not meet its requirements:
+ *  the modules following the gate in the execution path are skipped and,
+ *  unless WriteRejected is set, the event is not written.
+ *
+ *  Each requirement asks for a minimum number of candidates, taken from
+ *  a list of input arrays, for which the selection formula is non-zero.
+ *
+ */
+
+#include "classes/DelphesModule.h"
+
+#include <vector>
+
+class TObjArray;
+class DelphesFormula;
+
+class Gate: public DelphesModule
+{
+public:
+  Gate();
+  ~Gate();
+
+  void Init();
+  void Process();
+  void Finish();
+
+  Bool_t IsAccepted() const { return fAccepted; }
+  Bool_t GetWriteRejected() const { return fWriteRejected; }
+
+private:
+  Bool_t fAccepted; //!
+  Bool_t fWriteRejected; //!
+
+  std::vector<std::vector<const TObjArray *> > fInputArrays; //!
+  std::vector<Int_t> fMinimumCounts; //!
+  std::vector<DelphesFormula *> fFormulas; //!
+
+  ClassDef(Gate, 1)
+};
+
+#endif
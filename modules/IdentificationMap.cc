@@ -30,6 +30,7 @@
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
 #include "classes/DelphesFormula.h"
+#include "classes/DelphesRandom.h"
 
 #include "ExRootAnalysis/ExRootClassifier.h"
 #include "ExRootAnalysis/ExRootFilter.h"
@@ -68,6 +69,7 @@ IdentificationMap::~IdentificationMap()
 void IdentificationMap::Init()
 {
   TMisIDMap::iterator itEfficiencyMap;
+  TMisIDRange range;
   ExRootConfParam param;
   DelphesFormula *formula;
   Int_t i, size, pdg;
@@ -95,9 +97,20 @@ void IdentificationMap::Init()
     fEfficiencyMap.insert(make_pair(0, make_pair(0, formula)));
   }
 
+  // a PDG code without formulas uses the formulas of the opposite code,
+  // or otherwise the formulas of code 0
+  fRangeMap.Clear();
+  for(itEfficiencyMap = fEfficiencyMap.begin(); itEfficiencyMap != fEfficiencyMap.end(); itEfficiencyMap = range.second)
+  {
+    pdg = itEfficiencyMap->first;
+    range = fEfficiencyMap.equal_range(pdg);
+    fRangeMap.Set(pdg, range);
+    if(fEfficiencyMap.find(-pdg) == fEfficiencyMap.end()) fRangeMap.Set(-pdg, range);
+  }
+
   // import input array
 
-  fInputArray = ImportArray(GetString("InputArray", "ParticlePropagator/stableParticles"));
+  fInputArray = UpdateArray(GetString("InputArray", "ParticlePropagator/stableParticles"));
   fItInputArray = fInputArray->MakeIterator();
 
   // create output array
@@ -126,8 +139,7 @@ void IdentificationMap::Process()
 {
   Candidate *candidate;
   Double_t pt, eta, phi, e;
-  TMisIDMap::iterator itEfficiencyMap;
-  pair<TMisIDMap::iterator, TMisIDMap::iterator> range;
+  TMisIDRange range;
   DelphesFormula *formula;
   Int_t pdgCodeIn, pdgCodeOut, charge;
 
@@ -136,8 +148,8 @@ void IdentificationMap::Process()
   fItInputArray->Reset();
   while((candidate = static_cast<Candidate *>(fItInputArray->Next())))
   {
-    const TLorentzVector &candidatePosition = candidate->Position;
-    const TLorentzVector &candidateMomentum = candidate->Momentum;
+    const DelphesLorentzVector &candidatePosition = candidate->Position;
+    const DelphesLorentzVector &candidateMomentum = candidate->Momentum;
     eta = candidatePosition.Eta();
     phi = candidatePosition.Phi();
     pt = candidateMomentum.Pt();
@@ -149,13 +161,9 @@ void IdentificationMap::Process()
     // first check that PID of this particle is specified in the map
     // otherwise, look for PID = 0
 
-    itEfficiencyMap = fEfficiencyMap.find(pdgCodeIn);
-
-    range = fEfficiencyMap.equal_range(pdgCodeIn);
-    if(range.first == range.second) range = fEfficiencyMap.equal_range(-pdgCodeIn);
-    if(range.first == range.second) range = fEfficiencyMap.equal_range(0);
+    range = fRangeMap[pdgCodeIn];
 
-    r = gRandom->Uniform();
+    r = GetRandom()->Uniform();
     total = 0.0;
 
     // loop over sub-map for this PID
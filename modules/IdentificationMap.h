@@ -29,6 +29,7 @@
  */
 
 #include "classes/DelphesModule.h"
+#include "classes/DelphesPDGTable.h"
 
 class TIterator;
 class TObjArray;
@@ -46,9 +47,13 @@ public:
 
 private:
   typedef std::multimap<Int_t, std::pair<Int_t, DelphesFormula *> > TMisIDMap; //!
+  typedef std::pair<TMisIDMap::iterator, TMisIDMap::iterator> TMisIDRange; //!
 
   TMisIDMap fEfficiencyMap; //!
 
+  // formulas used for every PDG code
+  DelphesPDGMap<TMisIDRange> fRangeMap; //!
+
   TIterator *fItInputArray; //!
 
   const TObjArray *fInputArray; //!
@@ -29,6 +29,7 @@
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
 #include "classes/DelphesFormula.h"
+#include "classes/DelphesRandom.h"
 
 #include "ExRootAnalysis/ExRootClassifier.h"
 #include "ExRootAnalysis/ExRootFilter.h"
@@ -104,7 +105,7 @@ void ImpactParameterSmearing::Process()
     // take momentum before smearing (otherwise apply double smearing on d0)
     particle = static_cast<Candidate *>(candidate->GetCandidates()->At(0));
 
-    const TLorentzVector &candidateMomentum = particle->Momentum;
+    const DelphesLorentzVector &candidateMomentum = particle->Momentum;
 
     eta = candidateMomentum.Eta();
     pt = candidateMomentum.Pt();
@@ -120,9 +121,9 @@ void ImpactParameterSmearing::Process()
     zd = candidate->Zd;
 
     // calculate smeared values
-    sx = gRandom->Gaus(0.0, fFormula->Eval(pt, eta, phi, e));
-    sy = gRandom->Gaus(0.0, fFormula->Eval(pt, eta, phi, e));
-    sz = gRandom->Gaus(0.0, fFormula->Eval(pt, eta, phi, e));
+    sx = GetRandom()->Gaus(0.0, fFormula->Eval(pt, eta, phi, e));
+    sy = GetRandom()->Gaus(0.0, fFormula->Eval(pt, eta, phi, e));
+    sz = GetRandom()->Gaus(0.0, fFormula->Eval(pt, eta, phi, e));
 
     xd += sx;
     yd += sy;
@@ -131,7 +132,7 @@ void ImpactParameterSmearing::Process()
     // calculate impact parameter (after-smearing)
     d0 = (xd * py - yd * px) / pt;
 
-    dd0 = gRandom->Gaus(0.0, fFormula->Eval(pt, eta, phi, e));
+    dd0 = GetRandom()->Gaus(0.0, fFormula->Eval(pt, eta, phi, e));
 
     // fill smeared values in candidate
     mother = candidate;
@@ -69,7 +69,7 @@ public:
 Int_t IsolationClassifier::GetCategory(TObject *object)
 {
   Candidate *track = static_cast<Candidate *>(object);
-  const TLorentzVector &momentum = track->Momentum;
+  const DelphesLorentzVector &momentum = track->Momentum;
 
   if(momentum.Pt() < fPTMin) return -1;
 
@@ -79,9 +79,7 @@ Int_t IsolationClassifier::GetCategory(TObject *object)
 //------------------------------------------------------------------------------
 
 Isolation::Isolation() :
-  fClassifier(0), fFilter(0),
-  fItIsolationInputArray(0), fItCandidateInputArray(0),
-  fItRhoInputArray(0)
+  fClassifier(0), fFilter(0)
 {
   fClassifier = new IsolationClassifier;
 }
@@ -116,18 +114,15 @@ void Isolation::Init()
   // import input array(s)
 
   fIsolationInputArray = ImportArray(GetString("IsolationInputArray", "Delphes/partons"));
-  fItIsolationInputArray = fIsolationInputArray->MakeIterator();
 
   fFilter = new ExRootFilter(fIsolationInputArray);
 
-  fCandidateInputArray = ImportArray(GetString("CandidateInputArray", "Calorimeter/electrons"));
-  fItCandidateInputArray = fCandidateInputArray->MakeIterator();
+  fCandidateInputArray = UpdateArray(GetString("CandidateInputArray", "Calorimeter/electrons"));
 
   rhoInputArrayName = GetString("RhoInputArray", "");
   if(rhoInputArrayName[0] != '\0')
   {
     fRhoInputArray = ImportArray(rhoInputArrayName);
-    fItRhoInputArray = fRhoInputArray->MakeIterator();
   }
   else
   {
@@ -143,42 +138,37 @@ void Isolation::Init()
 
 void Isolation::Finish()
 {
-  if(fItRhoInputArray) delete fItRhoInputArray;
   if(fFilter) delete fFilter;
-  if(fItCandidateInputArray) delete fItCandidateInputArray;
-  if(fItIsolationInputArray) delete fItIsolationInputArray;
 }
 
 //------------------------------------------------------------------------------
 
 void Isolation::Process()
 {
-  Candidate *candidate, *isolation, *object;
   TObjArray *isolationArray;
   Double_t sumChargedNoPU, sumChargedPU, sumNeutral, sumAllParticles, sumPho;
   Double_t sumDBeta, ratioDBeta, sumRhoCorr, ratioRhoCorr, sum, ratio;
   Bool_t pass = kFALSE;
+  Double_t deltaR = 0.0;
   Double_t eta = 0.0;
   Double_t rho = 0.0;
 
   // select isolation objects
   fFilter->Reset();
   isolationArray = fFilter->GetSubArray(fClassifier, 0);
-  TIter itIsolationArray(isolationArray);
+  DelphesArrayView<Candidate> isolationView(isolationArray);
 
   // loop over all input jets
-  fItCandidateInputArray->Reset();
-  while((candidate = static_cast<Candidate *>(fItCandidateInputArray->Next())))
+  for(Candidate *candidate : DelphesArrayView<Candidate>(fCandidateInputArray))
   {
-    const TLorentzVector &candidateMomentum = candidate->Momentum;
+    const DelphesLorentzVector &candidateMomentum = candidate->Momentum;
     eta = TMath::Abs(candidateMomentum.Eta());
 
     // find rho
     rho = 0.0;
     if(fRhoInputArray)
     {
-      fItRhoInputArray->Reset();
-      while((object = static_cast<Candidate *>(fItRhoInputArray->Next())))
+      for(Candidate *object : DelphesArrayView<Candidate>(fRhoInputArray))
       {
         if(eta >= object->Edges[0] && eta < object->Edges[1])
         {
@@ -195,18 +185,19 @@ void Isolation::Process()
     sumAllParticles = 0.0;
     sumPho = 0.0;
 
-    itIsolationArray.Reset();
-    while((isolation = static_cast<Candidate *>(itIsolationArray.Next())))
+    for(Candidate *isolation : isolationView)
     {
-      const TLorentzVector &isolationMomentum = isolation->Momentum;
+      const DelphesLorentzVector &isolationMomentum = isolation->Momentum;
+
+      deltaR = candidateMomentum.DeltaR(isolationMomentum);
 
       if(fUseMiniCone)
       {
-        pass = candidateMomentum.DeltaR(isolationMomentum) <= fDeltaRMax && candidateMomentum.DeltaR(isolationMomentum) > fDeltaRMin;
+        pass = deltaR <= fDeltaRMax && deltaR > fDeltaRMin;
       }
       else
       {
-        pass = candidateMomentum.DeltaR(isolationMomentum) <= fDeltaRMax && candidate->GetUniqueID() != isolation->GetUniqueID();
+        pass = deltaR <= fDeltaRMax && candidate->GetCandidateID() != isolation->GetCandidateID();
       }
 
       if(pass)
@@ -237,8 +228,7 @@ void Isolation::Process()
     rho = 0.0;
     if(fRhoInputArray)
     {
-      fItRhoInputArray->Reset();
-      while((object = static_cast<Candidate *>(fItRhoInputArray->Next())))
+      for(Candidate *object : DelphesArrayView<Candidate>(fRhoInputArray))
       {
         if(eta >= object->Edges[0] && eta < object->Edges[1])
         {
@@ -66,12 +66,6 @@ private:
 
   ExRootFilter *fFilter;
 
-  TIterator *fItIsolationInputArray; //!
-
-  TIterator *fItCandidateInputArray; //!
-
-  TIterator *fItRhoInputArray; //!
-
   const TObjArray *fIsolationInputArray; //!
 
   const TObjArray *fCandidateInputArray; //!
@@ -30,6 +30,7 @@
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
 #include "classes/DelphesFormula.h"
+#include "classes/DelphesRandom.h"
 
 #include "ExRootAnalysis/ExRootClassifier.h"
 #include "ExRootAnalysis/ExRootFilter.h"
@@ -145,14 +146,14 @@ void JetFakeParticle::Process()
   fItInputArray->Reset();
   while((candidate = static_cast<Candidate *>(fItInputArray->Next())))
   {
-    const TLorentzVector &candidatePosition = candidate->Position;
-    const TLorentzVector &candidateMomentum = candidate->Momentum;
+    const DelphesLorentzVector &candidatePosition = candidate->Position;
+    const DelphesLorentzVector &candidateMomentum = candidate->Momentum;
     eta = candidatePosition.Eta();
     phi = candidatePosition.Phi();
     pt = candidateMomentum.Pt();
     e = candidateMomentum.E();
 
-    r = gRandom->Uniform();
+    r = GetRandom()->Uniform();
     total = 0.0;
     fake = 0;
 
@@ -178,7 +179,7 @@ void JetFakeParticle::Process()
           }
           else
           {
-            rs = gRandom->Uniform();
+            rs = GetRandom()->Uniform();
             fake->Charge = (rs < 0.5) ? -1 : 1;
           }
         }
@@ -67,7 +67,7 @@ Int_t PartonClassifier::GetCategory(TObject *object)
   // select parton in the parton list
 
   Candidate *parton = static_cast<Candidate *>(object);
-  const TLorentzVector &momentum = parton->Momentum;
+  const DelphesLorentzVector &momentum = parton->Momentum;
   Int_t pdgCode;
 
   // inside the eta && momentum range (be a little bit larger that the tracking coverage
@@ -97,7 +97,7 @@ Int_t ParticleLHEFClassifier::GetCategory(TObject *object)
   // select parton in the parton list
 
   Candidate *particleLHEF = static_cast<Candidate *>(object);
-  const TLorentzVector &momentum = particleLHEF->Momentum;
+  const DelphesLorentzVector &momentum = particleLHEF->Momentum;
   Int_t pdgCode;
 
   // inside the eta && momentum range (be a little bit larger that the tracking coverage
@@ -167,7 +167,7 @@ void JetFlavorAssociation::Init()
     fParticleLHEFFilter = new ExRootFilter(fParticleLHEFInputArray);
   }
 
-  fJetInputArray = ImportArray(GetString("JetInputArray", "FastJetFinder/jets"));
+  fJetInputArray = UpdateArray(GetString("JetInputArray", "FastJetFinder/jets"));
   fItJetInputArray = fJetInputArray->MakeIterator();
 }
 
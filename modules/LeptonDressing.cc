@@ -100,14 +100,14 @@ void LeptonDressing::Process()
   fItCandidateInputArray->Reset();
   while((candidate = static_cast<Candidate *>(fItCandidateInputArray->Next())))
   {
-    const TLorentzVector &candidateMomentum = candidate->Momentum;
+    const DelphesLorentzVector &candidateMomentum = candidate->Momentum;
 
     // loop over all input tracks
     fItDressingInputArray->Reset();
     momentum.SetPxPyPzE(0.0, 0.0, 0.0, 0.0);
     while((dressing = static_cast<Candidate *>(fItDressingInputArray->Next())))
     {
-      const TLorentzVector &dressingMomentum = dressing->Momentum;
+      const DelphesLorentzVector &dressingMomentum = dressing->Momentum;
       if(dressingMomentum.Pt() > 0.1)
       {
         if(candidateMomentum.DeltaR(dressingMomentum) <= fDeltaR)
@@ -21,12 +21,16 @@
  *  Merges multiple input arrays into one output array
  *  and sums transverse momenta of all input objects.
  *
+ *  The output array is exported as a chain of the input arrays
+ *  and the sums are only computed when they are imported.
+ *
  *  \author P. Demin - UCL, Louvain-la-Neuve
  *
  */
 
 #include "modules/Merger.h"
 
+#include "classes/DelphesArrayChain.h"
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
 #include "classes/DelphesFormula.h"
@@ -52,7 +56,8 @@ using namespace std;
 
 //------------------------------------------------------------------------------
 
-Merger::Merger()
+Merger::Merger() :
+  fOutputChain(0), fMomentumOutputChain(0), fEnergyOutputChain(0)
 {
 }
 
@@ -66,43 +71,31 @@ Merger::~Merger()
 
 void Merger::Init()
 {
-  // import arrays with output from other modules
-
   ExRootConfParam param = GetParam("InputArray");
   Long_t i, size;
-  const TObjArray *array;
-  TIterator *iterator;
 
-  size = param.GetSize();
-  for(i = 0; i < size; ++i)
-  {
-    array = ImportArray(param[i].GetString());
-    iterator = array->MakeIterator();
+  // create output arrays
 
-    fInputList.push_back(iterator);
-  }
+  fOutputChain = ExportChain(GetString("OutputArray", "candidates"));
 
-  // create output arrays
+  fMomentumOutputChain = ExportChain(GetString("MomentumOutputArray", "momentum"));
 
-  fOutputArray = ExportArray(GetString("OutputArray", "candidates"));
+  fEnergyOutputChain = ExportChain(GetString("EnergyOutputArray", "energy"));
 
-  fMomentumOutputArray = ExportArray(GetString("MomentumOutputArray", "momentum"));
+  // import arrays with output from other modules,
+  // the arrays of merged inputs are chained directly
 
-  fEnergyOutputArray = ExportArray(GetString("EnergyOutputArray", "energy"));
+  size = param.GetSize();
+  for(i = 0; i < size; ++i)
+  {
+    fOutputChain->Add(ImportChain(param[i].GetString()));
+  }
 }
 
 //------------------------------------------------------------------------------
 
 void Merger::Finish()
 {
-  vector<TIterator *>::iterator itInputList;
-  TIterator *iterator;
-
-  for(itInputList = fInputList.begin(); itInputList != fInputList.end(); ++itInputList)
-  {
-    iterator = *itInputList;
-    if(iterator) delete iterator;
-  }
 }
 
 //------------------------------------------------------------------------------
@@ -112,32 +105,26 @@ void Merger::Process()
   Candidate *candidate;
   TLorentzVector momentum;
   Double_t sumPT, sumE;
-  vector<TIterator *>::iterator itInputList;
-  TIterator *iterator;
 
   DelphesFactory *factory = GetFactory();
 
+  // copy the input candidates only for the modules importing the output array
+  if(fOutputChain->IsFilled()) fOutputChain->Fill();
+
+  if(!fMomentumOutputChain->IsImported() && !fEnergyOutputChain->IsImported()) return;
+
   momentum.SetPxPyPzE(0.0, 0.0, 0.0, 0.0);
   sumPT = 0;
   sumE = 0;
 
-  // loop over all input arrays
-  for(itInputList = fInputList.begin(); itInputList != fInputList.end(); ++itInputList)
+  // loop over all candidates of all input arrays
+  for(Candidate *constituent : DelphesChainView<Candidate>(fOutputChain))
   {
-    iterator = *itInputList;
-
-    // loop over all candidates
-    iterator->Reset();
-    while((candidate = static_cast<Candidate *>(iterator->Next())))
-    {
-      const TLorentzVector &candidateMomentum = candidate->Momentum;
-
-      momentum += candidateMomentum;
-      sumPT += candidateMomentum.Pt();
-      sumE += candidateMomentum.E();
+    const DelphesLorentzVector &candidateMomentum = constituent->Momentum;
 
-      fOutputArray->Add(candidate);
-    }
+    momentum += candidateMomentum;
+    sumPT += candidateMomentum.Pt();
+    sumE += candidateMomentum.E();
   }
 
   candidate = factory->NewCandidate();
@@ -145,14 +132,14 @@ void Merger::Process()
   candidate->Position.SetXYZT(0.0, 0.0, 0.0, 0.0);
   candidate->Momentum = momentum;
 
-  fMomentumOutputArray->Add(candidate);
+  fMomentumOutputChain->GetArray()->Add(candidate);
 
   candidate = factory->NewCandidate();
 
   candidate->Position.SetXYZT(0.0, 0.0, 0.0, 0.0);
   candidate->Momentum.SetPtEtaPhiE(sumPT, 0.0, 0.0, sumE);
 
-  fEnergyOutputArray->Add(candidate);
+  fEnergyOutputChain->GetArray()->Add(candidate);
 }
 
 //------------------------------------------------------------------------------
@@ -24,16 +24,17 @@
  *  Merges multiple input arrays into one output array
  *  and sums transverse momenta of all input objects.
  *
+ *  The output array is exported as a chain of the input arrays
+ *  and the sums are only computed when they are imported.
+ *
  *  \author P. Demin - UCL, Louvain-la-Neuve
  *
  */
 
 #include "classes/DelphesModule.h"
 
-#include <vector>
-
-class TIterator;
 class TObjArray;
+class DelphesArrayChain;
 
 class Merger: public DelphesModule
 {
@@ -46,11 +47,9 @@ public:
   void Finish();
 
 private:
-  std::vector<TIterator *> fInputList; //!
-
-  TObjArray *fOutputArray; //!
-  TObjArray *fMomentumOutputArray; //!
-  TObjArray *fEnergyOutputArray; //!
+  DelphesArrayChain *fOutputChain; //!
+  DelphesArrayChain *fMomentumOutputChain; //!
+  DelphesArrayChain *fEnergyOutputChain; //!
 
   ClassDef(Merger, 1)
 };
@@ -76,6 +76,7 @@
 #include "modules/VertexFinderDA4D.h"
 #include "modules/DecayFilter.h"
 #include "modules/ParticleDensity.h"
+#include "modules/Gate.h"
 #include "modules/ExampleModule.h"
 
 #ifdef __CINT__
@@ -135,6 +136,7 @@
 #pragma link C++ class VertexFinderDA4D+;
 #pragma link C++ class DecayFilter+;
 #pragma link C++ class ParticleDensity+;
+#pragma link C++ class Gate+;
 #pragma link C++ class ExampleModule+;
 
 #endif
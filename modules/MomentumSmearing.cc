@@ -29,6 +29,7 @@
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
 #include "classes/DelphesFormula.h"
+#include "classes/DelphesRandom.h"
 
 #include "ExRootAnalysis/ExRootClassifier.h"
 #include "ExRootAnalysis/ExRootFilter.h"
@@ -52,7 +53,7 @@ using namespace std;
 //------------------------------------------------------------------------------
 
 MomentumSmearing::MomentumSmearing() :
-  fFormula(0), fItInputArray(0)
+  fFormula(0)
 {
   fFormula = new DelphesFormula;
 }
@@ -75,7 +76,6 @@ void MomentumSmearing::Init()
   // import input array
 
   fInputArray = ImportArray(GetString("InputArray", "ParticlePropagator/stableParticles"));
-  fItInputArray = fInputArray->MakeIterator();
 
   // create output array
 
@@ -86,21 +86,39 @@ void MomentumSmearing::Init()
 
 void MomentumSmearing::Finish()
 {
-  if(fItInputArray) delete fItInputArray;
 }
 
 //------------------------------------------------------------------------------
 
 void MomentumSmearing::Process()
 {
-  Candidate *candidate, *mother;
+  ProcessArray(fInputArray, fOutputArray);
+}
+
+//------------------------------------------------------------------------------
+
+void MomentumSmearing::ProcessBatch(Int_t size)
+{
+  Int_t event;
+
+  for(event = 0; event < size; ++event)
+  {
+    SelectRandomEvent(event);
+    ProcessArray(GetEventArray(fInputArray, event), GetEventArray(fOutputArray, event));
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void MomentumSmearing::ProcessArray(const TObjArray *inputArray, TObjArray *outputArray)
+{
+  Candidate *mother;
   Double_t pt, eta, phi, e, res;
 
-  fItInputArray->Reset();
-  while((candidate = static_cast<Candidate *>(fItInputArray->Next())))
+  for(Candidate *candidate : DelphesArrayView<Candidate>(inputArray))
   {
-    const TLorentzVector &candidatePosition = candidate->Position;
-    const TLorentzVector &candidateMomentum = candidate->Momentum;
+    const DelphesLorentzVector &candidatePosition = candidate->Position;
+    const DelphesLorentzVector &candidateMomentum = candidate->Momentum;
     eta = candidatePosition.Eta();
     phi = candidatePosition.Phi();
     pt = candidateMomentum.Pt();
@@ -108,7 +126,7 @@ void MomentumSmearing::Process()
     res = fFormula->Eval(pt, eta, phi, e, candidate);
 
     // apply smearing formula
-    //pt = gRandom->Gaus(pt, fFormula->Eval(pt, eta, phi, e) * pt);
+    //pt = GetRandom()->Gaus(pt, fFormula->Eval(pt, eta, phi, e) * pt);
 
     res = (res > 1.0) ? 1.0 : res;
 
@@ -125,7 +143,7 @@ void MomentumSmearing::Process()
     candidate->TrackResolution = res;
     candidate->AddCandidate(mother);
 
-    fOutputArray->Add(candidate);
+    outputArray->Add(candidate);
   }
 }
 //----------------------------------------------------------------
@@ -139,7 +157,7 @@ Double_t MomentumSmearing::LogNormal(Double_t mean, Double_t sigma)
     b = TMath::Sqrt(TMath::Log((1.0 + (sigma * sigma) / (mean * mean))));
     a = TMath::Log(mean) - 0.5 * b * b;
 
-    return TMath::Exp(a + b * gRandom->Gaus(0.0, 1.0));
+    return TMath::Exp(a + b * GetRandom()->Gaus(0.0, 1.0));
   }
   else
   {
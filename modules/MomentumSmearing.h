@@ -29,7 +29,6 @@
 
 #include "classes/DelphesModule.h"
 
-class TIterator;
 class TObjArray;
 class DelphesFormula;
 
@@ -41,15 +40,16 @@ public:
 
   void Init();
   void Process();
+  void ProcessBatch(Int_t size);
   void Finish();
 
 private:
+  void ProcessArray(const TObjArray *inputArray, TObjArray *outputArray);
+
   Double_t LogNormal(Double_t mean, Double_t sigma);
 
   DelphesFormula *fFormula; //!
 
-  TIterator *fItInputArray; //!
-
   const TObjArray *fInputArray; //!
 
   TObjArray *fOutputArray; //!
@@ -68,7 +68,7 @@ void ParticleDensity::Init()
 
   // import input array(s)
 
-  fInputArray = ImportArray(GetString("InputArray", "FastJetFinder/jets"));
+  fInputArray = UpdateArray(GetString("InputArray", "FastJetFinder/jets"));
   fItInputArray = fInputArray->MakeIterator();
 
   // create output array(s)
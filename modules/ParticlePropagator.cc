@@ -89,7 +89,7 @@ void ParticlePropagator::Init()
 
   // import array with output from filter/classifier module
 
-  fInputArray = ImportArray(GetString("InputArray", "Delphes/stableParticles"));
+  fInputArray = UpdateArray(GetString("InputArray", "Delphes/stableParticles"));
   fItInputArray = fInputArray->MakeIterator();
 
   // import beamspot
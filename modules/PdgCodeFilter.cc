@@ -51,8 +51,7 @@ using namespace std;
 
 //------------------------------------------------------------------------------
 
-PdgCodeFilter::PdgCodeFilter() :
-  fItInputArray(0)
+PdgCodeFilter::PdgCodeFilter()
 {
 }
 
@@ -86,7 +85,6 @@ void PdgCodeFilter::Init()
 
   // import input array
   fInputArray = ImportArray(GetString("InputArray", "Delphes/allParticles"));
-  fItInputArray = fInputArray->MakeIterator();
 
   param = GetParam("PdgCode");
   size = param.GetSize();
@@ -107,23 +105,39 @@ void PdgCodeFilter::Init()
 
 void PdgCodeFilter::Finish()
 {
-  if(fItInputArray) delete fItInputArray;
 }
 
 //------------------------------------------------------------------------------
 
 void PdgCodeFilter::Process()
 {
-  Candidate *candidate;
+  ProcessArray(fInputArray, fOutputArray);
+}
+
+//------------------------------------------------------------------------------
+
+void PdgCodeFilter::ProcessBatch(Int_t size)
+{
+  Int_t event;
+
+  for(event = 0; event < size; ++event)
+  {
+    ProcessArray(GetEventArray(fInputArray, event), GetEventArray(fOutputArray, event));
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void PdgCodeFilter::ProcessArray(const TObjArray *inputArray, TObjArray *outputArray)
+{
   Int_t pdgCode;
   Bool_t pass;
   Double_t pt;
 
-  fItInputArray->Reset();
-  while((candidate = static_cast<Candidate *>(fItInputArray->Next())))
+  for(Candidate *candidate : DelphesArrayView<Candidate>(inputArray))
   {
     pdgCode = candidate->PID;
-    const TLorentzVector &candidateMomentum = candidate->Momentum;
+    const DelphesLorentzVector &candidateMomentum = candidate->Momentum;
     pt = candidateMomentum.Pt();
 
     if(pt < fPTMin) continue;
@@ -135,6 +149,6 @@ void PdgCodeFilter::Process()
     if(find(fPdgCodes.begin(), fPdgCodes.end(), pdgCode) != fPdgCodes.end()) pass = kFALSE;
 
     if(fInvert) pass = !pass;
-    if(pass) fOutputArray->Add(candidate);
+    if(pass) outputArray->Add(candidate);
   }
 }
@@ -32,7 +32,6 @@
 #include "classes/DelphesModule.h"
 #include <vector>
 
-class TIterator;
 class TObjArray;
 
 class PdgCodeFilter: public DelphesModule
@@ -43,9 +42,12 @@ public:
 
   void Init();
   void Process();
+  void ProcessBatch(Int_t size);
   void Finish();
 
 private:
+  void ProcessArray(const TObjArray *inputArray, TObjArray *outputArray);
+
   Double_t fPTMin; //!
   Bool_t fInvert; //!
   Bool_t fRequireStatus; //!
@@ -56,8 +58,6 @@ private:
 
   std::vector<Int_t> fPdgCodes;
 
-  TIterator *fItInputArray; //!
-
   const TObjArray *fInputArray; //!
 
   TObjArray *fOutputArray; //!
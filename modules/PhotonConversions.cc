@@ -30,11 +30,13 @@
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesCylindricalFormula.h"
 #include "classes/DelphesFactory.h"
+#include "classes/DelphesRandom.h"
 
 #include "ExRootAnalysis/ExRootClassifier.h"
 #include "ExRootAnalysis/ExRootFilter.h"
 #include "ExRootAnalysis/ExRootResult.h"
 
+#include "RVersion.h"
 #include "TDatabasePDG.h"
 #include "TF1.h"
 #include "TFormula.h"
@@ -210,12 +212,16 @@ void PhotonConversions::Process()
         p_conv = 1 - TMath::Exp(-7.0 / 9.0 * fStep * rate);
 
         // case conversion occurs
-        if(gRandom->Uniform() < p_conv)
+        if(GetRandom()->Uniform() < p_conv)
         {
           converted = true;
 
           // generate x1 and x2, the fraction of the photon energy taken resp. by e+ and e-
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6, 24, 0)
+          x1 = fDecayXsec->GetRandom(GetRandom());
+#else
           x1 = fDecayXsec->GetRandom();
+#endif
           x2 = 1 - x1;
 
           ep = static_cast<Candidate *>(candidate->Clone());
@@ -31,6 +31,7 @@
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
 #include "classes/DelphesFormula.h"
+#include "classes/DelphesRandom.h"
 
 #include "ExRootAnalysis/ExRootClassifier.h"
 #include "ExRootAnalysis/ExRootFilter.h"
@@ -125,8 +126,8 @@ void PhotonID::Process()
     candidate = static_cast<Candidate *>(candidate->Clone());
     candidate->AddCandidate(mother);
 
-    const TLorentzVector &candidatePosition = candidate->Position;
-    const TLorentzVector &candidateMomentum = candidate->Momentum;
+    const DelphesLorentzVector &candidatePosition = candidate->Position;
+    const DelphesLorentzVector &candidateMomentum = candidate->Momentum;
     eta = candidatePosition.Eta();
     phi = candidatePosition.Phi();
     pt = candidateMomentum.Pt();
@@ -141,7 +142,7 @@ void PhotonID::Process()
     {
       //cout<<"                    Fake!"<<endl;
 
-      if(gRandom->Uniform() > fFakeFormula->Eval(pt, eta, phi, e)) continue;
+      if(GetRandom()->Uniform() > fFakeFormula->Eval(pt, eta, phi, e)) continue;
       //cout<<"                    passed"<<endl;
       candidate->Status = 3;
       fOutputArray->Add(candidate);
@@ -158,7 +159,7 @@ void PhotonID::Process()
       if(isolated)
       {
         //cout<<"                       isolated!:   "<<relIso<<endl;
-        if(gRandom->Uniform() > fPromptFormula->Eval(pt, eta, phi, e)) continue;
+        if(GetRandom()->Uniform() > fPromptFormula->Eval(pt, eta, phi, e)) continue;
         //cout<<"                       passed"<<endl;
         candidate->Status = 1;
         fOutputArray->Add(candidate);
@@ -168,7 +169,7 @@ void PhotonID::Process()
       else
       {
         //cout<<"                       non-isolated!:   "<<relIso<<endl;
-        if(gRandom->Uniform() > fNonPromptFormula->Eval(pt, eta, phi, e)) continue;
+        if(GetRandom()->Uniform() > fNonPromptFormula->Eval(pt, eta, phi, e)) continue;
         //cout<<"                       passed"<<endl;
         candidate->Status = 2;
         fOutputArray->Add(candidate);
@@ -182,7 +183,7 @@ void PhotonID::Process()
 Bool_t PhotonID::isFake(const Candidate *obj)
 {
 
-  const TLorentzVector &mom_rec = obj->Momentum;
+  const DelphesLorentzVector &mom_rec = obj->Momentum;
 
   Bool_t matches = false;
   fItInputGenArray->Reset();
@@ -190,7 +191,7 @@ Bool_t PhotonID::isFake(const Candidate *obj)
 
   while((gen = static_cast<Candidate *>(fItInputGenArray->Next())))
   {
-    const TLorentzVector &mom_gen = gen->Momentum;
+    const DelphesLorentzVector &mom_gen = gen->Momentum;
     Int_t status = gen->Status;
     Int_t pdgCode = TMath::Abs(gen->PID);
     Float_t dPtOverPt = TMath::Abs((mom_gen.Pt() - mom_rec.Pt()) / mom_rec.Pt());
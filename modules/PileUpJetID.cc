@@ -12,6 +12,7 @@
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
 #include "classes/DelphesFormula.h"
+#include "classes/DelphesRandom.h"
 
 #include "ExRootAnalysis/ExRootClassifier.h"
 #include "ExRootAnalysis/ExRootFilter.h"
@@ -66,7 +67,7 @@ void PileUpJetID::Init()
 
   // import input array(s)
 
-  fJetInputArray = ImportArray(GetString("JetInputArray", "FastJetFinder/jets"));
+  fJetInputArray = UpdateArray(GetString("JetInputArray", "FastJetFinder/jets"));
   fItJetInputArray = fJetInputArray->MakeIterator();
 
   fTrackInputArray = ImportArray(GetString("TrackInputArray", "ParticlePropagator/tracks"));
@@ -98,6 +99,8 @@ void PileUpJetID::Finish()
 void PileUpJetID::Process()
 {
   Candidate *candidate, *constituent;
+  CandidateJetID *jetID;
+  CandidateTiming *timing;
   TLorentzVector momentum, area;
 
   Candidate *trk;
@@ -109,6 +112,9 @@ void PileUpJetID::Process()
     momentum = candidate->Momentum;
     area = candidate->Area;
 
+    jetID = candidate->JetID();
+    timing = candidate->Timing();
+
     float sumT0 = 0.;
     float sumT1 = 0.;
     float sumT10 = 0.;
@@ -116,7 +122,7 @@ void PileUpJetID::Process()
     float sumT30 = 0.;
     float sumT40 = 0.;
     float sumWeightsForT = 0.;
-    candidate->NTimeHits = 0;
+    timing->NTimeHits = 0;
 
     float sumpt = 0.;
     float sumptch = 0.;
@@ -170,36 +176,36 @@ void PileUpJetID::Process()
         }
         float tow_sumT = 0;
         float tow_sumW = 0;
-        for(int i = 0; i < constituent->ECalEnergyTimePairs.size(); i++)
+        for(int i = 0; i < constituent->GetTiming()->ECalEnergyTimePairs.size(); i++)
         {
-          float w = TMath::Sqrt(constituent->ECalEnergyTimePairs[i].first);
+          float w = TMath::Sqrt(constituent->GetTiming()->ECalEnergyTimePairs[i].first);
           if(fAverageEachTower)
           {
-            tow_sumT += w * constituent->ECalEnergyTimePairs[i].second;
+            tow_sumT += w * constituent->GetTiming()->ECalEnergyTimePairs[i].second;
             tow_sumW += w;
           }
           else
           {
-            sumT0 += w * constituent->ECalEnergyTimePairs[i].second;
-            sumT1 += w * gRandom->Gaus(constituent->ECalEnergyTimePairs[i].second, 0.001);
-            sumT10 += w * gRandom->Gaus(constituent->ECalEnergyTimePairs[i].second, 0.010);
-            sumT20 += w * gRandom->Gaus(constituent->ECalEnergyTimePairs[i].second, 0.020);
-            sumT30 += w * gRandom->Gaus(constituent->ECalEnergyTimePairs[i].second, 0.030);
-            sumT40 += w * gRandom->Gaus(constituent->ECalEnergyTimePairs[i].second, 0.040);
+            sumT0 += w * constituent->GetTiming()->ECalEnergyTimePairs[i].second;
+            sumT1 += w * GetRandom()->Gaus(constituent->GetTiming()->ECalEnergyTimePairs[i].second, 0.001);
+            sumT10 += w * GetRandom()->Gaus(constituent->GetTiming()->ECalEnergyTimePairs[i].second, 0.010);
+            sumT20 += w * GetRandom()->Gaus(constituent->GetTiming()->ECalEnergyTimePairs[i].second, 0.020);
+            sumT30 += w * GetRandom()->Gaus(constituent->GetTiming()->ECalEnergyTimePairs[i].second, 0.030);
+            sumT40 += w * GetRandom()->Gaus(constituent->GetTiming()->ECalEnergyTimePairs[i].second, 0.040);
             sumWeightsForT += w;
-            candidate->NTimeHits++;
+            timing->NTimeHits++;
           }
         }
         if(fAverageEachTower && tow_sumW > 0.)
         {
           sumT0 += tow_sumT;
-          sumT1 += tow_sumW * gRandom->Gaus(tow_sumT / tow_sumW, 0.001);
-          sumT10 += tow_sumW * gRandom->Gaus(tow_sumT / tow_sumW, 0.0010);
-          sumT20 += tow_sumW * gRandom->Gaus(tow_sumT / tow_sumW, 0.0020);
-          sumT30 += tow_sumW * gRandom->Gaus(tow_sumT / tow_sumW, 0.0030);
-          sumT40 += tow_sumW * gRandom->Gaus(tow_sumT / tow_sumW, 0.0040);
+          sumT1 += tow_sumW * GetRandom()->Gaus(tow_sumT / tow_sumW, 0.001);
+          sumT10 += tow_sumW * GetRandom()->Gaus(tow_sumT / tow_sumW, 0.0010);
+          sumT20 += tow_sumW * GetRandom()->Gaus(tow_sumT / tow_sumW, 0.0020);
+          sumT30 += tow_sumW * GetRandom()->Gaus(tow_sumT / tow_sumW, 0.0030);
+          sumT40 += tow_sumW * GetRandom()->Gaus(tow_sumT / tow_sumW, 0.0040);
           sumWeightsForT += tow_sumW;
-          candidate->NTimeHits++;
+          timing->NTimeHits++;
         }
       }
     }
@@ -259,38 +265,38 @@ void PileUpJetID::Process()
 
     if(sumptch > 0.)
     {
-      candidate->Beta = sumptchpv / sumptch;
-      candidate->BetaStar = sumptchpu / sumptch;
+      jetID->Beta = sumptchpv / sumptch;
+      jetID->BetaStar = sumptchpu / sumptch;
     }
     else
     {
-      candidate->Beta = -999.;
-      candidate->BetaStar = -999.;
+      jetID->Beta = -999.;
+      jetID->BetaStar = -999.;
     }
     if(sumptsq > 0.)
     {
-      candidate->MeanSqDeltaR = sumdrsqptsq / sumptsq;
+      jetID->MeanSqDeltaR = sumdrsqptsq / sumptsq;
     }
     else
     {
-      candidate->MeanSqDeltaR = -999.;
+      jetID->MeanSqDeltaR = -999.;
     }
-    candidate->NCharged = nc;
-    candidate->NNeutrals = nn;
+    jetID->NCharged = nc;
+    jetID->NNeutrals = nn;
     if(sumpt > 0.)
     {
-      candidate->PTD = TMath::Sqrt(sumptsq) / sumpt;
+      jetID->PTD = TMath::Sqrt(sumptsq) / sumpt;
       for(int i = 0; i < 5; i++)
       {
-        candidate->FracPt[i] = pt_ann[i] / sumpt;
+        jetID->FracPt[i] = pt_ann[i] / sumpt;
       }
     }
     else
     {
-      candidate->PTD = -999.;
+      jetID->PTD = -999.;
       for(int i = 0; i < 5; i++)
       {
-        candidate->FracPt[i] = -999.;
+        jetID->FracPt[i] = -999.;
       }
     }
 
@@ -306,19 +312,19 @@ void PileUpJetID::Process()
     */
 
     bool passId = false;
-    if(candidate->Momentum.Pt() > fJetPTMinForNeutrals && candidate->MeanSqDeltaR > -0.1)
+    if(candidate->Momentum.Pt() > fJetPTMinForNeutrals && jetID->MeanSqDeltaR > -0.1)
     {
       if(fabs(candidate->Momentum.Eta()) < 1.5)
       {
-        passId = ((candidate->Beta > fBetaMinBarrel) && (candidate->MeanSqDeltaR < fMeanSqDeltaRMaxBarrel));
+        passId = ((jetID->Beta > fBetaMinBarrel) && (jetID->MeanSqDeltaR < fMeanSqDeltaRMaxBarrel));
       }
       else if(fabs(candidate->Momentum.Eta()) < 4.0)
       {
-        passId = ((candidate->Beta > fBetaMinEndcap) && (candidate->MeanSqDeltaR < fMeanSqDeltaRMaxEndcap));
+        passId = ((jetID->Beta > fBetaMinEndcap) && (jetID->MeanSqDeltaR < fMeanSqDeltaRMaxEndcap));
       }
       else
       {
-        passId = (candidate->MeanSqDeltaR < fMeanSqDeltaRMaxForward);
+        passId = (jetID->MeanSqDeltaR < fMeanSqDeltaRMaxForward);
       }
     }
 
@@ -28,14 +28,17 @@
 
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
+#include "classes/DelphesPDGTable.h"
+#include "classes/DelphesPileUpPrefetcher.h"
 #include "classes/DelphesPileUpReader.h"
+#include "classes/DelphesRandom.h"
 #include "classes/DelphesTF2.h"
 
 #include "ExRootAnalysis/ExRootClassifier.h"
 #include "ExRootAnalysis/ExRootFilter.h"
 #include "ExRootAnalysis/ExRootResult.h"
 
-#include "TDatabasePDG.h"
+#include "RVersion.h"
 #include "TFormula.h"
 #include "TLorentzVector.h"
 #include "TMath.h"
@@ -53,7 +56,7 @@ using namespace std;
 //------------------------------------------------------------------------------
 
 PileUpMerger::PileUpMerger() :
-  fFunction(0), fReader(0), fItInputArray(0)
+  fFunction(0), fReader(0), fPrefetcher(0), fItInputArray(0)
 {
   fFunction = new DelphesTF2;
 }
@@ -69,8 +72,6 @@ PileUpMerger::~PileUpMerger()
 
 void PileUpMerger::Init()
 {
-  const char *fileName;
-
   fPileUpDistribution = GetInt("PileUpDistribution", 0);
 
   fMeanPileUp = GetDouble("MeanPileUp", 10);
@@ -88,8 +89,14 @@ void PileUpMerger::Init()
   fFunction->Compile(GetString("VertexDistributionFormula", "0.0"));
   fFunction->SetRange(-fZVertexSpread, -fTVertexSpread, fZVertexSpread, fTVertexSpread);
 
-  fileName = GetString("PileUpFile", "MinBias.pileup");
-  fReader = new DelphesPileUpReader(fileName);
+  // read the pile-up of the following events in a background thread,
+  // the entries are then drawn from a separate random stream
+  fPrefetchEvents = GetInt("PrefetchEvents", 0);
+  fPrefetchStream = DelphesRandom::Hash(Form("%s/PileUpEntries", GetName()));
+
+  fPileUpFile = GetString("PileUpFile", "MinBias.pileup");
+  fReader = new DelphesPileUpReader(fPileUpFile);
+  CreatePrefetcher();
 
   // import input array
   fInputArray = ImportArray(GetString("InputArray", "Delphes/stableParticles"));
@@ -102,23 +109,96 @@ void PileUpMerger::Init()
 
 //------------------------------------------------------------------------------
 
+void PileUpMerger::InitRun()
+{
+  TString fileName = GetString("PileUpFile", "MinBias.pileup");
+
+  if(fileName == fPileUpFile) return;
+
+  if(fPrefetcher) delete fPrefetcher;
+  if(fReader) delete fReader;
+
+  fPrefetcher = 0;
+  fPileUpFile = fileName;
+  fReader = new DelphesPileUpReader(fPileUpFile);
+  CreatePrefetcher();
+}
+
+//------------------------------------------------------------------------------
+
+Bool_t PileUpMerger::IsRunParameter(const char *name) const
+{
+  return TString(name) == "PileUpFile";
+}
+
+//------------------------------------------------------------------------------
+
 void PileUpMerger::Finish()
 {
+  if(fPrefetcher) delete fPrefetcher;
   if(fReader) delete fReader;
 }
 
 //------------------------------------------------------------------------------
 
+void PileUpMerger::CreatePrefetcher()
+{
+  if(fPrefetchEvents <= 0) return;
+
+  DelphesPileUpPrefetcher::DrawFunction draw = [this](TRandom *random, vector<Long64_t> &entries) {
+    Int_t event, numberOfEvents = DrawNumberOfEvents(random);
+    for(event = 0; event < numberOfEvents; ++event)
+    {
+      entries.push_back(DrawEntry(random));
+    }
+  };
+
+  fPrefetcher = new DelphesPileUpPrefetcher(fReader, draw, fPrefetchEvents);
+}
+
+//------------------------------------------------------------------------------
+
+Int_t PileUpMerger::DrawNumberOfEvents(TRandom *random) const
+{
+  switch(fPileUpDistribution)
+  {
+  case 0:
+    return random->Poisson(fMeanPileUp);
+  case 1:
+    return random->Integer(2 * fMeanPileUp + 1);
+  case 2:
+    return Int_t(fMeanPileUp);
+  default:
+    return random->Poisson(fMeanPileUp);
+  }
+}
+
+//------------------------------------------------------------------------------
+
+Long64_t PileUpMerger::DrawEntry(TRandom *random) const
+{
+  Long64_t entry, allEntries = fReader->GetEntries();
+
+  do
+  {
+    entry = TMath::Nint(random->Rndm() * allEntries);
+  } while(entry >= allEntries);
+
+  return entry;
+}
+
+//------------------------------------------------------------------------------
+
 void PileUpMerger::Process()
 {
-  TDatabasePDG *pdg = TDatabasePDG::Instance();
-  TParticlePDG *pdgParticle;
-  Int_t pid, nch, nvtx = -1;
-  Float_t x, y, z, t, vx, vy;
+  DelphesPDGTable *pdg = DelphesPDGTable::Instance();
+  Int_t pdgIndex;
+  Int_t pid, charge, nch, nvtx = -1;
+  Float_t mass, x, y, z, t, vx, vy;
   Float_t px, py, pz, e, pt;
   Double_t dz, dphi, dt, sumpt2, dz0, dt0;
   Int_t numberOfEvents, event, numberOfParticles;
-  Long64_t allEntries, entry;
+  Long64_t entry;
   Candidate *candidate, *vertex;
   DelphesFactory *factory;
 
@@ -128,7 +208,11 @@ void PileUpMerger::Process()
 
   // --- Deal with primary vertex first  ------
 
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6, 24, 0)
+  fFunction->GetRandom2(dz, dt, GetRandom());
+#else
   fFunction->GetRandom2(dz, dt);
+#endif
 
   dz0 = -1.0e6;
   dt0 = -1.0e6;
@@ -187,48 +271,46 @@ void PileUpMerger::Process()
   nvtx++;
   vertex->Position.SetXYZT(vx, vy, dz, dt);
   vertex->ClusterIndex = nvtx;
-  vertex->ClusterNDF = nch;
-  vertex->SumPT2 = sumpt2;
-  vertex->GenSumPT2 = sumpt2;
+  vertex->Vertexing()->ClusterNDF = nch;
+  vertex->Vertexing()->SumPT2 = sumpt2;
+  vertex->Vertexing()->GenSumPT2 = sumpt2;
   fVertexOutputArray->Add(vertex);
 
   // --- Then with pile-up vertices  ------
 
-  switch(fPileUpDistribution)
+  if(fPrefetcher)
   {
-  case 0:
-    numberOfEvents = gRandom->Poisson(fMeanPileUp);
-    break;
-  case 1:
-    numberOfEvents = gRandom->Integer(2 * fMeanPileUp + 1);
-    break;
-  case 2:
-    numberOfEvents = fMeanPileUp;
-    break;
-  default:
-    numberOfEvents = gRandom->Poisson(fMeanPileUp);
-    break;
+    numberOfEvents = fPrefetcher->SelectEvent(GetRandom()->GetSeed(), fPrefetchStream, GetRandom()->GetEvent());
+  }
+  else
+  {
+    numberOfEvents = DrawNumberOfEvents(GetRandom());
   }
-
-  allEntries = fReader->GetEntries();
 
   for(event = 0; event < numberOfEvents; ++event)
   {
-    do
+    if(fPrefetcher)
     {
-      entry = TMath::Nint(gRandom->Rndm() * allEntries);
-    } while(entry >= allEntries);
-
-    fReader->ReadEntry(entry);
+      fPrefetcher->ReadEntry(event);
+    }
+    else
+    {
+      entry = DrawEntry(GetRandom());
+      fReader->ReadEntry(entry);
+    }
 
     // --- Pile-up vertex smearing
 
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6, 24, 0)
+    fFunction->GetRandom2(dz, dt, GetRandom());
+#else
     fFunction->GetRandom2(dz, dt);
+#endif
 
     dt *= c_light * 1.0E3; // necessary in order to make t in mm/c
     dz *= 1.0E3; // necessary in order to make z in mm
 
-    dphi = gRandom->Uniform(-TMath::Pi(), TMath::Pi());
+    dphi = GetRandom()->Uniform(-TMath::Pi(), TMath::Pi());
 
     vx = 0.0;
     vy = 0.0;
@@ -239,7 +321,7 @@ void PileUpMerger::Process()
     //factory = GetFactory();
     vertex = factory->NewCandidate();
 
-    while(fReader->ReadParticle(pid, x, y, z, t, px, py, pz, e))
+    while(fPrefetcher ? fPrefetcher->ReadParticle(pid, charge, mass, x, y, z, t, px, py, pz, e) : fReader->ReadParticle(pid, charge, mass, x, y, z, t, px, py, pz, e))
     {
       candidate = factory->NewCandidate();
 
@@ -247,15 +329,22 @@ void PileUpMerger::Process()
 
       candidate->Status = 1;
 
-      pdgParticle = pdg->GetParticle(pid);
-      candidate->Charge = pdgParticle ? Int_t(pdgParticle->Charge() / 3.0) : -999;
-      candidate->Mass = pdgParticle ? pdgParticle->Mass() : -999.9;
+      if(fReader->HasParticleData())
+      {
+        candidate->Charge = charge;
+        candidate->Mass = mass;
+      }
+      else
+      {
+        pdgIndex = pdg->GetIndex(pid);
+        candidate->Charge = pdg->GetCharge(pdgIndex);
+        candidate->Mass = pdg->GetMass(pdgIndex);
+      }
 
       candidate->IsPU = 1;
 
       candidate->Momentum.SetPxPyPzE(px, py, pz, e);
       candidate->Momentum.RotateZ(dphi);
-      pt = candidate->Momentum.Pt();
 
       x -= fInputBeamSpotX;
       y -= fInputBeamSpotY;
@@ -269,14 +358,25 @@ void PileUpMerger::Process()
       ++numberOfParticles;
       if(TMath::Abs(candidate->Charge) > 1.0E-9)
       {
-        nch++;
-        sumpt2 += pt * pt;
+        if(!fReader->HasParticleData())
+        {
+          nch++;
+          pt = candidate->Momentum.Pt();
+          sumpt2 += pt * pt;
+        }
         vertex->AddCandidate(candidate);
       }
 
       fParticleOutputArray->Add(candidate);
     }
 
+    // the summary of the event is stored in pile-up files of version 2
+    if(fReader->HasParticleData())
+    {
+      nch += fPrefetcher ? fPrefetcher->GetEntryCharged() : fReader->GetEntryCharged();
+      sumpt2 = fPrefetcher ? fPrefetcher->GetEntrySumPT2() : fReader->GetEntrySumPT2();
+    }
+
     if(numberOfParticles > 0)
     {
       vx /= numberOfParticles;
@@ -288,9 +388,9 @@ void PileUpMerger::Process()
     vertex->Position.SetXYZT(vx, vy, dz, dt);
 
     vertex->ClusterIndex = nvtx;
-    vertex->ClusterNDF = nch;
-    vertex->SumPT2 = sumpt2;
-    vertex->GenSumPT2 = sumpt2;
+    vertex->Vertexing()->ClusterNDF = nch;
+    vertex->Vertexing()->SumPT2 = sumpt2;
+    vertex->Vertexing()->GenSumPT2 = sumpt2;
 
     vertex->IsPU = 1;
 
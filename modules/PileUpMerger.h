@@ -30,6 +30,8 @@
 #include "classes/DelphesModule.h"
 
 class TObjArray;
+class TRandom;
+class DelphesPileUpPrefetcher;
 class DelphesPileUpReader;
 class DelphesTF2;
 
@@ -40,10 +42,18 @@ public:
   ~PileUpMerger();
 
   void Init();
+  void InitRun();
+
+  Bool_t IsRunParameter(const char *name) const;
   void Process();
   void Finish();
 
 private:
+  void CreatePrefetcher();
+
+  Int_t DrawNumberOfEvents(TRandom *random) const;
+  Long64_t DrawEntry(TRandom *random) const;
+
   Int_t fPileUpDistribution;
   Double_t fMeanPileUp;
 
@@ -57,8 +67,15 @@ private:
 
   DelphesTF2 *fFunction; //!
 
+  TString fPileUpFile; //!
+
   DelphesPileUpReader *fReader; //!
 
+  Int_t fPrefetchEvents;
+  UInt_t fPrefetchStream;
+
+  DelphesPileUpPrefetcher *fPrefetcher; //!
+
   TIterator *fItInputArray; //!
 
   const TObjArray *fInputArray; //!
@@ -28,7 +28,9 @@
 
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
+#include "classes/DelphesPDGTable.h"
 #include "classes/DelphesPileUpReader.h"
+#include "classes/DelphesRandom.h"
 #include "classes/DelphesTF2.h"
 
 #include "ExRootAnalysis/ExRootClassifier.h"
@@ -37,7 +39,7 @@
 
 #include "Pythia.h"
 
-#include "TDatabasePDG.h"
+#include "RVersion.h"
 #include "TFormula.h"
 #include "TLorentzVector.h"
 #include "TMath.h"
@@ -114,8 +116,8 @@ void PileUpMergerPythia8::Finish()
 
 void PileUpMergerPythia8::Process()
 {
-  TDatabasePDG *pdg = TDatabasePDG::Instance();
-  TParticlePDG *pdgParticle;
+  DelphesPDGTable *pdg = DelphesPDGTable::Instance();
+  Int_t pdgIndex;
   Int_t pid, status;
   Float_t x, y, z, t, vx, vy;
   Float_t px, py, pz, e;
@@ -130,7 +132,11 @@ void PileUpMergerPythia8::Process()
 
   // --- Deal with primary vertex first  ------
 
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6, 24, 0)
+  fFunction->GetRandom2(dz, dt, GetRandom());
+#else
   fFunction->GetRandom2(dz, dt);
+#endif
 
   dt *= c_light * 1.0E3; // necessary in order to make t in mm/c
   dz *= 1.0E3; // necessary in order to make z in mm
@@ -165,13 +171,13 @@ void PileUpMergerPythia8::Process()
   switch(fPileUpDistribution)
   {
   case 0:
-    numberOfEvents = gRandom->Poisson(fMeanPileUp);
+    numberOfEvents = GetRandom()->Poisson(fMeanPileUp);
     break;
   case 1:
-    numberOfEvents = gRandom->Integer(2 * fMeanPileUp + 1);
+    numberOfEvents = GetRandom()->Integer(2 * fMeanPileUp + 1);
     break;
   default:
-    numberOfEvents = gRandom->Poisson(fMeanPileUp);
+    numberOfEvents = GetRandom()->Poisson(fMeanPileUp);
     break;
   }
 
@@ -182,12 +188,16 @@ void PileUpMergerPythia8::Process()
 
     // --- Pile-up vertex smearing
 
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6, 24, 0)
+    fFunction->GetRandom2(dz, dt, GetRandom());
+#else
     fFunction->GetRandom2(dz, dt);
+#endif
 
     dt *= c_light * 1.0E3; // necessary in order to make t in mm/c
     dz *= 1.0E3; // necessary in order to make z in mm
 
-    dphi = gRandom->Uniform(-TMath::Pi(), TMath::Pi());
+    dphi = GetRandom()->Uniform(-TMath::Pi(), TMath::Pi());
 
     vx = 0.0;
     vy = 0.0;
@@ -216,9 +226,9 @@ void PileUpMergerPythia8::Process()
 
       candidate->Status = 1;
 
-      pdgParticle = pdg->GetParticle(pid);
-      candidate->Charge = pdgParticle ? Int_t(pdgParticle->Charge() / 3.0) : -999;
-      candidate->Mass = pdgParticle ? pdgParticle->Mass() : -999.9;
+      pdgIndex = pdg->GetIndex(pid);
+      candidate->Charge = pdg->GetCharge(pdgIndex);
+      candidate->Mass = pdg->GetMass(pdgIndex);
 
       candidate->IsPU = 1;
 
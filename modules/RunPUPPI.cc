@@ -6,6 +6,7 @@
 
 #include "fastjet/PseudoJet.hh"
 
+#include "classes/DelphesArrayChain.h"
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
 #include "classes/DelphesFormula.h"
@@ -22,7 +23,7 @@ using namespace fastjet;
 //------------------------------------------------------------------------------
 RunPUPPI::RunPUPPI() :
   fItTrackInputArray(0),
-  fItNeutralInputArray(0)
+  fNeutralInputChain(0)
 {
 }
 
@@ -36,8 +37,7 @@ void RunPUPPI::Init()
   // input collection
   fTrackInputArray = ImportArray(GetString("TrackInputArray", "Calorimeter/towers"));
   fItTrackInputArray = fTrackInputArray->MakeIterator();
-  fNeutralInputArray = ImportArray(GetString("NeutralInputArray", "Calorimeter/towers"));
-  fItNeutralInputArray = fNeutralInputArray->MakeIterator();
+  fNeutralInputChain = ImportChain(GetString("NeutralInputArray", "Calorimeter/towers"));
   fPVInputArray = ImportArray(GetString("PVInputArray", "PV"));
   fPVItInputArray = fPVInputArray->MakeIterator();
   // puppi parameters
@@ -148,7 +148,6 @@ void RunPUPPI::Init()
 void RunPUPPI::Finish()
 {
   if(fItTrackInputArray) delete fItTrackInputArray;
-  if(fItNeutralInputArray) delete fItNeutralInputArray;
   if(fPuppi) delete fPuppi;
 }
 
@@ -164,7 +163,6 @@ void RunPUPPI::Process()
 
   // loop over input objects
   fItTrackInputArray->Reset();
-  fItNeutralInputArray->Reset();
   fPVItInputArray->Reset();
 
   std::vector<Candidate *> InputParticles;
@@ -233,25 +231,25 @@ void RunPUPPI::Process()
   }
 
   // Loop on neutral calo cells
-  while((candidate = static_cast<Candidate *>(fItNeutralInputArray->Next())))
+  for(Candidate *neutral : DelphesChainView<Candidate>(fNeutralInputChain))
   {
-    momentum = candidate->Momentum;
+    momentum = neutral->Momentum;
     RecoObj curRecoObj;
     curRecoObj.pt = momentum.Pt();
     curRecoObj.eta = momentum.Eta();
     curRecoObj.phi = momentum.Phi();
     curRecoObj.m = momentum.M();
     curRecoObj.charge = 0;
-    particle = static_cast<Candidate *>(candidate->GetCandidates()->At(0));
-    if(candidate->Charge == 0)
+    particle = static_cast<Candidate *>(neutral->GetCandidates()->At(0));
+    if(neutral->Charge == 0)
     {
       curRecoObj.id = 0; // neutrals have id==0
       curRecoObj.vtxId = 0; // neutrals have vtxId==0
-      if(TMath::Abs(candidate->PID) == 11)
+      if(TMath::Abs(neutral->PID) == 11)
         curRecoObj.pfType = 2;
-      else if(TMath::Abs(candidate->PID) == 13)
+      else if(TMath::Abs(neutral->PID) == 13)
         curRecoObj.pfType = 3;
-      else if(TMath::Abs(candidate->PID) == 22)
+      else if(TMath::Abs(neutral->PID) == 22)
         curRecoObj.pfType = 4;
       else
         curRecoObj.pfType = 5;
@@ -263,7 +261,7 @@ void RunPUPPI::Process()
       continue;
     }
     puppiInputVector.push_back(curRecoObj);
-    InputParticles.push_back(candidate);
+    InputParticles.push_back(neutral);
   }
   // Create PUPPI container
   fPuppi->initialize(puppiInputVector);
@@ -6,6 +6,7 @@
 
 class TObjArray;
 class TIterator;
+class DelphesArrayChain;
 class PuppiContainer;
 
 class RunPUPPI: public DelphesModule
@@ -21,11 +22,10 @@ public:
 
 private:
   TIterator *fItTrackInputArray;
-  TIterator *fItNeutralInputArray; //!
   TIterator *fPVItInputArray; //!
 
   const TObjArray *fTrackInputArray;
-  const TObjArray *fNeutralInputArray; //!
+  const DelphesArrayChain *fNeutralInputChain; //!
   const TObjArray *fPVInputArray; //!
   PuppiContainer *fPuppi;
   // puppi parameters
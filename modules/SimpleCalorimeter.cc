@@ -30,6 +30,7 @@
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
 #include "classes/DelphesFormula.h"
+#include "classes/DelphesRandom.h"
 
 #include "ExRootAnalysis/ExRootClassifier.h"
 #include "ExRootAnalysis/ExRootFilter.h"
@@ -124,14 +125,14 @@ void SimpleCalorimeter::Init()
   size = param.GetSize();
 
   // set default energy fractions values
-  fFractionMap.clear();
-  fFractionMap[0] = 1.0;
+  fFractionMap.Clear();
+  fFractionMap.Set(0, 1.0);
 
   for(i = 0; i < size / 2; ++i)
   {
     paramFractions = param[i * 2 + 1];
     fraction = paramFractions[0].GetDouble();
-    fFractionMap[param[i * 2].GetInt()] = fraction;
+    fFractionMap.Set(param[i * 2].GetInt(), fraction);
   }
 
   // read min E value for towers to be saved
@@ -191,8 +192,6 @@ void SimpleCalorimeter::Process()
 
   Int_t pdgCode;
 
-  TFractionMap::iterator itFractionMap;
-
   vector<Double_t>::iterator itEtaBin;
   vector<Double_t>::iterator itPhiBin;
   vector<Double_t> *phiBins;
@@ -209,18 +208,12 @@ void SimpleCalorimeter::Process()
   number = -1;
   while((particle = static_cast<Candidate *>(fItParticleInputArray->Next())))
   {
-    const TLorentzVector &particlePosition = particle->Position;
+    const DelphesLorentzVector &particlePosition = particle->Position;
     ++number;
 
     pdgCode = TMath::Abs(particle->PID);
 
-    itFractionMap = fFractionMap.find(pdgCode);
-    if(itFractionMap == fFractionMap.end())
-    {
-      itFractionMap = fFractionMap.find(0);
-    }
-
-    fraction = itFractionMap->second;
+    fraction = fFractionMap[pdgCode];
     fTowerFractions.push_back(fraction);
 
     if(fraction < 1.0E-9) continue;
@@ -252,18 +245,12 @@ void SimpleCalorimeter::Process()
   number = -1;
   while((track = static_cast<Candidate *>(fItTrackInputArray->Next())))
   {
-    const TLorentzVector &trackPosition = track->Position;
+    const DelphesLorentzVector &trackPosition = track->Position;
     ++number;
 
     pdgCode = TMath::Abs(track->PID);
 
-    itFractionMap = fFractionMap.find(pdgCode);
-    if(itFractionMap == fFractionMap.end())
-    {
-      itFractionMap = fFractionMap.find(0);
-    }
-
-    fraction = itFractionMap->second;
+    fraction = fFractionMap[pdgCode];
 
     fTrackFractions.push_back(fraction);
 
@@ -415,7 +402,6 @@ void SimpleCalorimeter::FinalizeTower()
   Double_t weightTrack, weightCalo, bestEnergyEstimate, rescaleFactor;
 
   TLorentzVector momentum;
-  TFractionMap::iterator itFractionMap;
 
   if(!fTower) return;
 
@@ -431,8 +417,8 @@ void SimpleCalorimeter::FinalizeTower()
 
   if(fSmearTowerCenter)
   {
-    eta = gRandom->Uniform(fTowerEdges[0], fTowerEdges[1]);
-    phi = gRandom->Uniform(fTowerEdges[2], fTowerEdges[3]);
+    eta = GetRandom()->Uniform(fTowerEdges[0], fTowerEdges[1]);
+    phi = GetRandom()->Uniform(fTowerEdges[2], fTowerEdges[3]);
   }
   else
   {
@@ -525,7 +511,7 @@ Double_t SimpleCalorimeter::LogNormal(Double_t mean, Double_t sigma)
     b = TMath::Sqrt(TMath::Log((1.0 + (sigma * sigma) / (mean * mean))));
     a = TMath::Log(mean) - 0.5 * b * b;
 
-    return TMath::Exp(a + b * gRandom->Gaus(0.0, 1.0));
+    return TMath::Exp(a + b * GetRandom()->Gaus(0.0, 1.0));
   }
   else
   {
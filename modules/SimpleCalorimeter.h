@@ -30,6 +30,7 @@
  */
 
 #include "classes/DelphesModule.h"
+#include "classes/DelphesPDGTable.h"
 
 #include <map>
 #include <set>
@@ -50,7 +51,7 @@ public:
   void Finish();
 
 private:
-  typedef std::map<Long64_t, Double_t> TFractionMap; //!
+  typedef DelphesPDGMap<Double_t> TFractionMap; //!
   typedef std::map<Double_t, std::set<Double_t> > TBinMap; //!
 
   Candidate *fTower;
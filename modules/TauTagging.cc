@@ -31,6 +31,7 @@
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
 #include "classes/DelphesFormula.h"
+#include "classes/DelphesRandom.h"
 
 #include "TDatabasePDG.h"
 #include "TFormula.h"
@@ -61,7 +62,7 @@ Int_t TauTaggingPartonClassifier::GetCategory(TObject *object)
   Candidate *daughter1 = 0;
   Candidate *daughter2 = 0;
 
-  const TLorentzVector &momentum = tau->Momentum;
+  const DelphesLorentzVector &momentum = tau->Momentum;
   Int_t pdgCode, i, j;
 
   pdgCode = TMath::Abs(tau->PID);
@@ -162,7 +163,7 @@ void TauTagging::Init()
 
   fFilter = new ExRootFilter(fPartonInputArray);
 
-  fJetInputArray = ImportArray(GetString("JetInputArray", "FastJetFinder/jets"));
+  fJetInputArray = UpdateArray(GetString("JetInputArray", "FastJetFinder/jets"));
   fItJetInputArray = fJetInputArray->MakeIterator();
 }
 
@@ -205,9 +206,9 @@ void TauTagging::Process()
   fItJetInputArray->Reset();
   while((jet = static_cast<Candidate *>(fItJetInputArray->Next())))
   {
-    const TLorentzVector &jetMomentum = jet->Momentum;
+    const DelphesLorentzVector &jetMomentum = jet->Momentum;
     pdgCode = 0;
-    charge = gRandom->Uniform() > 0.5 ? 1 : -1;
+    charge = GetRandom()->Uniform() > 0.5 ? 1 : -1;
     eta = jetMomentum.Eta();
     phi = jetMomentum.Phi();
     pt = jetMomentum.Pt();
@@ -252,7 +253,7 @@ void TauTagging::Process()
 
     // apply an efficency formula
     eff = formula->Eval(pt, eta, phi, e);
-    jet->TauTag |= (gRandom->Uniform() <= eff) << fBitNumber;
+    jet->TauTag |= (GetRandom()->Uniform() <= eff) << fBitNumber;
     jet->TauWeight = eff;
 
     // set tau charge
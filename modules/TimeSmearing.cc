@@ -29,6 +29,7 @@
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
 #include "classes/DelphesFormula.h"
+#include "classes/DelphesRandom.h"
 
 #include "ExRootAnalysis/ExRootClassifier.h"
 #include "ExRootAnalysis/ExRootFilter.h"
@@ -98,13 +99,13 @@ void TimeSmearing::Process()
   while((candidate = static_cast<Candidate *>(fItInputArray->Next())))
   {
     const TLorentzVector &candidateInitialPosition = candidate->InitialPosition;
-    const TLorentzVector &candidateFinalPosition = candidate->Position;
+    const DelphesLorentzVector &candidateFinalPosition = candidate->Position;
 
     ti = candidateInitialPosition.T() * 1.0E-3 / c_light;
     tf = candidateFinalPosition.T() * 1.0E-3 / c_light;
 
     // apply smearing formula
-    tf_smeared = gRandom->Gaus(tf, fTimeResolution);
+    tf_smeared = GetRandom()->Gaus(tf, fTimeResolution);
     ti = ti + tf_smeared - tf;
     tf = tf_smeared;
 
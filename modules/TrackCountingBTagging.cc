@@ -77,7 +77,7 @@ void TrackCountingBTagging::Init()
   fTrackInputArray = ImportArray(GetString("TrackInputArray", "Calorimeter/eflowTracks"));
   fItTrackInputArray = fTrackInputArray->MakeIterator();
 
-  fJetInputArray = ImportArray(GetString("JetInputArray", "FastJetFinder/jets"));
+  fJetInputArray = UpdateArray(GetString("JetInputArray", "FastJetFinder/jets"));
   fItJetInputArray = fJetInputArray->MakeIterator();
 }
 
@@ -107,7 +107,7 @@ void TrackCountingBTagging::Process()
   fItJetInputArray->Reset();
   while((jet = static_cast<Candidate *>(fItJetInputArray->Next())))
   {
-    const TLorentzVector &jetMomentum = jet->Momentum;
+    const DelphesLorentzVector &jetMomentum = jet->Momentum;
     jpx = jetMomentum.Px();
     jpy = jetMomentum.Py();
     jpz = jetMomentum.Pz();
@@ -118,7 +118,7 @@ void TrackCountingBTagging::Process()
     // stop once we have enough tracks
     while((track = static_cast<Candidate *>(fItTrackInputArray->Next())) and count < fNtracks)
     {
-      const TLorentzVector &trkMomentum = track->Momentum;
+      const DelphesLorentzVector &trkMomentum = track->Momentum;
       tpt = trkMomentum.Pt();
       if(tpt < fPtMin) continue;
 
@@ -18,6 +18,7 @@
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
 #include "classes/DelphesFormula.h"
+#include "classes/DelphesRandom.h"
 
 #include "ExRootAnalysis/ExRootClassifier.h"
 #include "ExRootAnalysis/ExRootFilter.h"
@@ -66,7 +67,7 @@ Int_t TrackCountingTauTaggingPartonClassifier::GetCategory(TObject *object)
   Candidate *daughter1 = 0;
   Candidate *daughter2 = 0;
 
-  const TLorentzVector &momentum = tau->Momentum;
+  const DelphesLorentzVector &momentum = tau->Momentum;
   Int_t pdgCode, i, j;
 
   pdgCode = TMath::Abs(tau->PID);
@@ -172,7 +173,7 @@ void TrackCountingTauTagging::Init()
 
   fFilter = new ExRootFilter(fPartonInputArray);
 
-  fJetInputArray = ImportArray(GetString("JetInputArray", "FastJetFinder/jets"));
+  fJetInputArray = UpdateArray(GetString("JetInputArray", "FastJetFinder/jets"));
   fItJetInputArray = fJetInputArray->MakeIterator();
 }
 
@@ -221,7 +222,7 @@ void TrackCountingTauTagging::Process()
   while((jet = static_cast<Candidate *>(fItJetInputArray->Next())))
   {
     identifier = 0;
-    const TLorentzVector &jetMomentum = jet->Momentum;
+    const DelphesLorentzVector &jetMomentum = jet->Momentum;
     pdgCode = 0;
     charge = 0;
     eta = jetMomentum.Eta();
@@ -287,7 +288,7 @@ void TrackCountingTauTagging::Process()
     // apply an efficency formula
 
     // apply an efficency formula
-    jet->TauTag |= (gRandom->Uniform() <= formula->Eval(pt, eta, phi, e)) << fBitNumber;
+    jet->TauTag |= (GetRandom()->Uniform() <= formula->Eval(pt, eta, phi, e)) << fBitNumber;
 
     // set tau charge
     jet->Charge = charge;
@@ -32,6 +32,7 @@
 #include "modules/TrackCovariance.h"
 
 #include "classes/DelphesClasses.h"
+#include "classes/DelphesRandom.h"
 
 #include "TrackCovariance/SolGeom.h"
 #include "TrackCovariance/SolGridCov.h"
@@ -102,11 +103,11 @@ void TrackCovariance::Process()
   while((candidate = static_cast<Candidate *>(fItInputArray->Next())))
   {
     const TLorentzVector &candidatePosition = candidate->InitialPosition;
-    const TLorentzVector &candidateMomentum = candidate->Momentum;
+    const DelphesLorentzVector &candidateMomentum = candidate->Momentum;
 
     mass = candidateMomentum.M();
 
-    ObsTrk track(candidatePosition.Vect(), candidateMomentum.Vect(), candidate->Charge, fBz, fCovariance);
+    ObsTrk track(candidatePosition.Vect(), candidateMomentum.Vect(), candidate->Charge, fBz, fCovariance, GetRandom());
 
     mother = candidate;
     candidate = static_cast<Candidate *>(candidate->Clone());
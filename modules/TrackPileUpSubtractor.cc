@@ -88,7 +88,7 @@ void TrackPileUpSubtractor::Init()
   size = param.GetSize();
   for(i = 0; i < size / 2; ++i)
   {
-    array = ImportArray(param[i * 2].GetString());
+    array = UpdateArray(param[i * 2].GetString());
     iterator = array->MakeIterator();
 
     fInputMap[iterator] = ExportArray(param[i * 2 + 1].GetString());
@@ -146,7 +146,7 @@ void TrackPileUpSubtractor::Process()
     while((candidate = static_cast<Candidate *>(iterator->Next())))
     {
       particle = static_cast<Candidate *>(candidate->GetCandidates()->At(0));
-      const TLorentzVector &candidateMomentum = particle->Momentum;
+      const DelphesLorentzVector &candidateMomentum = particle->Momentum;
 
       eta = candidateMomentum.Eta();
       pt = candidateMomentum.Pt();
@@ -11,6 +11,7 @@
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
 #include "classes/DelphesFormula.h"
+#include "classes/DelphesRandom.h"
 
 #include "ExRootAnalysis/ExRootClassifier.h"
 #include "ExRootAnalysis/ExRootFilter.h"
@@ -217,7 +218,7 @@ void TrackSmearing::Process()
   while((candidate = static_cast<Candidate *>(fItInputArray->Next())))
   {
 
-    const TLorentzVector &momentum = candidate->Momentum;
+    const DelphesLorentzVector &momentum = candidate->Momentum;
     const TLorentzVector &position = candidate->InitialPosition;
 
     pt = momentum.Pt();
@@ -308,11 +309,11 @@ void TrackSmearing::Process()
 
     if(fApplyToPileUp || !candidate->IsPU)
     {
-      d0 = gRandom->Gaus(d0, d0Error);
-      dz = gRandom->Gaus(dz, dzError);
-      p = gRandom->Gaus(p, pError);
-      ctgTheta = gRandom->Gaus(ctgTheta, ctgThetaError);
-      phi = gRandom->Gaus(phi, phiError);
+      d0 = GetRandom()->Gaus(d0, d0Error);
+      dz = GetRandom()->Gaus(dz, dzError);
+      p = GetRandom()->Gaus(p, pError);
+      ctgTheta = GetRandom()->Gaus(ctgTheta, ctgThetaError);
+      phi = GetRandom()->Gaus(phi, phiError);
     }
 
     if(p < 0.0) continue;
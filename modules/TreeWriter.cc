@@ -40,6 +40,7 @@
 #include "TLorentzVector.h"
 #include "TMath.h"
 #include "TObjArray.h"
+#include "TProcessID.h"
 #include "TROOT.h"
 #include "TRandom3.h"
 #include "TString.h"
@@ -53,6 +54,15 @@ using namespace std;
 
 //------------------------------------------------------------------------------
 
+static bool CompareSumPT2(const TObject *object1, const TObject *object2)
+{
+  const Candidate *candidate1 = static_cast<const Candidate *>(object1);
+  const Candidate *candidate2 = static_cast<const Candidate *>(object2);
+  return candidate1->GetVertexing()->SumPT2 > candidate2->GetVertexing()->SumPT2;
+}
+
+//------------------------------------------------------------------------------
+
 TreeWriter::TreeWriter()
 {
 }
@@ -117,7 +127,13 @@ void TreeWriter::Init()
       continue;
     }
 
-    array = ImportArray(branchInputArray);
+    // vertices, photons, electrons, muons and jets are sorted in place
+    // before being written, the other modules must be done with them
+    if(branchClass == Vertex::Class() || branchClass == Photon::Class() || branchClass == Electron::Class()
+       || branchClass == Muon::Class() || branchClass == Jet::Class())
+      array = UpdateArray(branchInputArray);
+    else
+      array = ImportArray(branchInputArray);
     branch = NewBranch(branchName, branchClass);
 
     fBranchMap.insert(make_pair(branch, make_pair(itClassMap->second, array)));
@@ -319,13 +335,13 @@ void TreeWriter::ProcessParticles(ExRootTreeBranch *branch, TObjArray *array)
   iterator.Reset();
   while((candidate = static_cast<Candidate *>(iterator.Next())))
   {
-    const TLorentzVector &momentum = candidate->Momentum;
-    const TLorentzVector &position = candidate->Position;
+    const DelphesLorentzVector &momentum = candidate->Momentum;
+    const DelphesLorentzVector &position = candidate->Position;
 
     entry = static_cast<GenParticle *>(branch->NewEntry());
 
     entry->SetBit(kIsReferenced);
-    entry->SetUniqueID(candidate->GetUniqueID());
+    entry->SetUniqueID(TProcessID::AssignID(candidate));
 
     pt = momentum.Pt();
     cosTheta = TMath::Abs(momentum.CosTheta());
@@ -380,6 +396,7 @@ void TreeWriter::ProcessVertices(ExRootTreeBranch *branch, TObjArray *array)
 {
   TIter iterator(array);
   Candidate *candidate = 0, *constituent = 0;
+  const CandidateVertexing *vertexing = 0;
   Vertex *entry = 0;
 
   const Double_t c_light = 2.99792458E8;
@@ -387,23 +404,23 @@ void TreeWriter::ProcessVertices(ExRootTreeBranch *branch, TObjArray *array)
   Double_t x, y, z, t, xError, yError, zError, tError, sigma, sumPT2, btvSumPT2, genDeltaZ, genSumPT2;
   UInt_t index, ndf;
 
-  CompBase *compare = Candidate::fgCompare;
-  Candidate::fgCompare = CompSumPT2<Candidate>::Instance();
-  array->Sort();
-  Candidate::fgCompare = compare;
+  // Candidate::fgCompare is left untouched, other modules may be sorting candidates
+  stable_sort(array->GetObjectRef(), array->GetObjectRef() + array->GetEntriesFast(), CompareSumPT2);
 
   // loop over all vertices
   iterator.Reset();
   while((candidate = static_cast<Candidate *>(iterator.Next())))
   {
 
+    vertexing = candidate->GetVertexing();
+
     index = candidate->ClusterIndex;
-    ndf = candidate->ClusterNDF;
-    sigma = candidate->ClusterSigma;
-    sumPT2 = candidate->SumPT2;
-    btvSumPT2 = candidate->BTVSumPT2;
-    genDeltaZ = candidate->GenDeltaZ;
-    genSumPT2 = candidate->GenSumPT2;
+    ndf = vertexing->ClusterNDF;
+    sigma = vertexing->ClusterSigma;
+    sumPT2 = vertexing->SumPT2;
+    btvSumPT2 = vertexing->BTVSumPT2;
+    genDeltaZ = vertexing->GenDeltaZ;
+    genSumPT2 = vertexing->GenSumPT2;
 
     x = candidate->Position.X();
     y = candidate->Position.Y();
@@ -463,7 +480,7 @@ void TreeWriter::ProcessTracks(ExRootTreeBranch *branch, TObjArray *array)
   iterator.Reset();
   while((candidate = static_cast<Candidate *>(iterator.Next())))
   {
-    const TLorentzVector &position = candidate->Position;
+    const DelphesLorentzVector &position = candidate->Position;
 
     cosTheta = TMath::Abs(position.CosTheta());
     signz = (position.Pz() >= 0.0) ? 1.0 : -1.0;
@@ -473,7 +490,7 @@ void TreeWriter::ProcessTracks(ExRootTreeBranch *branch, TObjArray *array)
     entry = static_cast<Track *>(branch->NewEntry());
 
     entry->SetBit(kIsReferenced);
-    entry->SetUniqueID(candidate->GetUniqueID());
+    entry->SetUniqueID(TProcessID::AssignID(candidate));
 
     entry->PID = candidate->PID;
 
@@ -503,7 +520,7 @@ void TreeWriter::ProcessTracks(ExRootTreeBranch *branch, TObjArray *array)
     entry->Yd = candidate->Yd;
     entry->Zd = candidate->Zd;
 
-    const TLorentzVector &momentum = candidate->Momentum;
+    const DelphesLorentzVector &momentum = candidate->Momentum;
 
     pt = momentum.Pt();
     p = momentum.P();
@@ -522,7 +539,7 @@ void TreeWriter::ProcessTracks(ExRootTreeBranch *branch, TObjArray *array)
     entry->CtgTheta = ctgTheta;
 
     particle = static_cast<Candidate *>(candidate->GetCandidates()->At(0));
-    const TLorentzVector &initialPosition = particle->Position;
+    const DelphesLorentzVector &initialPosition = particle->Position;
 
     entry->X = initialPosition.X();
     entry->Y = initialPosition.Y();
@@ -552,8 +569,8 @@ void TreeWriter::ProcessTowers(ExRootTreeBranch *branch, TObjArray *array)
   iterator.Reset();
   while((candidate = static_cast<Candidate *>(iterator.Next())))
   {
-    const TLorentzVector &momentum = candidate->Momentum;
-    const TLorentzVector &position = candidate->Position;
+    const DelphesLorentzVector &momentum = candidate->Momentum;
+    const DelphesLorentzVector &position = candidate->Position;
 
     pt = momentum.Pt();
     cosTheta = TMath::Abs(momentum.CosTheta());
@@ -564,7 +581,7 @@ void TreeWriter::ProcessTowers(ExRootTreeBranch *branch, TObjArray *array)
     entry = static_cast<Tower *>(branch->NewEntry());
 
     entry->SetBit(kIsReferenced);
-    entry->SetUniqueID(candidate->GetUniqueID());
+    entry->SetUniqueID(TProcessID::AssignID(candidate));
 
     entry->Eta = eta;
     entry->Phi = momentum.Phi();
@@ -578,7 +595,7 @@ void TreeWriter::ProcessTowers(ExRootTreeBranch *branch, TObjArray *array)
     entry->Edges[3] = candidate->Edges[3];
 
     entry->T = position.T() * 1.0E-3 / c_light;
-    entry->NTimeHits = candidate->NTimeHits;
+    entry->NTimeHits = candidate->GetTiming()->NTimeHits;
 
     FillParticles(candidate, &entry->Particles);
   }
@@ -609,7 +626,7 @@ void TreeWriter::ProcessParticleFlowCandidates(ExRootTreeBranch *branch, TObjArr
     //std::cout << "==============================================" << std::endl;
     //std::cout << "==============================================" << std::endl;
 
-    const TLorentzVector &position = candidate->Position;
+    const DelphesLorentzVector &position = candidate->Position;
 
     cosTheta = TMath::Abs(position.CosTheta());
     signz = (position.Pz() >= 0.0) ? 1.0 : -1.0;
@@ -619,7 +636,7 @@ void TreeWriter::ProcessParticleFlowCandidates(ExRootTreeBranch *branch, TObjArr
     entry = static_cast<ParticleFlowCandidate *>(branch->NewEntry());
 
     entry->SetBit(kIsReferenced);
-    entry->SetUniqueID(candidate->GetUniqueID());
+    entry->SetUniqueID(TProcessID::AssignID(candidate));
 
     entry->PID = candidate->PID;
 
@@ -651,7 +668,7 @@ void TreeWriter::ProcessParticleFlowCandidates(ExRootTreeBranch *branch, TObjArr
     entry->Yd = candidate->Yd;
     entry->Zd = candidate->Zd;
 
-    const TLorentzVector &momentum = candidate->Momentum;
+    const DelphesLorentzVector &momentum = candidate->Momentum;
 
     e = momentum.E();
     pt = momentum.Pt();
@@ -674,7 +691,7 @@ void TreeWriter::ProcessParticleFlowCandidates(ExRootTreeBranch *branch, TObjArr
     //std::cout << "Reconstructed PID, PT, ETA, PHI, E:   " << candidate->PID << " " << pt << " " << momentum.Eta() << " " << phi << " " << e << std::endl;
 
     particle = static_cast<Candidate *>(candidate->GetCandidates()->At(0));
-    const TLorentzVector &initialPosition = particle->Position;
+    const DelphesLorentzVector &initialPosition = particle->Position;
 
     entry->X = initialPosition.X();
     entry->Y = initialPosition.Y();
@@ -691,7 +708,7 @@ void TreeWriter::ProcessParticleFlowCandidates(ExRootTreeBranch *branch, TObjArr
     entry->Edges[3] = candidate->Edges[3];
 
     entry->T = position.T() * 1.0E-3 / c_light;
-    entry->NTimeHits = candidate->NTimeHits;
+    entry->NTimeHits = candidate->GetTiming()->NTimeHits;
 
     std::pair<TLorentzVector,TLorentzVector> p4s = FillParticlesCustom(candidate, &entry->Particles, false);
     TLorentzVector hard = p4s.first;
@@ -733,8 +750,8 @@ void TreeWriter::ProcessPhotons(ExRootTreeBranch *branch, TObjArray *array)
   while((candidate = static_cast<Candidate *>(iterator.Next())))
   {
     TIter it1(candidate->GetCandidates());
-    const TLorentzVector &momentum = candidate->Momentum;
-    const TLorentzVector &position = candidate->Position;
+    const DelphesLorentzVector &momentum = candidate->Momentum;
+    const DelphesLorentzVector &position = candidate->Position;
 
     pt = momentum.Pt();
     cosTheta = TMath::Abs(momentum.CosTheta());
@@ -784,8 +801,8 @@ void TreeWriter::ProcessElectrons(ExRootTreeBranch *branch, TObjArray *array)
   iterator.Reset();
   while((candidate = static_cast<Candidate *>(iterator.Next())))
   {
-    const TLorentzVector &momentum = candidate->Momentum;
-    const TLorentzVector &position = candidate->Position;
+    const DelphesLorentzVector &momentum = candidate->Momentum;
+    const DelphesLorentzVector &position = candidate->Position;
 
     pt = momentum.Pt();
     cosTheta = TMath::Abs(momentum.CosTheta());
@@ -843,8 +860,8 @@ void TreeWriter::ProcessMuons(ExRootTreeBranch *branch, TObjArray *array)
   iterator.Reset();
   while((candidate = static_cast<Candidate *>(iterator.Next())))
   {
-    const TLorentzVector &momentum = candidate->Momentum;
-    const TLorentzVector &position = candidate->Position;
+    const DelphesLorentzVector &momentum = candidate->Momentum;
+    const DelphesLorentzVector &position = candidate->Position;
 
     pt = momentum.Pt();
     cosTheta = TMath::Abs(momentum.CosTheta());
@@ -855,7 +872,7 @@ void TreeWriter::ProcessMuons(ExRootTreeBranch *branch, TObjArray *array)
     entry = static_cast<Muon *>(branch->NewEntry());
 
     entry->SetBit(kIsReferenced);
-    entry->SetUniqueID(candidate->GetUniqueID());
+    entry->SetUniqueID(TProcessID::AssignID(candidate));
 
     entry->Eta = eta;
     entry->Phi = momentum.Phi();
@@ -890,6 +907,8 @@ void TreeWriter::ProcessJets(ExRootTreeBranch *branch, TObjArray *array)
 {
   TIter iterator(array);
   Candidate *candidate = 0, *constituent = 0;
+  const CandidateJetID *jetID = 0;
+  const CandidateSubstructure *substructure = 0;
   Jet *entry = 0;
   Double_t pt, signPz, cosTheta, eta, rapidity;
   Double_t ecalEnergy, hcalEnergy;
@@ -904,8 +923,8 @@ void TreeWriter::ProcessJets(ExRootTreeBranch *branch, TObjArray *array)
   {
     TIter itConstituents(candidate->GetCandidates());
 
-    const TLorentzVector &momentum = candidate->Momentum;
-    const TLorentzVector &position = candidate->Position;
+    const DelphesLorentzVector &momentum = candidate->Momentum;
+    const DelphesLorentzVector &position = candidate->Position;
 
     pt = momentum.Pt();
     cosTheta = TMath::Abs(momentum.CosTheta());
@@ -957,40 +976,44 @@ void TreeWriter::ProcessJets(ExRootTreeBranch *branch, TObjArray *array)
 
     //---   Pile-Up Jet ID variables ----
 
-    entry->NCharged = candidate->NCharged;
-    entry->NNeutrals = candidate->NNeutrals;
+    jetID = candidate->GetJetID();
 
-    entry->NeutralEnergyFraction = candidate->NeutralEnergyFraction;
-    entry->ChargedEnergyFraction = candidate->ChargedEnergyFraction;
-    entry->Beta = candidate->Beta;
-    entry->BetaStar = candidate->BetaStar;
-    entry->MeanSqDeltaR = candidate->MeanSqDeltaR;
-    entry->PTD = candidate->PTD;
+    entry->NCharged = jetID->NCharged;
+    entry->NNeutrals = jetID->NNeutrals;
+
+    entry->NeutralEnergyFraction = jetID->NeutralEnergyFraction;
+    entry->ChargedEnergyFraction = jetID->ChargedEnergyFraction;
+    entry->Beta = jetID->Beta;
+    entry->BetaStar = jetID->BetaStar;
+    entry->MeanSqDeltaR = jetID->MeanSqDeltaR;
+    entry->PTD = jetID->PTD;
 
     //--- Sub-structure variables ----
 
-    entry->NSubJetsTrimmed = candidate->NSubJetsTrimmed;
-    entry->NSubJetsPruned = candidate->NSubJetsPruned;
-    entry->NSubJetsSoftDropped = candidate->NSubJetsSoftDropped;
+    substructure = candidate->GetSubstructure();
+
+    entry->NSubJetsTrimmed = substructure->NSubJetsTrimmed;
+    entry->NSubJetsPruned = substructure->NSubJetsPruned;
+    entry->NSubJetsSoftDropped = substructure->NSubJetsSoftDropped;
 
-    entry->SoftDroppedJet = candidate->SoftDroppedJet;
-    entry->SoftDroppedSubJet1 = candidate->SoftDroppedSubJet1;
-    entry->SoftDroppedSubJet2 = candidate->SoftDroppedSubJet2;
+    entry->SoftDroppedJet = substructure->SoftDroppedJet;
+    entry->SoftDroppedSubJet1 = substructure->SoftDroppedSubJet1;
+    entry->SoftDroppedSubJet2 = substructure->SoftDroppedSubJet2;
 
     for(i = 0; i < 5; i++)
     {
-      entry->FracPt[i] = candidate->FracPt[i];
-      entry->Tau[i] = candidate->Tau[i];
-      entry->TrimmedP4[i] = candidate->TrimmedP4[i];
-      entry->PrunedP4[i] = candidate->PrunedP4[i];
-      entry->SoftDroppedP4[i] = candidate->SoftDroppedP4[i];
+      entry->FracPt[i] = jetID->FracPt[i];
+      entry->Tau[i] = substructure->Tau[i];
+      entry->TrimmedP4[i] = substructure->TrimmedP4[i];
+      entry->PrunedP4[i] = substructure->PrunedP4[i];
+      entry->SoftDroppedP4[i] = substructure->SoftDroppedP4[i];
     }
 
     //--- exclusive clustering variables ---
-    entry->ExclYmerge23 = candidate->ExclYmerge23;
-    entry->ExclYmerge34 = candidate->ExclYmerge34;
-    entry->ExclYmerge45 = candidate->ExclYmerge45;
-    entry->ExclYmerge56 = candidate->ExclYmerge56;
+    entry->ExclYmerge23 = substructure->ExclYmerge23;
+    entry->ExclYmerge34 = substructure->ExclYmerge34;
+    entry->ExclYmerge45 = substructure->ExclYmerge45;
+    entry->ExclYmerge56 = substructure->ExclYmerge56;
 
     FillParticles(candidate, &entry->Particles);
   }
@@ -1006,7 +1029,7 @@ void TreeWriter::ProcessMissingET(ExRootTreeBranch *branch, TObjArray *array)
   // get the first entry
   if((candidate = static_cast<Candidate *>(array->At(0))))
   {
-    const TLorentzVector &momentum = candidate->Momentum;
+    const DelphesLorentzVector &momentum = candidate->Momentum;
 
     entry = static_cast<MissingET *>(branch->NewEntry());
 
@@ -1026,7 +1049,7 @@ void TreeWriter::ProcessScalarHT(ExRootTreeBranch *branch, TObjArray *array)
   // get the first entry
   if((candidate = static_cast<Candidate *>(array->At(0))))
   {
-    const TLorentzVector &momentum = candidate->Momentum;
+    const DelphesLorentzVector &momentum = candidate->Momentum;
 
     entry = static_cast<ScalarHT *>(branch->NewEntry());
 
@@ -1046,7 +1069,7 @@ void TreeWriter::ProcessRho(ExRootTreeBranch *branch, TObjArray *array)
   iterator.Reset();
   while((candidate = static_cast<Candidate *>(iterator.Next())))
   {
-    const TLorentzVector &momentum = candidate->Momentum;
+    const DelphesLorentzVector &momentum = candidate->Momentum;
 
     entry = static_cast<Rho *>(branch->NewEntry());
 
@@ -1066,7 +1089,7 @@ void TreeWriter::ProcessWeight(ExRootTreeBranch *branch, TObjArray *array)
   // get the first entry
   if((candidate = static_cast<Candidate *>(array->At(0))))
   {
-    const TLorentzVector &momentum = candidate->Momentum;
+    const DelphesLorentzVector &momentum = candidate->Momentum;
 
     entry = static_cast<Weight *>(branch->NewEntry());
 
@@ -1086,8 +1109,8 @@ void TreeWriter::ProcessHectorHit(ExRootTreeBranch *branch, TObjArray *array)
   iterator.Reset();
   while((candidate = static_cast<Candidate *>(iterator.Next())))
   {
-    const TLorentzVector &position = candidate->Position;
-    const TLorentzVector &momentum = candidate->Momentum;
+    const DelphesLorentzVector &position = candidate->Position;
+    const DelphesLorentzVector &momentum = candidate->Momentum;
 
     entry = static_cast<HectorHit *>(branch->NewEntry());
 
@@ -65,7 +65,7 @@ UniqueObjectFinder::~UniqueObjectFinder()
 
 void UniqueObjectFinder::Init()
 {
-  // use GetUniqueID algorithm to find unique objects (faster than the default Overlaps method)
+  // compare only the identities of the candidates, not those of their constituents
   fUseUniqueID = GetBool("UseUniqueID", false);
 
   // import arrays with output from other modules
@@ -110,6 +110,9 @@ void UniqueObjectFinder::Process()
   vector<pair<TIterator *, TObjArray *> >::iterator itInputMap;
   TIterator *iterator;
   TObjArray *array;
+  Int_t i, size;
+
+  fClaimedIDs.clear();
 
   // loop over all input arrays
   for(itInputMap = fInputMap.begin(); itInputMap != fInputMap.end(); ++itInputMap)
@@ -121,50 +124,57 @@ void UniqueObjectFinder::Process()
     iterator->Reset();
     while((candidate = static_cast<Candidate *>(iterator->Next())))
     {
-      if(Unique(candidate, itInputMap))
+      if(Unique(candidate))
       {
         array->Add(candidate);
       }
     }
+
+    // candidates of the following arrays are compared with the unique ones of this array
+    size = array->GetEntriesFast();
+    for(i = 0; i < size; ++i)
+    {
+      Claim(static_cast<Candidate *>(array->UncheckedAt(i)));
+    }
   }
 }
 
 //------------------------------------------------------------------------------
 
-Bool_t UniqueObjectFinder::Unique(Candidate *candidate, vector<pair<TIterator *, TObjArray *> >::iterator itInputMap)
+Bool_t UniqueObjectFinder::Unique(const Candidate *candidate) const
 {
-  Candidate *previousCandidate;
-  vector<pair<TIterator *, TObjArray *> >::iterator previousItInputMap;
-  TObjArray *array;
+  vector<ULong64_t>::const_iterator itIDs;
+
+  if(fClaimedIDs.empty()) return kTRUE;
 
-  // loop over previous arrays
-  for(previousItInputMap = fInputMap.begin(); previousItInputMap != itInputMap; ++previousItInputMap)
+  if(fUseUniqueID)
   {
-    array = previousItInputMap->second;
-    TIter iterator(array);
+    return fClaimedIDs.find(candidate->GetCandidateID()) == fClaimedIDs.end();
+  }
 
-    // loop over all candidates
-    iterator.Reset();
-    while((previousCandidate = static_cast<Candidate *>(iterator.Next())))
-    {
-      if(fUseUniqueID)
-      {
-        if(candidate->GetUniqueID() == previousCandidate->GetUniqueID())
-        {
-          return kFALSE;
-        }
-      }
-      else
-      {
-        if(candidate->Overlaps(previousCandidate))
-        {
-          return kFALSE;
-        }
-      }
-    }
+  // two candidates overlap when they have a common identity, see Candidate::Overlaps
+  const vector<ULong64_t> &ids = candidate->GetConstituentIDs();
+  for(itIDs = ids.begin(); itIDs != ids.end(); ++itIDs)
+  {
+    if(fClaimedIDs.find(*itIDs) != fClaimedIDs.end()) return kFALSE;
   }
 
   return kTRUE;
 }
 
 //------------------------------------------------------------------------------
+
+void UniqueObjectFinder::Claim(const Candidate *candidate)
+{
+  if(fUseUniqueID)
+  {
+    fClaimedIDs.insert(candidate->GetCandidateID());
+  }
+  else
+  {
+    const vector<ULong64_t> &ids = candidate->GetConstituentIDs();
+    fClaimedIDs.insert(ids.begin(), ids.end());
+  }
+}
+
+//------------------------------------------------------------------------------
@@ -29,6 +29,7 @@
 
 #include "classes/DelphesModule.h"
 
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -49,10 +50,14 @@ public:
 private:
   Bool_t fUseUniqueID;
 
-  Bool_t Unique(Candidate *candidate, std::vector<std::pair<TIterator *, TObjArray *> >::iterator itInputMap);
+  Bool_t Unique(const Candidate *candidate) const;
+  void Claim(const Candidate *candidate);
 
   std::vector<std::pair<TIterator *, TObjArray *> > fInputMap; //!
 
+  // identities of the unique candidates of the arrays already processed
+  std::unordered_set<ULong64_t> fClaimedIDs; //!
+
   ClassDef(UniqueObjectFinder, 1)
 };
 
@@ -66,7 +66,7 @@ void VertexFinder::Init()
   fMinNDF = GetInt("MinNDF", 4);
   fGrowSeeds = GetInt("GrowSeeds", 1);
 
-  fInputArray = ImportArray(GetString("InputArray", "TrackSmearing/tracks"));
+  fInputArray = UpdateArray(GetString("InputArray", "TrackSmearing/tracks"));
   fItInputArray = fInputArray->MakeIterator();
 
   fOutputArray = ExportArray(GetString("OutputArray", "tracks"));
@@ -97,6 +97,7 @@ static Bool_t secondDescending(pair<UInt_t, Double_t> pair0, pair<UInt_t, Double
 void VertexFinder::Process()
 {
   Candidate *candidate;
+  UInt_t trackID;
 
   // Clear the track and cluster maps before starting
   trackIDToDouble.clear();
@@ -142,12 +143,14 @@ void VertexFinder::Process()
   }
 
   // Add tracks to the output array after updating their ClusterIndex.
+  trackID = 0;
   fItInputArray->Reset();
   while((candidate = static_cast<Candidate *>(fItInputArray->Next())))
   {
+    ++trackID;
     if(candidate->Momentum.Pt() < fMinPT || fabs(candidate->Momentum.Eta()) > fMaxEta)
       continue;
-    candidate->ClusterIndex = trackIDToInt.at(candidate->GetUniqueID()).at("clusterIndex");
+    candidate->ClusterIndex = trackIDToInt.at(trackID).at("clusterIndex");
     fOutputArray->Add(candidate);
   }
 
@@ -169,9 +172,9 @@ void VertexFinder::Process()
     candidate = factory->NewCandidate();
 
     candidate->ClusterIndex = cluster->first;
-    candidate->ClusterNDF = clusterIDToInt.at(cluster->first).at("ndf");
-    candidate->ClusterSigma = fSigma;
-    candidate->SumPT2 = cluster->second;
+    candidate->Vertexing()->ClusterNDF = clusterIDToInt.at(cluster->first).at("ndf");
+    candidate->Vertexing()->ClusterSigma = fSigma;
+    candidate->Vertexing()->SumPT2 = cluster->second;
     candidate->Position.SetXYZT(0.0, 0.0, clusterIDToDouble.at(cluster->first).at("z"), 0.0);
     candidate->PositionError.SetXYZT(0.0, 0.0, clusterIDToDouble.at(cluster->first).at("ez"), 0.0);
 
@@ -184,29 +187,31 @@ void VertexFinder::Process()
 void VertexFinder::createSeeds()
 {
   Candidate *candidate;
-  UInt_t clusterIndex = 0, maxSeeds = 0;
+  UInt_t clusterIndex = 0, maxSeeds = 0, trackID = 0;
 
-  // Loop over all tracks, initializing some variables.
+  // Loop over all tracks, initializing some variables. Tracks are identified
+  // by their position in the input array, starting from one.
   fItInputArray->Reset();
   while((candidate = static_cast<Candidate *>(fItInputArray->Next())))
   {
+    ++trackID;
     if(candidate->Momentum.Pt() < fMinPT || fabs(candidate->Momentum.Eta()) > fMaxEta)
       continue;
 
-    trackIDToDouble[candidate->GetUniqueID()]["pt"] = candidate->Momentum.Pt();
-    trackIDToDouble[candidate->GetUniqueID()]["ept"] = candidate->ErrorPT ? candidate->ErrorPT : 1.0e-15;
+    trackIDToDouble[trackID]["pt"] = candidate->Momentum.Pt();
+    trackIDToDouble[trackID]["ept"] = candidate->ErrorPT ? candidate->ErrorPT : 1.0e-15;
     ;
-    trackIDToDouble[candidate->GetUniqueID()]["eta"] = candidate->Momentum.Eta();
+    trackIDToDouble[trackID]["eta"] = candidate->Momentum.Eta();
 
-    trackIDToDouble[candidate->GetUniqueID()]["z"] = candidate->DZ;
-    trackIDToDouble[candidate->GetUniqueID()]["ez"] = candidate->ErrorDZ ? candidate->ErrorDZ : 1.0e-15;
+    trackIDToDouble[trackID]["z"] = candidate->DZ;
+    trackIDToDouble[trackID]["ez"] = candidate->ErrorDZ ? candidate->ErrorDZ : 1.0e-15;
 
-    trackIDToInt[candidate->GetUniqueID()]["clusterIndex"] = -1;
-    trackIDToInt[candidate->GetUniqueID()]["interactionIndex"] = candidate->IsPU;
+    trackIDToInt[trackID]["clusterIndex"] = -1;
+    trackIDToInt[trackID]["interactionIndex"] = candidate->IsPU;
 
-    trackIDToBool[candidate->GetUniqueID()]["claimed"] = false;
+    trackIDToBool[trackID]["claimed"] = false;
 
-    trackPT.push_back(make_pair(candidate->GetUniqueID(), candidate->Momentum.Pt()));
+    trackPT.push_back(make_pair(trackID, candidate->Momentum.Pt()));
   }
 
   // Sort tracks by pt and leave only the SeedMinPT highest pt ones in the
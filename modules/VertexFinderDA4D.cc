@@ -128,7 +128,7 @@ void VertexFinderDA4D::Init()
   fDzCutOff /= 10.0; // Adaptive Fitter uses 3.0 but that appears to be a bit tight here sometimes
   fD0CutOff /= 10.0;
 
-  fInputArray = ImportArray(GetString("InputArray", "TrackSmearing/tracks"));
+  fInputArray = UpdateArray(GetString("InputArray", "TrackSmearing/tracks"));
   fItInputArray = fInputArray->MakeIterator();
 
   fOutputArray = ExportArray(GetString("OutputArray", "tracks"));
@@ -243,8 +243,8 @@ void VertexFinderDA4D::Process()
 
     candidate->Position.SetXYZT(0.0, 0.0, meanpos * 10.0, meantime * c_light);
     candidate->PositionError.SetXYZT(0.0, 0.0, errpos * 10.0, errtime * c_light);
-    candidate->SumPT2 = sumpt2;
-    candidate->ClusterNDF = itr;
+    candidate->Vertexing()->SumPT2 = sumpt2;
+    candidate->Vertexing()->ClusterNDF = itr;
     candidate->ClusterIndex = ivtx;
 
     fVertexOutputArray->Add(candidate);
@@ -259,7 +259,7 @@ void VertexFinderDA4D::Process()
       std::cout << " " << candidate->Position.T() / c_light;
 
       std::cout << std::endl;
-      std::cout << "sumpt2 " << candidate->SumPT2 << endl;
+      std::cout << "sumpt2 " << candidate->GetVertexing()->SumPT2 << endl;
 
       std::cout << "ex,ey,ez";
       std::cout << ",et";
@@ -62,7 +62,7 @@ VertexSorter::~VertexSorter()
 
 void VertexSorter::Init()
 {
-  fInputArray = ImportArray(GetString("InputArray", "VertexFinder/vertices"));
+  fInputArray = UpdateArray(GetString("InputArray", "VertexFinder/vertices"));
 
   fTrackInputArray = ImportArray(GetString("TrackInputArray", "VertexFinder/tracks"));
   fItTrackInputArray = fTrackInputArray->MakeIterator();
@@ -220,11 +220,11 @@ void VertexSorter::Process()
   {
     Candidate *cluster = (Candidate *)fInputArray->At(clusterIDToIndex.at(itSortedClusterIDs->first));
     if(fMethod == "BTV")
-      cluster->BTVSumPT2 = itSortedClusterIDs->second;
+      cluster->Vertexing()->BTVSumPT2 = itSortedClusterIDs->second;
     else if(fMethod == "GenClosest")
-      cluster->GenDeltaZ = itSortedClusterIDs->second;
+      cluster->Vertexing()->GenDeltaZ = itSortedClusterIDs->second;
     else if(fMethod == "GenBest")
-      cluster->GenSumPT2 = itSortedClusterIDs->second;
+      cluster->Vertexing()->GenSumPT2 = itSortedClusterIDs->second;
     fOutputArray->Add(cluster);
   }
 }
@@ -21,6 +21,9 @@
 #include <stdexcept>
 
 #include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "TApplication.h"
 #include "TROOT.h"
@@ -32,6 +35,7 @@
 #include "TParticlePDG.h"
 #include "TStopwatch.h"
 
+#include "classes/DelphesCheckpoint.h"
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
 #include "classes/DelphesHepMCReader.h"
@@ -68,14 +72,42 @@ int main(int argc, char *argv[])
   DelphesFactory *factory = 0;
   TObjArray *stableParticleOutputArray = 0, *allParticleOutputArray = 0, *partonOutputArray = 0;
   DelphesHepMCReader *reader = 0;
-  Int_t i, maxEvents, skipEvents;
-  Long64_t length, eventCounter;
+  DelphesCheckpoint *checkpoint = 0;
+  Int_t i, maxEvents, skipEvents, checkpointInterval;
+  Long64_t length, eventCounter, processedEvents;
+  Bool_t resume, resumed;
+
+  checkpointInterval = 0;
+  resume = kFALSE;
+  resumed = kFALSE;
+  while(argc > 1 && argv[1][0] == '-' && argv[1][1] != '\0')
+  {
+    if(argc > 2 && strcmp(argv[1], "-checkpoint") == 0)
+    {
+      checkpointInterval = atoi(argv[2]);
+      argv += 2;
+      argc -= 2;
+    }
+    else if(strcmp(argv[1], "-resume") == 0)
+    {
+      resume = kTRUE;
+      argv += 1;
+      argc -= 1;
+    }
+    else
+    {
+      break;
+    }
+  }
 
-  if(argc < 3)
+  if(argc < 3 || checkpointInterval < 0)
   {
-    cout << " Usage: " << appName << " config_file"
+    cout << " Usage: " << appName << " [-checkpoint N] [-resume]"
+         << " config_file"
          << " output_file"
          << " [input_file(s)]" << endl;
+    cout << " -checkpoint N - save the output and the input position every N events," << endl;
+    cout << " -resume - continue from the last checkpoint of a killed job," << endl;
     cout << " config_file - configuration file in Tcl format," << endl;
     cout << " output_file - output file in ROOT format," << endl;
     cout << " input_file(s) - input file(s) in HepMC format," << endl;
@@ -84,6 +116,7 @@ int main(int argc, char *argv[])
   }
 
   signal(SIGINT, SignalHandler);
+  if(checkpointInterval > 0) signal(SIGTERM, SignalHandler);
 
   gROOT->SetBatch();
 
@@ -93,7 +126,14 @@ int main(int argc, char *argv[])
 
   try
   {
-    outputFile = TFile::Open(argv[2], "CREATE");
+    if(checkpointInterval > 0 || resume)
+    {
+      checkpoint = new DelphesCheckpoint(argv[2]);
+      resumed = resume && checkpoint->Read();
+    }
+
+    // a resumed job overwrites the output of a job killed before its first checkpoint
+    outputFile = TFile::Open(checkpoint ? checkpoint->GetSegmentFileName().Data() : argv[2], resume ? "RECREATE" : "CREATE");
 
     if(outputFile == NULL)
     {
@@ -109,6 +149,9 @@ int main(int argc, char *argv[])
     confReader = new ExRootConfReader;
     confReader->ReadFile(argv[1]);
 
+    // the module random streams only depend on their key and on the event number
+    if(resumed) confReader->SetParam("::RandomSeed", Form("%d", Int_t(checkpoint->GetRandomSeed())));
+
     maxEvents = confReader->GetInt("::MaxEvents", 0);
     skipEvents = confReader->GetInt("::SkipEvents", 0);
 
@@ -136,12 +179,23 @@ int main(int argc, char *argv[])
     modularDelphes->InitTask();
 
     i = 3;
+    if(resumed)
+    {
+      i = checkpoint->GetInput();
+      modularDelphes->SetEventNumber(checkpoint->GetEventNumber());
+    }
+
+    processedEvents = 0;
     do
     {
       if(interrupted) break;
 
       if(i == argc || strncmp(argv[i], "-", 2) == 0)
       {
+        if(checkpoint)
+        {
+          throw runtime_error("checkpoints can't be used with standard input");
+        }
         cout << "** Reading standard input" << endl;
         inputFile = stdin;
         length = -1;
@@ -173,8 +227,22 @@ int main(int argc, char *argv[])
 
       ExRootProgressBar progressBar(length);
 
-      // Loop over all objects
       eventCounter = 0;
+      if(resumed && i == checkpoint->GetInput())
+      {
+        fseeko(inputFile, checkpoint->GetOffset(), SEEK_SET);
+        eventCounter = checkpoint->GetEventCounter();
+      }
+
+      if(checkpoint)
+      {
+        checkpoint->SetInput(i, ftello(inputFile));
+        checkpoint->SetEventCounter(eventCounter);
+        checkpoint->SetEventNumber(modularDelphes->GetEventNumber());
+        checkpoint->SetRandomSeed(modularDelphes->GetRandomSeed());
+      }
+
+      // Loop over all objects
       treeWriter->Clear();
       modularDelphes->Clear();
       reader->Clear();
@@ -204,6 +272,15 @@ int main(int argc, char *argv[])
           modularDelphes->Clear();
           reader->Clear();
 
+          // the input is positioned at the beginning of the next event
+          if(checkpoint)
+          {
+            checkpoint->SetInput(i, ftello(inputFile));
+            checkpoint->SetEventCounter(eventCounter);
+            checkpoint->SetEventNumber(modularDelphes->GetEventNumber());
+            if(checkpointInterval > 0 && ++processedEvents % checkpointInterval == 0) checkpoint->Save(treeWriter);
+          }
+
           readStopWatch.Start();
         }
         progressBar.Update(ftello(inputFile), eventCounter);
@@ -218,6 +295,9 @@ int main(int argc, char *argv[])
       ++i;
     } while(i < argc);
 
+    // an interrupted job can be resumed from the last complete event
+    if(checkpoint && interrupted) checkpoint->Save(treeWriter);
+
     modularDelphes->FinishTask();
     treeWriter->Write();
 
@@ -229,10 +309,17 @@ int main(int argc, char *argv[])
     delete treeWriter;
     delete outputFile;
 
+    if(checkpoint)
+    {
+      if(!interrupted) checkpoint->Finish();
+      delete checkpoint;
+    }
+
     return 0;
   }
   catch(runtime_error &e)
   {
+    if(checkpoint) delete checkpoint;
     if(treeWriter) delete treeWriter;
     if(outputFile) delete outputFile;
     cerr << "** ERROR: " << e.what() << endl;
@@ -17,17 +17,24 @@
  */
 
 #include <algorithm>
+#include <fstream>
 #include <iostream>
 #include <memory>
 #include <sstream>
 #include <stdexcept>
 
 #include <map>
+#include <string>
 #include <vector>
 
 #include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <sys/mman.h>
+#include <sys/wait.h>
 
 #include "TApplication.h"
 #include "TROOT.h"
@@ -35,11 +42,15 @@
 #include "TClonesArray.h"
 #include "TDatabasePDG.h"
 #include "TFile.h"
+#include "TFileMerger.h"
 #include "TLorentzVector.h"
 #include "TObjArray.h"
 #include "TParticlePDG.h"
+#include "TRandom.h"
 #include "TStopwatch.h"
+#include "TSystem.h"
 
+#include "classes/DelphesCheckpoint.h"
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
 #include "classes/DelphesStream.h"
@@ -54,6 +65,141 @@ using namespace std;
 
 //---------------------------------------------------------------------------
 
+static const Long64_t kChunkSize = 100;
+
+//---------------------------------------------------------------------------
+
+void ConvertEvent(Long64_t eventCounter, const HepMCEvent *eve, ExRootTreeBranch *branch)
+{
+  HepMCEvent *element;
+
+  // -- TBC need also to include event weights --
+
+  element = static_cast<HepMCEvent *>(branch->NewEntry());
+
+  element->Number = eventCounter;
+
+  element->ProcessID = eve->ProcessID;
+  element->MPI = eve->MPI;
+  element->Weight = eve->Weight;
+  element->Scale = eve->Scale;
+  element->AlphaQED = eve->AlphaQED;
+  element->AlphaQCD = eve->AlphaQCD;
+
+  element->ID1 = eve->ID1;
+  element->ID2 = eve->ID2;
+  element->X1 = eve->X1;
+  element->X2 = eve->X2;
+  element->ScalePDF = eve->ScalePDF;
+  element->PDF1 = eve->PDF1;
+  element->PDF2 = eve->PDF2;
+
+  element->ReadTime = eve->ReadTime;
+  element->ProcTime = eve->ProcTime;
+}
+
+//---------------------------------------------------------------------------
+
+void ConvertParticles(TClonesArray *branchParticle, DelphesFactory *factory,
+  TObjArray *allParticleOutputArray, TObjArray *stableParticleOutputArray, TObjArray *partonOutputArray)
+{
+  GenParticle *gen;
+  Candidate *candidate;
+  Int_t pdgCode;
+
+  const Double_t c_light = 2.99792458E8;
+
+  for(Int_t j = 0; j < branchParticle->GetEntriesFast(); j++)
+  {
+
+    gen = (GenParticle *)branchParticle->At(j);
+    candidate = factory->NewCandidate();
+
+    candidate->Momentum = gen->P4();
+    candidate->Position.SetXYZT(gen->X, gen->Y, gen->Z, gen->T * 1.0E3 * c_light);
+
+    candidate->PID = gen->PID;
+    candidate->Status = gen->Status;
+
+    candidate->M1 = gen->M1;
+    candidate->M2 = gen->M2;
+
+    candidate->D1 = gen->D1;
+    candidate->D2 = gen->D2;
+
+    candidate->Charge = gen->Charge;
+    candidate->Mass = gen->Mass;
+
+    allParticleOutputArray->Add(candidate);
+
+    pdgCode = TMath::Abs(gen->PID);
+
+    if(gen->Status == 1)
+    {
+      stableParticleOutputArray->Add(candidate);
+    }
+    else if(pdgCode <= 5 || pdgCode == 21 || pdgCode == 15)
+    {
+      partonOutputArray->Add(candidate);
+    }
+  }
+}
+
+//---------------------------------------------------------------------------
+
+void ConvertInput(Long64_t eventCounter,
+  TClonesArray *branchParticle, TClonesArray *branchHepMCEvent,
+  ExRootTreeBranch *branch, DelphesFactory *factory,
+  TObjArray *allParticleOutputArray, TObjArray *stableParticleOutputArray, TObjArray *partonOutputArray)
+{
+  ConvertEvent(eventCounter, static_cast<HepMCEvent *>(branchHepMCEvent->At(0)), branch);
+
+  ConvertParticles(branchParticle, factory,
+    allParticleOutputArray, stableParticleOutputArray, partonOutputArray);
+}
+
+//---------------------------------------------------------------------------
+
+// Batch mode: the entries are read into the arrays of their own event
+// of the batch, the modules process the whole batch and the tree is
+// then filled event by event.
+
+void ProcessBatch(Long64_t first, Int_t size, Long64_t eventCounter,
+  ExRootTreeReader *treeReader, TClonesArray *branchParticle, TClonesArray *branchHepMCEvent,
+  Delphes *modularDelphes, ExRootTreeWriter *treeWriter, ExRootTreeBranch *branchEvent,
+  TObjArray *allParticleOutputArray, TObjArray *stableParticleOutputArray, TObjArray *partonOutputArray)
+{
+  DelphesFactory *factory = modularDelphes->GetFactory();
+  vector<HepMCEvent> events(size);
+  Int_t i;
+
+  for(i = 0; i < size; ++i)
+  {
+    treeReader->ReadEntry(first + i);
+
+    events[i] = *static_cast<HepMCEvent *>(branchHepMCEvent->At(0));
+
+    modularDelphes->SelectEvent(i);
+    ConvertParticles(branchParticle, factory,
+      allParticleOutputArray, stableParticleOutputArray, partonOutputArray);
+  }
+
+  modularDelphes->SetEventNumber(first);
+  modularDelphes->ProcessBatch(size);
+
+  for(i = 0; i < size; ++i)
+  {
+    modularDelphes->ProcessBatchEvent(i);
+
+    ConvertEvent(eventCounter + i, &events[i], branchEvent);
+
+    treeWriter->Fill();
+    treeWriter->Clear();
+  }
+
+  modularDelphes->Clear();
+}
+
 //---------------------------------------------------------------------------
 
 static bool interrupted = false;
@@ -65,6 +211,437 @@ void SignalHandler(int sig)
 
 //---------------------------------------------------------------------------
 
+// Worker process of the event-parallel mode: all workers share the
+// initialised module graph through fork. The pile-up files are mapped
+// read-only by DelphesPileUpReader, so the workers share no file offset.
+// Each worker processes a contiguous range of entries, so that merging
+// the worker outputs in worker order keeps the order of the input entries.
+
+void ProcessWorker(Int_t worker, Int_t numberOfWorkers, const char *outputFileName,
+  Int_t numberOfInputs, char *inputFileNames[], Long64_t *queue,
+  Delphes *modularDelphes, ExRootTreeWriter *treeWriter, ExRootTreeBranch *branchEvent,
+  TObjArray *allParticleOutputArray, TObjArray *stableParticleOutputArray, TObjArray *partonOutputArray)
+{
+  stringstream message;
+  TFile *workerFile = 0;
+  TChain *chain = 0;
+  ExRootTreeReader *treeReader = 0;
+  DelphesFactory *factory = modularDelphes->GetFactory();
+  Long64_t entry, first, last, begin, end, numberOfEvents;
+  Int_t i, size, batchSize = modularDelphes->GetBatchSize();
+
+  workerFile = TFile::Open(Form("%s.%d", outputFileName, worker), "RECREATE");
+
+  if(workerFile == NULL)
+  {
+    message << "can't create " << outputFileName << "." << worker << endl;
+    throw runtime_error(message.str());
+  }
+
+  treeWriter->SetTreeFile(workerFile);
+
+  chain = new TChain("Delphes");
+  for(i = 0; i < numberOfInputs; ++i)
+  {
+    chain->Add(inputFileNames[i]);
+  }
+
+  treeReader = new ExRootTreeReader(chain);
+
+  numberOfEvents = treeReader->GetEntries();
+  TClonesArray *branchParticle = treeReader->UseBranch("Particle");
+  TClonesArray *branchHepMCEvent = treeReader->UseBranch("Event");
+
+  ExRootProgressBar progressBar(worker == 0 ? numberOfEvents : -1);
+
+  begin = numberOfEvents * worker / numberOfWorkers;
+  end = numberOfEvents * (worker + 1) / numberOfWorkers;
+
+  modularDelphes->Clear();
+  treeWriter->Clear();
+  for(first = begin; first < end && !interrupted; first = last)
+  {
+    last = TMath::Min(first + kChunkSize, end);
+    for(entry = first; entry < last && !interrupted; entry += size)
+    {
+      size = TMath::Min(Long64_t(batchSize), last - entry);
+      if(size > 1)
+      {
+        ProcessBatch(entry, size, entry,
+          treeReader, branchParticle, branchHepMCEvent,
+          modularDelphes, treeWriter, branchEvent,
+          allParticleOutputArray, stableParticleOutputArray, partonOutputArray);
+        continue;
+      }
+
+      treeReader->ReadEntry(entry);
+
+      ConvertInput(entry, branchParticle, branchHepMCEvent,
+        branchEvent, factory,
+        allParticleOutputArray, stableParticleOutputArray, partonOutputArray);
+
+      modularDelphes->SetEventNumber(entry);
+      modularDelphes->ProcessTask();
+
+      treeWriter->Fill();
+
+      modularDelphes->Clear();
+      treeWriter->Clear();
+    }
+
+    __sync_fetch_and_add(&queue[0], entry - first);
+
+    if(worker == 0) progressBar.Update(queue[0], queue[0]);
+  }
+
+  if(worker == 0)
+  {
+    progressBar.Update(numberOfEvents, queue[0], kTRUE);
+    progressBar.Finish();
+  }
+
+  modularDelphes->FinishTask();
+  treeWriter->Write();
+
+  delete treeReader;
+  delete chain;
+
+  workerFile->Close();
+  delete workerFile;
+}
+
+//---------------------------------------------------------------------------
+
+// wait for all the workers, when one of them fails the others are stopped
+// and their output and profile files removed before the error is reported
+
+void WaitWorkers(const vector<pid_t> &workers, const char *outputFileName, const char *profileFileName)
+{
+  stringstream message;
+  Int_t i, size = workers.size(), remaining, status, failed = -1;
+  vector<Bool_t> running(size, kTRUE);
+  pid_t pid;
+
+  for(remaining = size; remaining > 0; --remaining)
+  {
+    pid = waitpid(-1, &status, 0);
+    if(pid < 0) break;
+
+    i = find(workers.begin(), workers.end(), pid) - workers.begin();
+    if(i == size)
+    {
+      ++remaining;
+      continue;
+    }
+
+    running[i] = kFALSE;
+
+    if(failed < 0 && (!WIFEXITED(status) || WEXITSTATUS(status) != 0))
+    {
+      failed = i;
+      for(i = 0; i < size; ++i)
+      {
+        if(running[i]) kill(workers[i], SIGTERM);
+      }
+    }
+  }
+
+  if(failed < 0) return;
+
+  for(i = 0; i < size; ++i)
+  {
+    if(outputFileName) gSystem->Unlink(Form("%s.%d", outputFileName, i));
+    if(profileFileName) gSystem->Unlink(Form("%s.%d", profileFileName, i));
+  }
+
+  message << "worker " << failed << " failed";
+  throw runtime_error(message.str());
+}
+
+//---------------------------------------------------------------------------
+
+// every worker writes its module profile to its own file, the ROOT profiles
+// are merged like the output files and the JSON profiles are gathered
+// in a JSON array, in worker order
+
+void MergeProfiles(const char *profileFileName, Int_t numberOfWorkers)
+{
+  stringstream message;
+  Int_t i;
+
+  if(TString(profileFileName).EndsWith(".root"))
+  {
+    TFileMerger merger(kFALSE);
+    merger.SetPrintLevel(0);
+    merger.OutputFile(profileFileName, "RECREATE");
+    for(i = 0; i < numberOfWorkers; ++i)
+    {
+      merger.AddFile(Form("%s.%d", profileFileName, i), kFALSE);
+    }
+
+    if(!merger.Merge())
+    {
+      throw runtime_error("can't merge worker profiles");
+    }
+  }
+  else
+  {
+    ofstream file(profileFileName);
+    if(!file)
+    {
+      message << "can't open profile file '" << profileFileName << "'";
+      throw runtime_error(message.str());
+    }
+
+    file << "[" << endl;
+    for(i = 0; i < numberOfWorkers; ++i)
+    {
+      ifstream workerFile(Form("%s.%d", profileFileName, i));
+      if(!workerFile)
+      {
+        message << "can't open profile file '" << profileFileName << "." << i << "'";
+        throw runtime_error(message.str());
+      }
+
+      file << workerFile.rdbuf();
+      if(i < numberOfWorkers - 1) file << "," << endl;
+    }
+    file << "]" << endl;
+  }
+
+  for(i = 0; i < numberOfWorkers; ++i)
+  {
+    gSystem->Unlink(Form("%s.%d", profileFileName, i));
+  }
+}
+
+//---------------------------------------------------------------------------
+
+// Shard mode: the module graph is initialised once from the base card
+// and reused for every shard, a shard only sets its own parameters
+// (RandomSeed and the parameters read again by the InitRun of a module,
+// such as PileUpFile) before its run starts.
+
+struct Shard
+{
+  string output;
+  vector<string> inputs;
+  vector<string> parameters;
+};
+
+//---------------------------------------------------------------------------
+
+string GetParameterName(const string &parameter)
+{
+  stringstream message;
+  size_t position = parameter.find('=');
+
+  if(position == string::npos || position == 0)
+  {
+    message << "parameter " << parameter << " is not of the form name=value" << endl;
+    throw runtime_error(message.str());
+  }
+
+  return parameter.substr(0, position);
+}
+
+//---------------------------------------------------------------------------
+
+void SetParameter(ExRootConfReader *confReader, const string &parameter)
+{
+  string name = GetParameterName(parameter);
+  confReader->SetParam(name.c_str(), parameter.substr(name.size() + 1).c_str());
+}
+
+//---------------------------------------------------------------------------
+
+// one shard per line: output file, input file(s) and name=value parameters,
+// text after # is ignored
+
+void ReadShards(const char *fileName, vector<Shard> &shards)
+{
+  stringstream message;
+  string line, token;
+  size_t position;
+  Int_t lineNumber = 0;
+
+  ifstream file(fileName);
+
+  if(!file.is_open())
+  {
+    message << "can't open " << fileName << endl;
+    throw runtime_error(message.str());
+  }
+
+  while(getline(file, line))
+  {
+    ++lineNumber;
+
+    position = line.find('#');
+    if(position != string::npos) line.erase(position);
+
+    istringstream stream(line);
+    Shard shard;
+
+    while(stream >> token)
+    {
+      if(token.find('=') != string::npos)
+        shard.parameters.push_back(token);
+      else if(shard.output.empty())
+        shard.output = token;
+      else
+        shard.inputs.push_back(token);
+    }
+
+    if(shard.output.empty() && shard.parameters.empty()) continue;
+
+    if(shard.inputs.empty())
+    {
+      message << "no input file for shard at line " << lineNumber << " of " << fileName << endl;
+      throw runtime_error(message.str());
+    }
+
+    shards.push_back(shard);
+  }
+
+  if(shards.empty())
+  {
+    message << "no shard in " << fileName << endl;
+    throw runtime_error(message.str());
+  }
+}
+
+//---------------------------------------------------------------------------
+
+// the parameters set by a shard are restored to their values of the base
+// configuration at the end of the shard, whatever shards the process ran before
+
+void ProcessShard(const Shard &shard, ExRootConfReader *confReader,
+  Delphes *modularDelphes, ExRootTreeWriter *treeWriter, ExRootTreeBranch *branchEvent,
+  TObjArray *allParticleOutputArray, TObjArray *stableParticleOutputArray, TObjArray *partonOutputArray)
+{
+  stringstream message;
+  TFile *outputFile = 0;
+  TChain *chain = 0;
+  ExRootTreeReader *treeReader = 0;
+  DelphesFactory *factory = modularDelphes->GetFactory();
+  Long64_t entry, numberOfEvents;
+  Int_t size, batchSize = modularDelphes->GetBatchSize();
+  vector<string>::const_iterator itStrings;
+  vector<pair<string, string> > baseValues;
+  vector<pair<string, string> >::reverse_iterator itBaseValues;
+  vector<bool> baseSet;
+  vector<bool>::reverse_iterator itBaseSet;
+  string name;
+
+  cout << "** Processing shard " << shard.output << endl;
+
+  for(itStrings = shard.parameters.begin(); itStrings != shard.parameters.end(); ++itStrings)
+  {
+    name = GetParameterName(*itStrings);
+    baseSet.push_back(confReader->HasParam(name.c_str()));
+    baseValues.push_back(make_pair(name, string(confReader->GetParam(name.c_str()).GetString())));
+    SetParameter(confReader, *itStrings);
+  }
+
+  modularDelphes->InitRun();
+
+  outputFile = TFile::Open(shard.output.c_str(), "RECREATE");
+
+  if(outputFile == NULL)
+  {
+    message << "can't create " << shard.output << endl;
+    throw runtime_error(message.str());
+  }
+
+  treeWriter->SetTreeFile(outputFile);
+
+  chain = new TChain("Delphes");
+  for(itStrings = shard.inputs.begin(); itStrings != shard.inputs.end(); ++itStrings)
+  {
+    chain->Add(itStrings->c_str());
+  }
+
+  treeReader = new ExRootTreeReader(chain);
+
+  numberOfEvents = treeReader->GetEntries();
+  TClonesArray *branchParticle = treeReader->UseBranch("Particle");
+  TClonesArray *branchHepMCEvent = treeReader->UseBranch("Event");
+
+  modularDelphes->Clear();
+  treeWriter->Clear();
+  for(entry = 0; entry < numberOfEvents && !interrupted; entry += size)
+  {
+    size = TMath::Min(Long64_t(batchSize), numberOfEvents - entry);
+    if(size > 1)
+    {
+      ProcessBatch(entry, size, entry,
+        treeReader, branchParticle, branchHepMCEvent,
+        modularDelphes, treeWriter, branchEvent,
+        allParticleOutputArray, stableParticleOutputArray, partonOutputArray);
+      continue;
+    }
+
+    treeReader->ReadEntry(entry);
+
+    ConvertInput(entry, branchParticle, branchHepMCEvent,
+      branchEvent, factory,
+      allParticleOutputArray, stableParticleOutputArray, partonOutputArray);
+
+    modularDelphes->SetEventNumber(entry);
+    modularDelphes->ProcessTask();
+
+    treeWriter->Fill();
+
+    modularDelphes->Clear();
+    treeWriter->Clear();
+  }
+
+  treeWriter->Write();
+  treeWriter->Close();
+
+  delete treeReader;
+  delete chain;
+
+  outputFile->Close();
+  delete outputFile;
+
+  // in reverse order, for a parameter set twice by the shard
+  itBaseSet = baseSet.rbegin();
+  for(itBaseValues = baseValues.rbegin(); itBaseValues != baseValues.rend(); ++itBaseValues, ++itBaseSet)
+  {
+    if(*itBaseSet)
+      confReader->SetParam(itBaseValues->first.c_str(), itBaseValues->second.c_str());
+    else
+      confReader->UnsetParam(itBaseValues->first.c_str());
+  }
+}
+
+//---------------------------------------------------------------------------
+
+// shards are taken one by one from a counter shared by all the processes
+
+void ProcessShards(const vector<Shard> &shards, Long64_t *queue, ExRootConfReader *confReader,
+  Delphes *modularDelphes, ExRootTreeWriter *treeWriter, ExRootTreeBranch *branchEvent,
+  TObjArray *allParticleOutputArray, TObjArray *stableParticleOutputArray, TObjArray *partonOutputArray)
+{
+  Long64_t shard;
+
+  while(!interrupted)
+  {
+    shard = __sync_fetch_and_add(&queue[0], 1);
+    if(shard >= Long64_t(shards.size())) break;
+
+    ProcessShard(shards[shard], confReader,
+      modularDelphes, treeWriter, branchEvent,
+      allParticleOutputArray, stableParticleOutputArray, partonOutputArray);
+  }
+
+  modularDelphes->FinishTask();
+}
+
+//---------------------------------------------------------------------------
+
 int main(int argc, char *argv[])
 {
   char appName[] = "DelphesROOT";
@@ -77,22 +654,73 @@ int main(int argc, char *argv[])
   ExRootConfReader *confReader = 0;
   Delphes *modularDelphes = 0;
   DelphesFactory *factory = 0;
-  GenParticle *gen;
-  HepMCEvent *element, *eve;
-  Candidate *candidate;
-  Int_t pdgCode;
-
-  const Double_t c_light = 2.99792458E8;
+  DelphesCheckpoint *checkpoint = 0;
 
   TObjArray *allParticleOutputArray = 0, *stableParticleOutputArray = 0, *partonOutputArray = 0;
-  Int_t i;
-  Long64_t eventCounter, numberOfEvents;
+  Int_t i, numberOfWorkers, status, size, checkpointInterval;
+  Long64_t entry, eventCounter, numberOfEvents, processedEvents;
+  Bool_t resume, resumed;
+  Long64_t *queue = 0;
+  vector<pid_t> workers;
+  vector<UInt_t> seeds;
+  vector<string> parameters;
+  vector<Shard> shards;
+  vector<Shard>::const_iterator itShards;
+  vector<string>::const_iterator itStrings;
+  const char *shardFileName = 0;
+  const char *profileFileName = 0;
+  TString profileOutput;
+  pid_t pid;
+
+  numberOfWorkers = 1;
+  checkpointInterval = 0;
+  resume = kFALSE;
+  resumed = kFALSE;
+  while(argc > 2 && argv[1][0] == '-')
+  {
+    if(strcmp(argv[1], "-resume") == 0)
+    {
+      resume = kTRUE;
+      argv += 1;
+      argc -= 1;
+      continue;
+    }
 
-  if(argc < 4)
+    if(strcmp(argv[1], "-j") == 0)
+      numberOfWorkers = atoi(argv[2]);
+    else if(strcmp(argv[1], "-s") == 0)
+      parameters.push_back(argv[2]);
+    else if(strcmp(argv[1], "-shards") == 0)
+      shardFileName = argv[2];
+    else if(strcmp(argv[1], "-checkpoint") == 0)
+      checkpointInterval = atoi(argv[2]);
+    else
+      break;
+
+    argv += 2;
+    argc -= 2;
+  }
+
+  if(argc < (shardFileName ? 2 : 4) || numberOfWorkers < 1 || checkpointInterval < 0
+    || ((checkpointInterval > 0 || resume) && (numberOfWorkers > 1 || shardFileName)))
   {
-    cout << " Usage: " << appName << " config_file"
+    cout << " Usage: " << appName << " [-j N] [-s name=value]..."
+         << " config_file"
+         << " output_file"
+         << " input_file(s)" << endl;
+    cout << "        " << appName << " [-checkpoint N] [-resume] [-s name=value]..."
+         << " config_file"
          << " output_file"
          << " input_file(s)" << endl;
+    cout << "        " << appName << " [-j N] [-s name=value]..."
+         << " -shards shard_file"
+         << " config_file" << endl;
+    cout << " -j N - process events, or shards, in N parallel worker processes," << endl;
+    cout << " -checkpoint N - save the output and the input position every N events," << endl;
+    cout << " -resume - continue from the last checkpoint of a killed job," << endl;
+    cout << " -s name=value - replace the value of a parameter of the configuration file," << endl;
+    cout << " -shards shard_file - file with one shard per line:" << endl;
+    cout << "   output_file input_file(s) [name=value]...," << endl;
     cout << " config_file - configuration file in Tcl format," << endl;
     cout << " output_file - output file in ROOT format," << endl;
     cout << " input_file(s) - input file(s) in ROOT format." << endl;
@@ -100,6 +728,7 @@ int main(int argc, char *argv[])
   }
 
   signal(SIGINT, SignalHandler);
+  if(checkpointInterval > 0) signal(SIGTERM, SignalHandler);
 
   gROOT->SetBatch();
 
@@ -109,14 +738,29 @@ int main(int argc, char *argv[])
 
   try
   {
-    outputFile = TFile::Open(argv[2], "CREATE");
-
-    if(outputFile == NULL)
+    if(shardFileName)
     {
-      message << "can't open " << argv[2] << endl;
-      throw runtime_error(message.str());
+      ReadShards(shardFileName, shards);
+    }
+    else
+    {
+      if(checkpointInterval > 0 || resume)
+      {
+        checkpoint = new DelphesCheckpoint(argv[2]);
+        resumed = resume && checkpoint->Read();
+      }
+
+      // a resumed job overwrites the output of a job killed before its first checkpoint
+      outputFile = TFile::Open(checkpoint ? checkpoint->GetSegmentFileName().Data() : argv[2], resume ? "RECREATE" : "CREATE");
+
+      if(outputFile == NULL)
+      {
+        message << "can't open " << argv[2] << endl;
+        throw runtime_error(message.str());
+      }
     }
 
+    // in shard mode, the output file is set at the start of each shard
     treeWriter = new ExRootTreeWriter(outputFile, "Delphes");
 
     branchEvent = treeWriter->NewBranch("Event", HepMCEvent::Class());
@@ -124,12 +768,18 @@ int main(int argc, char *argv[])
     confReader = new ExRootConfReader;
     confReader->ReadFile(argv[1]);
 
+    for(i = 0; i < Int_t(parameters.size()); ++i)
+    {
+      SetParameter(confReader, parameters[i]);
+    }
+
+    // the module random streams only depend on their key and on the event number
+    if(resumed) confReader->SetParam("::RandomSeed", Form("%d", Int_t(checkpoint->GetRandomSeed())));
+
     modularDelphes = new Delphes("Delphes");
     modularDelphes->SetConfReader(confReader);
     modularDelphes->SetTreeWriter(treeWriter);
 
-    TChain *chain = new TChain("Delphes");
-
     factory = modularDelphes->GetFactory();
     allParticleOutputArray = modularDelphes->ExportArray("allParticles");
     stableParticleOutputArray = modularDelphes->ExportArray("stableParticles");
@@ -137,7 +787,202 @@ int main(int argc, char *argv[])
 
     modularDelphes->InitTask();
 
-    for(i = 3; i < argc && !interrupted; ++i)
+    if(numberOfWorkers > 1 && strlen(modularDelphes->GetProfileOutput()) > 0)
+    {
+      // kept by the parent, the modules are deleted before the merging
+      profileOutput = modularDelphes->GetProfileOutput();
+      profileFileName = profileOutput.Data();
+    }
+
+    if(shardFileName)
+    {
+      // a shard can only change the parameters read again at the start of its run
+      for(itShards = shards.begin(); itShards != shards.end(); ++itShards)
+      {
+        for(itStrings = itShards->parameters.begin(); itStrings != itShards->parameters.end(); ++itStrings)
+        {
+          modularDelphes->CheckRunParameter(GetParameterName(*itStrings).c_str());
+        }
+      }
+
+      // next shard to dispatch, shared by the worker processes
+      queue = static_cast<Long64_t *>(mmap(0, sizeof(Long64_t),
+        PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0));
+
+      if(queue == MAP_FAILED)
+      {
+        throw runtime_error("can't allocate shared shard queue");
+      }
+
+      queue[0] = 0;
+
+      if(numberOfWorkers > 1)
+      {
+        cout << "** Processing " << shards.size() << " shards with " << numberOfWorkers << " workers" << endl;
+
+        fflush(stdout);
+        fflush(stderr);
+
+        for(i = 0; i < numberOfWorkers; ++i)
+        {
+          pid = fork();
+          if(pid < 0)
+          {
+            throw runtime_error("can't create worker process");
+          }
+          else if(pid == 0)
+          {
+            status = 0;
+            try
+            {
+              if(profileFileName) modularDelphes->SetProfileOutput(Form("%s.%d", profileFileName, i));
+              ProcessShards(shards, queue, confReader,
+                modularDelphes, treeWriter, branchEvent,
+                allParticleOutputArray, stableParticleOutputArray, partonOutputArray);
+            }
+            catch(runtime_error &e)
+            {
+              cerr << "** ERROR: worker " << i << ": " << e.what() << endl;
+              status = 1;
+            }
+            fflush(stdout);
+            fflush(stderr);
+            _exit(status);
+          }
+          workers.push_back(pid);
+        }
+
+        WaitWorkers(workers, 0, profileFileName);
+        if(profileFileName) MergeProfiles(profileFileName, numberOfWorkers);
+      }
+      else
+      {
+        ProcessShards(shards, queue, confReader,
+          modularDelphes, treeWriter, branchEvent,
+          allParticleOutputArray, stableParticleOutputArray, partonOutputArray);
+      }
+
+      munmap(queue, sizeof(Long64_t));
+
+      cout << "** Exiting..." << endl;
+
+      delete modularDelphes;
+      delete confReader;
+      delete treeWriter;
+
+      return 0;
+    }
+
+    if(numberOfWorkers > 1)
+    {
+      // number of processed entries
+      queue = static_cast<Long64_t *>(mmap(0, sizeof(Long64_t),
+        PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0));
+
+      if(queue == MAP_FAILED)
+      {
+        throw runtime_error("can't allocate shared event queue");
+      }
+
+      queue[0] = 0;
+
+      // draw independent seeds for the worker copies of gRandom
+      for(i = 0; i < numberOfWorkers; ++i)
+      {
+        seeds.push_back(gRandom->Integer(kMaxUInt - 1) + 1);
+      }
+
+      cout << "** Processing with " << numberOfWorkers << " workers" << endl;
+
+      fflush(stdout);
+      fflush(stderr);
+
+      for(i = 0; i < numberOfWorkers; ++i)
+      {
+        pid = fork();
+        if(pid < 0)
+        {
+          throw runtime_error("can't create worker process");
+        }
+        else if(pid == 0)
+        {
+          status = 0;
+          try
+          {
+            gRandom->SetSeed(seeds[i]);
+            if(profileFileName) modularDelphes->SetProfileOutput(Form("%s.%d", profileFileName, i));
+            ProcessWorker(i, numberOfWorkers, argv[2], argc - 3, argv + 3, queue,
+              modularDelphes, treeWriter, branchEvent,
+              allParticleOutputArray, stableParticleOutputArray, partonOutputArray);
+          }
+          catch(runtime_error &e)
+          {
+            cerr << "** ERROR: worker " << i << ": " << e.what() << endl;
+            status = 1;
+          }
+          fflush(stdout);
+          fflush(stderr);
+          _exit(status);
+        }
+        workers.push_back(pid);
+      }
+
+      WaitWorkers(workers, argv[2], profileFileName);
+
+      munmap(queue, sizeof(Long64_t));
+
+      // the parent tree stays empty, the events are in the worker files
+      delete modularDelphes;
+      delete confReader;
+      delete treeWriter;
+      delete outputFile;
+
+      cout << "** Merging worker outputs into " << argv[2] << endl;
+
+      TFileMerger merger(kFALSE);
+      merger.SetPrintLevel(0);
+      merger.OutputFile(argv[2], "RECREATE");
+      for(i = 0; i < numberOfWorkers; ++i)
+      {
+        merger.AddFile(Form("%s.%d", argv[2], i), kFALSE);
+      }
+
+      if(!merger.Merge())
+      {
+        throw runtime_error("can't merge worker outputs");
+      }
+
+      for(i = 0; i < numberOfWorkers; ++i)
+      {
+        gSystem->Unlink(Form("%s.%d", argv[2], i));
+      }
+
+      if(profileFileName) MergeProfiles(profileFileName, numberOfWorkers);
+
+      cout << "** Exiting..." << endl;
+
+      return 0;
+    }
+
+    TChain *chain = new TChain("Delphes");
+
+    i = 3;
+    if(resumed)
+    {
+      for(; i < checkpoint->GetInput(); ++i)
+      {
+        chain->Add(argv[i]);
+      }
+    }
+
+    if(checkpoint)
+    {
+      checkpoint->SetInput(i, 0);
+      checkpoint->SetRandomSeed(modularDelphes->GetRandomSeed());
+    }
+
+    processedEvents = 0;
+    for(; i < argc && !interrupted; ++i)
     {
       cout << "** Reading " << argv[i] << endl;
 
@@ -162,83 +1007,57 @@ int main(int argc, char *argv[])
       ExRootProgressBar progressBar(-1);
 
       // Loop over all objects
+      entry = 0;
       eventCounter = 0;
+      if(resumed && i == checkpoint->GetInput())
+      {
+        entry = checkpoint->GetOffset();
+        eventCounter = checkpoint->GetEventCounter();
+      }
+
       modularDelphes->Clear();
       treeWriter->Clear();
-      for(Int_t entry = 0; entry < numberOfEvents && !interrupted; ++entry)
+      for(; entry < numberOfEvents && !interrupted; entry += size)
       {
-
-        treeReader->ReadEntry(entry);
-
-        // -- TBC need also to include event weights --
-
-        eve = (HepMCEvent *)branchHepMCEvent->At(0);
-        element = static_cast<HepMCEvent *>(branchEvent->NewEntry());
-
-        element->Number = eventCounter;
-
-        element->ProcessID = eve->ProcessID;
-        element->MPI = eve->MPI;
-        element->Weight = eve->Weight;
-        element->Scale = eve->Scale;
-        element->AlphaQED = eve->AlphaQED;
-        element->AlphaQCD = eve->AlphaQCD;
-
-        element->ID1 = eve->ID1;
-        element->ID2 = eve->ID2;
-        element->X1 = eve->X1;
-        element->X2 = eve->X2;
-        element->ScalePDF = eve->ScalePDF;
-        element->PDF1 = eve->PDF1;
-        element->PDF2 = eve->PDF2;
-
-        element->ReadTime = eve->ReadTime;
-        element->ProcTime = eve->ProcTime;
-
-        for(Int_t j = 0; j < branchParticle->GetEntriesFast(); j++)
+        size = TMath::Min(Long64_t(modularDelphes->GetBatchSize()), numberOfEvents - entry);
+        if(size > 1)
         {
+          ProcessBatch(entry, size, eventCounter,
+            treeReader, branchParticle, branchHepMCEvent,
+            modularDelphes, treeWriter, branchEvent,
+            allParticleOutputArray, stableParticleOutputArray, partonOutputArray);
+        }
+        else
+        {
+          treeReader->ReadEntry(entry);
 
-          gen = (GenParticle *)branchParticle->At(j);
-          candidate = factory->NewCandidate();
-
-          candidate->Momentum = gen->P4();
-          candidate->Position.SetXYZT(gen->X, gen->Y, gen->Z, gen->T * 1.0E3 * c_light);
-
-          candidate->PID = gen->PID;
-          candidate->Status = gen->Status;
-
-          candidate->M1 = gen->M1;
-          candidate->M2 = gen->M2;
+          ConvertInput(eventCounter, branchParticle, branchHepMCEvent,
+            branchEvent, factory,
+            allParticleOutputArray, stableParticleOutputArray, partonOutputArray);
 
-          candidate->D1 = gen->D1;
-          candidate->D2 = gen->D2;
+          modularDelphes->SetEventNumber(entry);
+          modularDelphes->ProcessTask();
 
-          candidate->Charge = gen->Charge;
-          candidate->Mass = gen->Mass;
+          treeWriter->Fill();
 
-          allParticleOutputArray->Add(candidate);
+          modularDelphes->Clear();
+          treeWriter->Clear();
+        }
 
-          pdgCode = TMath::Abs(gen->PID);
+        progressBar.Update(eventCounter, eventCounter);
+        eventCounter += size;
 
-          if(gen->Status == 1)
-          {
-            stableParticleOutputArray->Add(candidate);
-          }
-          else if(pdgCode <= 5 || pdgCode == 21 || pdgCode == 15)
+        if(checkpoint)
+        {
+          checkpoint->SetInput(i, entry + size);
+          checkpoint->SetEventCounter(eventCounter);
+          processedEvents += size;
+          if(checkpointInterval > 0 && processedEvents >= checkpointInterval)
           {
-            partonOutputArray->Add(candidate);
+            checkpoint->Save(treeWriter);
+            processedEvents = 0;
           }
         }
-
-        modularDelphes->ProcessTask();
-
-        treeWriter->Fill();
-
-        modularDelphes->Clear();
-        treeWriter->Clear();
-
-        progressBar.Update(eventCounter, eventCounter);
-        ++eventCounter;
       }
 
       progressBar.Update(eventCounter, eventCounter, kTRUE);
@@ -249,6 +1068,9 @@ int main(int argc, char *argv[])
       delete treeReader;
     }
 
+    // an interrupted job can be resumed from the last processed event
+    if(checkpoint && interrupted) checkpoint->Save(treeWriter);
+
     modularDelphes->FinishTask();
     treeWriter->Write();
 
@@ -260,10 +1082,17 @@ int main(int argc, char *argv[])
     delete outputFile;
     delete chain;
 
+    if(checkpoint)
+    {
+      if(!interrupted) checkpoint->Finish();
+      delete checkpoint;
+    }
+
     return 0;
   }
   catch(runtime_error &e)
   {
+    if(checkpoint) delete checkpoint;
     if(treeWriter) delete treeWriter;
     if(outputFile) delete outputFile;
     cerr << "** ERROR: " << e.what() << endl;